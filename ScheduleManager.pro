@@ -16,15 +16,42 @@ UI_DIR = build/ui
 SOURCES += \
     main.cpp \
     datastructure/TimeSlot.cpp \
+    datastructure/TimeConvert.cpp \
     datastructure/ScheduleEvent.cpp \
     datastructure/Schedule.cpp \
     datastructure/Professor.cpp \
     datastructure/User.cpp \
     modules/DataManager.cpp \
     modules/FileParser.cpp \
+    modules/CsvTokenizer.cpp \
+    modules/TimeParser.cpp \
+    modules/ImportPipeline.cpp \
+    modules/MappedFile.cpp \
+    modules/ICalendar.cpp \
+    modules/ContentHash.cpp \
+    modules/AvailabilityCache.cpp \
+    modules/SearchIndex.cpp \
+    modules/CompressedBitmap.cpp \
+    modules/TagIndex.cpp \
+    modules/EventTimeIndex.cpp \
+    modules/RecordFormat.cpp \
+    modules/UserStore.cpp \
+    modules/EditHistory.cpp \
+    modules/WeekLayout.cpp \
+    modules/WeekLayoutCache.cpp \
+    modules/BusySummary.cpp \
+    modules/ThreadPool.cpp \
+    modules/AvailabilityTask.cpp \
+    modules/AvailableSlotGenerator.cpp \
+    modules/RoomCalendar.cpp \
+    modules/LineTokenizer.cpp \
     modules/SchedulerLogic.cpp \
     ui/MainWindow.cpp \
     ui/ScheduleView.cpp \
+    ui/WeekScheduleModel.cpp \
+    ui/WeekCanvas.cpp \
+    ui/SemesterOverview.cpp \
+    ui/AvailabilityResultModel.cpp \
     ui/AddEventDialog.cpp \
     ui/ImportProfessorDialog.cpp \
     ui/ImportStudentCoursesDialog.cpp \
@@ -33,15 +60,44 @@ SOURCES += \
 # 头文件
 HEADERS += \
     datastructure/TimeSlot.h \
+    datastructure/TimeConvert.h \
     datastructure/ScheduleEvent.h \
     datastructure/Schedule.h \
     datastructure/Professor.h \
     datastructure/User.h \
     modules/DataManager.h \
     modules/FileParser.h \
+    modules/CsvTokenizer.h \
+    modules/TimeParser.h \
+    modules/BoundedQueue.h \
+    modules/ImportPipeline.h \
+    modules/MappedFile.h \
+    modules/ICalendar.h \
+    modules/ContentHash.h \
+    modules/AvailabilityCache.h \
+    modules/SearchIndex.h \
+    modules/CompressedBitmap.h \
+    modules/TagIndex.h \
+    modules/EventTimeIndex.h \
+    modules/RecordFormat.h \
+    modules/UserStore.h \
+    modules/EditHistory.h \
+    modules/ScheduleChange.h \
+    modules/WeekLayout.h \
+    modules/WeekLayoutCache.h \
+    modules/BusySummary.h \
+    modules/ThreadPool.h \
+    modules/AvailabilityTask.h \
+    modules/AvailableSlotGenerator.h \
+    modules/RoomCalendar.h \
+    modules/LineTokenizer.h \
     modules/SchedulerLogic.h \
     ui/MainWindow.h \
     ui/ScheduleView.h \
+    ui/WeekScheduleModel.h \
+    ui/WeekCanvas.h \
+    ui/SemesterOverview.h \
+    ui/AvailabilityResultModel.h \
     ui/AddEventDialog.h \
     ui/ImportProfessorDialog.h \
     ui/ImportStudentCoursesDialog.h \
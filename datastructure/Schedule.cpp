@@ -1,48 +1,105 @@
 #include "Schedule.h"
+#include "TimeConvert.h"
 #include <algorithm>
+#include <atomic>
 #include <ctime>
 
 Schedule::Schedule() {
 }
 
+std::vector<ScheduleEvent>& Schedule::mutableEvents() {
+    if (!events) {
+        events = std::make_shared<std::vector<ScheduleEvent>>();
+    } else if (events.use_count() > 1) {
+        // 仍有快照在读，复制后再改，快照看到的内容保持不变
+        events = std::make_shared<std::vector<ScheduleEvent>>(*events);
+    } else {
+        // use_count 是宽松读取，最后一个快照可能刚在后台线程中释放；
+        // 获取屏障保证那个线程对数据的读取都发生在这里的修改之前
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return *events;
+}
+
 void Schedule::addEvent(const ScheduleEvent& event) {
-    events.push_back(event);
+    mutableEvents().push_back(event);
 }
 
 bool Schedule::addEventSafely(const ScheduleEvent& event, std::string& errorMsg) {
     // 检查重复事件
-    for (const auto& existingEvent : events) {
+    for (const auto& existingEvent : getAllEvents()) {
         // 检查名称、地点、星期和时间是否完全相同
-        if (existingEvent.getEventName() == event.getEventName() && 
-            existingEvent.getLocation() == event.getLocation() &&
-            existingEvent.getTimeSlot().getStartTime() == event.getTimeSlot().getStartTime() &&
-            existingEvent.getTimeSlot().getEndTime() == event.getTimeSlot().getEndTime()) {
+        if (isDuplicate(existingEvent, event)) {
             errorMsg = "事件重复";
             return false;
         }
         
         // 检查时间冲突
-        if (existingEvent.getTimeSlot().isOverlappingWith(event.getTimeSlot())) {
+        if (conflicts(existingEvent, event)) {
             errorMsg = "时间冲突";
             return false;
         }
     }
     
     // 通过检查，添加事件
-    events.push_back(event);
+    mutableEvents().push_back(event);
     return true;
 }
 
+std::vector<int> Schedule::findConflicts(const ScheduleEvent& event, int ignoreId) const {
+    std::vector<int> result;
+    for (const auto& existingEvent : getAllEvents()) {
+        if (existingEvent.getId() != ignoreId && conflicts(existingEvent, event)) {
+            result.push_back(existingEvent.getId());
+        }
+    }
+    return result;
+}
+
+bool Schedule::isDuplicate(const ScheduleEvent& existing, const ScheduleEvent& event) {
+    return existing.getEventName() == event.getEventName() &&
+           existing.getLocation() == event.getLocation() &&
+           existing.getTimeSlot().getStartTime() == event.getTimeSlot().getStartTime() &&
+           existing.getTimeSlot().getEndTime() == event.getTimeSlot().getEndTime();
+}
+
+bool Schedule::conflicts(const ScheduleEvent& existing, const ScheduleEvent& event) {
+    return isDuplicate(existing, event) || existing.getTimeSlot().isOverlappingWith(event.getTimeSlot());
+}
+
 bool Schedule::removeEvent(int eventId) {
-    auto it = std::find_if(events.begin(), events.end(),
-                          [eventId](const ScheduleEvent& e) {
-                              return e.getId() == eventId;
-                          });
-    if (it != events.end()) {
-        events.erase(it);
-        return true;
+    // 先在只读视图上查找，找不到时不必触发复制
+    const auto& current = getAllEvents();
+    auto found = std::find_if(current.begin(), current.end(),
+                              [eventId](const ScheduleEvent& e) {
+                                  return e.getId() == eventId;
+                              });
+    if (found == current.end()) {
+        return false;
     }
-    return false;
+    auto index = found - current.begin();
+    auto& owned = mutableEvents();
+    owned.erase(owned.begin() + index);
+    return true;
+}
+
+std::size_t Schedule::removeEvents(std::vector<int> eventIds) {
+    if (eventIds.empty() || getAllEvents().empty()) {
+        return 0;
+    }
+    std::sort(eventIds.begin(), eventIds.end());
+    auto matches = [&eventIds](const ScheduleEvent& e) {
+        return std::binary_search(eventIds.begin(), eventIds.end(), e.getId());
+    };
+    if (std::none_of(getAllEvents().begin(), getAllEvents().end(), matches)) {
+        return 0;
+    }
+
+    auto& owned = mutableEvents();
+    auto newEnd = std::remove_if(owned.begin(), owned.end(), matches);
+    std::size_t removed = static_cast<std::size_t>(owned.end() - newEnd);
+    owned.erase(newEnd, owned.end());
+    return removed;
 }
 
 std::vector<ScheduleEvent> Schedule::getEventsForDate(
@@ -51,19 +108,15 @@ std::vector<ScheduleEvent> Schedule::getEventsForDate(
     std::vector<ScheduleEvent> result;
     auto dateTime = std::chrono::system_clock::to_time_t(date);
     std::tm dateTm{};
-    if (auto p = std::localtime(&dateTime)) {
-        dateTm = *p;
-    } else if (auto pg = std::gmtime(&dateTime)) {
-        dateTm = *pg;
+    if (!toLocalTm(dateTime, dateTm)) {
+        toUtcTm(dateTime, dateTm);
     }
     
-    for (const auto& event : events) {
+    for (const auto& event : getAllEvents()) {
         auto eventTime = std::chrono::system_clock::to_time_t(event.getTimeSlot().getStartTime());
         std::tm eventTm{};
-        if (auto p2 = std::localtime(&eventTime)) {
-            eventTm = *p2;
-        } else if (auto p2g = std::gmtime(&eventTime)) {
-            eventTm = *p2g;
+        if (!toLocalTm(eventTime, eventTm)) {
+            toUtcTm(eventTime, eventTm);
         }
         
         if (dateTm.tm_year == eventTm.tm_year &&
@@ -87,7 +140,8 @@ static std::chrono::system_clock::time_point roundSecondsToZero(const std::chron
 static std::chrono::system_clock::time_point getMondayMidnight(int weekOffset) {
     auto now = std::chrono::system_clock::now();
     std::time_t nowTt = std::chrono::system_clock::to_time_t(now);
-    std::tm nowTm = *std::localtime(&nowTt);
+    std::tm nowTm{};
+    toLocalTm(nowTt, nowTm);
     nowTm.tm_hour = 0;
     nowTm.tm_min = 0;
     nowTm.tm_sec = 0;
@@ -107,10 +161,8 @@ static TimeSlot normalizeEventToWeek(const ScheduleEvent& event,
 
     std::time_t startTt = std::chrono::system_clock::to_time_t(event.getTimeSlot().getStartTime());
     std::tm startTm{};
-    if (auto ptr = std::localtime(&startTt)) {
-        startTm = *ptr;
-    } else if (auto gptr = std::gmtime(&startTt)) {
-        startTm = *gptr;
+    if (!toLocalTm(startTt, startTm)) {
+        toUtcTm(startTt, startTm);
     }
 
     auto normalizedStart = dayMidnight + std::chrono::hours(startTm.tm_hour) + std::chrono::minutes(startTm.tm_min);
@@ -127,7 +179,7 @@ static TimeSlot normalizeEventToWeek(const ScheduleEvent& event,
 const std::vector<ScheduleEvent>& Schedule::getEventsForWeek(int weekOffset) const {
     // 简化实现：直接返回所有事件
     // 实际应用中应该根据weekOffset计算对应周的起止时间
-    return events;
+    return getAllEvents();
 }
 
 std::vector<ScheduleEvent> Schedule::getEventsInRange(
@@ -136,7 +188,7 @@ std::vector<ScheduleEvent> Schedule::getEventsInRange(
     
     std::vector<ScheduleEvent> result;
     
-    for (const auto& event : events) {
+    for (const auto& event : getAllEvents()) {
         auto eventStart = event.getTimeSlot().getStartTime();
         auto eventEnd = event.getTimeSlot().getEndTime();
         
@@ -150,27 +202,50 @@ std::vector<ScheduleEvent> Schedule::getEventsInRange(
 }
 
 Schedule Schedule::operator+(const Schedule& another) const {
+    // 一方为空时直接共享另一方的事件表
+    if (another.getAllEvents().empty()) {
+        return *this;
+    }
+    if (getAllEvents().empty()) {
+        return another;
+    }
     Schedule result;
-    result.events = this->events;
-    result.events.insert(result.events.end(),
-                        another.events.begin(),
-                        another.events.end());
+    auto& merged = result.mutableEvents();
+    merged.reserve(getAllEvents().size() + another.getAllEvents().size());
+    merged.insert(merged.end(), getAllEvents().begin(), getAllEvents().end());
+    merged.insert(merged.end(),
+                  another.getAllEvents().begin(),
+                  another.getAllEvents().end());
     return result;
 }
 
 const std::vector<ScheduleEvent>& Schedule::getAllEvents() const {
-    return events;
+    static const std::vector<ScheduleEvent> empty;
+    return events ? *events : empty;
 }
 
 void Schedule::clear() {
-    events.clear();
+    if (events && events.use_count() == 1) {
+        std::atomic_thread_fence(std::memory_order_acquire);    // 同 mutableEvents
+        events->clear();
+    } else {
+        events.reset();
+    }
+}
+
+std::shared_ptr<const Schedule> Schedule::snapshot() const {
+    return std::make_shared<const Schedule>(*this);
+}
+
+bool Schedule::isShared() const {
+    return events && events.use_count() > 1;
 }
 
 std::vector<ScheduleEvent> Schedule::getEventsForWeekCopy(int weekOffset) const {
     std::vector<ScheduleEvent> result;
     auto mondayMidnight = getMondayMidnight(weekOffset);
 
-    for (const auto& event : events) {
+    for (const auto& event : getAllEvents()) {
         if (event.getTimeSlot().getIsCourse()) {
             // 课程事件：按目标周归一化（每周重复），实现“课程全加”
             TimeSlot normSlot = normalizeEventToWeek(event, weekOffset, mondayMidnight);
@@ -4,11 +4,19 @@
 #include "ScheduleEvent.h"
 #include <vector>
 #include <chrono>
+#include <memory>
 #include <string>
 
+// 事件表写时复制：拷贝 Schedule 只增加引用计数，与原对象共享同一份事件表，
+// 任何一方修改前若发现仍被共享，才复制出自己的一份
+// 因此快照是 O(1) 的，可以交给后台线程只读使用，GUI 线程照常修改互不影响
+// 注意：快照须在写线程上获取，读线程只能读自己持有的快照
 class Schedule {
 private:
-    std::vector<ScheduleEvent> events;
+    std::shared_ptr<std::vector<ScheduleEvent>> events;   // 空指针视为空表
+
+    // 写前分离：被共享时先复制一份
+    std::vector<ScheduleEvent>& mutableEvents();
 
 public:
     Schedule();
@@ -18,10 +26,20 @@ public:
     
     // 安全添加事件（检查冲突和重复）
     bool addEventSafely(const ScheduleEvent& event, std::string& errorMsg);
+
+    // 与 event 冲突或重复、会让 addEventSafely 拒绝的事件编号（跳过编号为 ignoreId 的事件）
+    std::vector<int> findConflicts(const ScheduleEvent& event, int ignoreId) const;
+
+    // addEventSafely 的判断：名称、地点和起止时间完全相同为重复，时间区间相交为冲突
+    static bool isDuplicate(const ScheduleEvent& existing, const ScheduleEvent& event);
+    static bool conflicts(const ScheduleEvent& existing, const ScheduleEvent& event);
     
     // 根据事件编号删除事件
     bool removeEvent(int eventId);
     
+    // 批量删除，一次遍历完成，返回实际删除的个数
+    std::size_t removeEvents(std::vector<int> eventIds);
+    
     // 获取某一天的事件列表
     std::vector<ScheduleEvent> getEventsForDate(const std::chrono::system_clock::time_point& date) const;
     
@@ -42,6 +60,12 @@ public:
     // 清空所有事件
     void clear();
 
+    // 取不可变快照（O(1)，与当前日程共享数据直到某一方被修改）
+    std::shared_ptr<const Schedule> snapshot() const;
+
+    // 事件表是否与其他 Schedule 或快照共享
+    bool isShared() const;
+
     //返回指定周的事件副本（课程按周归一化，个人日程仅该周）  
     //因为老师的office hour在导入时iscourse都为true 所以会直接将所有的officetime都归一化到这一周
     std::vector<ScheduleEvent> getEventsForWeekCopy(int weekOffset) const;
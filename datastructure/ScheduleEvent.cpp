@@ -1,19 +1,25 @@
 #include "ScheduleEvent.h"
+#include "TimeConvert.h"
 #include <ctime>
 #include <chrono>
 #include <QDate>
 
-
+const char* eventTagName(int bit) {
+    static const char* const names[EVENT_TAG_COUNT] = {
+        "期中", "期末", "复习", "补课", "展示"
+    };
+    return (bit >= 0 && bit < EVENT_TAG_COUNT) ? names[bit] : "";
+}
 
 ScheduleEvent::ScheduleEvent()
-    : id(0), weekday(MONDAY) {
+    : id(0), weekday(MONDAY), tags(0) {
 }
 
 ScheduleEvent::ScheduleEvent(int eventId, const std::string& name,
                              const std::string& loc, const std::string& desc,
                              int day, const TimeSlot& slot)
     : id(eventId), eventName(name), location(loc),
-      description(desc), weekday(day), timeSlot(slot) {
+      description(desc), weekday(day), timeSlot(slot), tags(0) {
 }
 
 int ScheduleEvent::getId() const {
@@ -40,6 +46,14 @@ TimeSlot ScheduleEvent::getTimeSlot() const {
     return timeSlot;
 }
 
+unsigned int ScheduleEvent::getTags() const {
+    return tags;
+}
+
+bool ScheduleEvent::hasTag(EventTag tag) const {
+    return (tags & tag) != 0;
+}
+
 void ScheduleEvent::setId(int eventId) {
     id = eventId;
 }
@@ -64,17 +78,19 @@ void ScheduleEvent::setTimeSlot(const TimeSlot& slot) {
     timeSlot = slot;
 }
 
+void ScheduleEvent::setTags(unsigned int tagMask) {
+    tags = tagMask;
+}
+
 // 辅助函数实现
 int ScheduleEvent::getWeekOffset() const {
     // 获取事件的时间点
     auto eventTime = timeSlot.getStartTime();
     std::time_t eventTt = std::chrono::system_clock::to_time_t(eventTime);
-    // 安全地复制 localtime 结果，避免静态缓冲区被覆盖
+    // 使用线程安全的版本，不共享静态缓冲区
     std::tm eventTm{};
-    if (auto p = std::localtime(&eventTt)) {
-        eventTm = *p;
-    } else if (auto pg = std::gmtime(&eventTt)) { // 罕见情况下的回退
-        eventTm = *pg;
+    if (!toLocalTm(eventTt, eventTm)) { // 罕见情况下的回退
+        toUtcTm(eventTt, eventTm);
     }
     
     // 转换为日期对象以便计算
@@ -88,10 +104,8 @@ int ScheduleEvent::getWeekOffset() const {
     auto now = std::chrono::system_clock::now();
     std::time_t nowTt = std::chrono::system_clock::to_time_t(now);
     std::tm nowTm{};
-    if (auto p2 = std::localtime(&nowTt)) {
-        nowTm = *p2;
-    } else if (auto p2g = std::gmtime(&nowTt)) { // 罕见情况下的回退
-        nowTm = *p2g;
+    if (!toLocalTm(nowTt, nowTm)) { // 罕见情况下的回退
+        toUtcTm(nowTt, nowTm);
     }
     QDate nowDate(nowTm.tm_year + 1900, nowTm.tm_mon + 1, nowTm.tm_mday);
     
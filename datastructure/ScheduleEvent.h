@@ -14,6 +14,20 @@ enum Weekday {
     SUNDAY = 7     // 周日
 };
 
+// 事件标签，可以组合（按位或）
+enum EventTag {
+    TAG_MIDTERM = 1 << 0,       // 期中考试
+    TAG_FINAL = 1 << 1,         // 期末考试
+    TAG_REVIEW = 1 << 2,        // 复习
+    TAG_MAKEUP = 1 << 3,        // 补课
+    TAG_PRESENTATION = 1 << 4   // 展示/答辩
+};
+
+const int EVENT_TAG_COUNT = 5;
+
+// 标签的中文名称，bit 为标签序号（0 ~ EVENT_TAG_COUNT-1）
+const char* eventTagName(int bit);
+
 class ScheduleEvent {
 private:
     int id;
@@ -22,6 +36,7 @@ private:
     std::string description;
     int weekday;
     TimeSlot timeSlot;
+    unsigned int tags;
 
 public:
     ScheduleEvent();
@@ -35,6 +50,8 @@ public:
     std::string getDescription() const;
     int getWeekday() const;
     TimeSlot getTimeSlot() const;
+    unsigned int getTags() const;
+    bool hasTag(EventTag tag) const;
 
     // Setters
     void setId(int eventId);
@@ -43,6 +60,7 @@ public:
     void setDescription(const std::string& desc);
     void setWeekday(int day);
     void setTimeSlot(const TimeSlot& slot);
+    void setTags(unsigned int tagMask);
     
     // 辅助函数
     int getWeekOffset() const;  // 当月周序，从0开始
@@ -0,0 +1,61 @@
+#include "TimeConvert.h"
+
+namespace {
+
+const long long SECONDS_PER_DAY = 24 * 60 * 60;
+
+// 公历日期换算成 1970-01-01 起的天数
+long long daysFromCivil(int year, int month, int day) {
+    year -= month <= 2 ? 1 : 0;
+    const long long era = (year >= 0 ? year : year - 399) / 400;
+    const long long yoe = year - era * 400;
+    const long long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+} // namespace
+
+bool toLocalTm(std::time_t t, std::tm& out) {
+#ifdef _WIN32
+    return localtime_s(&out, &t) == 0;
+#else
+    return localtime_r(&t, &out) != nullptr;
+#endif
+}
+
+bool toUtcTm(std::time_t t, std::tm& out) {
+#ifdef _WIN32
+    return gmtime_s(&out, &t) == 0;
+#else
+    return gmtime_r(&t, &out) != nullptr;
+#endif
+}
+
+bool toLocalWallSeconds(std::time_t t, long long& out) {
+    std::tm tm = {};
+    if (!toLocalTm(t, tm)) {
+        return false;
+    }
+    out = daysFromCivil(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday) * SECONDS_PER_DAY +
+          tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec;
+    return true;
+}
+
+std::time_t fromLocalWallSeconds(long long wall) {
+    long long days = wall / SECONDS_PER_DAY;
+    long long rest = wall % SECONDS_PER_DAY;
+    if (rest < 0) {
+        rest += SECONDS_PER_DAY;
+        --days;
+    }
+    // 超出范围的 tm_mday 由 mktime 规范化
+    std::tm tm = {};
+    tm.tm_year = 70;
+    tm.tm_mday = static_cast<int>(1 + days);
+    tm.tm_hour = static_cast<int>(rest / 3600);
+    tm.tm_min = static_cast<int>(rest / 60 % 60);
+    tm.tm_sec = static_cast<int>(rest % 60);
+    tm.tm_isdst = -1;
+    return std::mktime(&tm);
+}
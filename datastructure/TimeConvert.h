@@ -0,0 +1,17 @@
+#ifndef TIMECONVERT_H
+#define TIMECONVERT_H
+
+#include <ctime>
+
+// 线程安全的 localtime / gmtime（可用时间计算、周布局和导入都在后台线程中调用）
+// 转换失败时返回 false，out 的内容不确定
+bool toLocalTm(std::time_t t, std::tm& out);
+bool toUtcTm(std::time_t t, std::tm& out);
+
+// 本地墙上时间：按本机时区的日期和时刻计的 1970-01-01 起秒数，不随夏令时跳变
+// 每周重复的事件按它计算周内相位，跨夏令时仍落在同一星期和时刻
+bool toLocalWallSeconds(std::time_t t, long long& out);
+// 反向换算；夏令时跳过的时刻按 mktime 的规则顺延
+std::time_t fromLocalWallSeconds(long long wall);
+
+#endif // TIMECONVERT_H
@@ -37,3 +37,6 @@ void User::setName(const std::string& userName) {
     name = userName;
 }
 
+std::shared_ptr<const User> User::snapshot() const {
+    return std::make_shared<const User>(*this);
+}
@@ -2,6 +2,7 @@
 #define USER_H
 
 #include "Schedule.h"
+#include <memory>
 #include <string>
 
 class User {
@@ -24,6 +25,10 @@ public:
     
     // Setters
     void setName(const std::string& userName);
+
+    // 取不可变快照：两个日程都与当前用户共享事件表，O(1)
+    // 后台计算、保存等只读任务持有快照即可，不受之后的修改影响
+    std::shared_ptr<const User> snapshot() const;
 };
 
 #endif // USER_H
@@ -0,0 +1,33 @@
+#include "AvailabilityCache.h"
+#include <limits>
+
+bool AvailabilityCache::lookup(std::size_t professor, std::time_t weekStart, std::uint64_t professorRevision,
+                               std::uint64_t studentHash, std::vector<TimeSlot>& slots) const {
+    auto it = entries.find(std::make_pair(professor, weekStart));
+    if (it == entries.end() ||
+        it->second.professorRevision != professorRevision ||
+        it->second.studentHash != studentHash) {
+        return false;
+    }
+    slots = it->second.slots;
+    return true;
+}
+
+void AvailabilityCache::store(std::size_t professor, std::time_t weekStart, std::uint64_t professorRevision,
+                              std::uint64_t studentHash, const std::vector<TimeSlot>& slots) {
+    Entry& entry = entries[std::make_pair(professor, weekStart)];
+    entry.professorRevision = professorRevision;
+    entry.studentHash = studentHash;
+    entry.slots = slots;
+}
+
+void AvailabilityCache::invalidateProfessor(std::size_t professor) {
+    // 键按教师句柄排序，同一教师的条目是连续的一段
+    auto first = entries.lower_bound(std::make_pair(professor, std::numeric_limits<std::time_t>::min()));
+    auto last = entries.upper_bound(std::make_pair(professor, std::numeric_limits<std::time_t>::max()));
+    entries.erase(first, last);
+}
+
+void AvailabilityCache::clear() {
+    entries.clear();
+}
@@ -0,0 +1,37 @@
+#ifndef AVAILABILITYCACHE_H
+#define AVAILABILITYCACHE_H
+
+#include "../datastructure/TimeSlot.h"
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <utility>
+#include <vector>
+
+// 可用时间计算结果缓存，按（教师句柄, 该周周一零点）存放
+// 周偏移相对于当前日期，跨周后会指向另一周，因此键使用绝对日期
+// 条目记录计算时的教师修订号和学生日程哈希，任一不同即视为过期；
+// 重新导入时只有内容变化的教师修订号会变，其余教师的结果继续命中
+class AvailabilityCache {
+private:
+    struct Entry {
+        std::uint64_t professorRevision;
+        std::uint64_t studentHash;
+        std::vector<TimeSlot> slots;
+    };
+
+    std::map<std::pair<std::size_t, std::time_t>, Entry> entries;
+
+public:
+    bool lookup(std::size_t professor, std::time_t weekStart, std::uint64_t professorRevision,
+                std::uint64_t studentHash, std::vector<TimeSlot>& slots) const;
+    void store(std::size_t professor, std::time_t weekStart, std::uint64_t professorRevision,
+               std::uint64_t studentHash, const std::vector<TimeSlot>& slots);
+
+    // 丢弃某位教师的所有条目
+    void invalidateProfessor(std::size_t professor);
+    void clear();
+};
+
+#endif // AVAILABILITYCACHE_H
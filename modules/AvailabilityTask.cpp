@@ -0,0 +1,83 @@
+#include "AvailabilityTask.h"
+#include "SchedulerLogic.h"
+#include <utility>
+
+AvailabilityTask::AvailabilityTask(ThreadPool& threadPool, Schedule student, std::vector<Query> allQueries)
+    : pool(threadPool),
+      studentSchedule(std::move(student)),
+      queries(std::move(allQueries)),
+      completed(0),
+      cancelled(false) {
+    future = promise.get_future();
+    results.resize(queries.size());
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        const Query& query = queries[i];
+        results[i] = AvailabilityResult{query.professor, query.professorName, query.professorEmail,
+                                        query.professorRevision, query.weekOffset, {}, false};
+    }
+}
+
+AvailabilityTask::~AvailabilityTask() {
+    // 任务引用了本对象的成员，必须等它们全部结束
+    cancel();
+    for (auto& job : jobs) {
+        job.wait();
+    }
+}
+
+void AvailabilityTask::start() {
+    if (queries.empty()) {
+        promise.set_value(std::move(results));
+        return;
+    }
+    jobs.reserve(queries.size());
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        jobs.push_back(pool.submit([this, i]() { run(i); }));
+    }
+}
+
+void AvailabilityTask::run(std::size_t index) {
+    if (!cancelled.load()) {
+        const Query& query = queries[index];
+        results[index].slots = SchedulerLogic::findAvailableSlots(studentSchedule, query.officeHours,
+                                                                  query.weekOffset);
+        results[index].complete = true;
+    }
+
+    // 最后一个结束的任务交付结果；fetch_add 的顺序保证其他任务的写入对它可见
+    if (completed.fetch_add(1) + 1 == queries.size()) {
+        promise.set_value(std::move(results));
+    }
+}
+
+void AvailabilityTask::cancel() {
+    cancelled.store(true);
+}
+
+bool AvailabilityTask::isCancelled() const {
+    return cancelled.load();
+}
+
+std::size_t AvailabilityTask::getCompletedCount() const {
+    return completed.load();
+}
+
+std::size_t AvailabilityTask::getTotalCount() const {
+    return queries.size();
+}
+
+int AvailabilityTask::getProgressPercent() const {
+    if (queries.empty()) {
+        return 100;
+    }
+    return static_cast<int>(completed.load() * 100 / queries.size());
+}
+
+bool AvailabilityTask::isFinished() const {
+    return future.valid() &&
+           future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+std::future<std::vector<AvailabilityResult>>& AvailabilityTask::getFuture() {
+    return future;
+}
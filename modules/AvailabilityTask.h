@@ -0,0 +1,74 @@
+#ifndef AVAILABILITYTASK_H
+#define AVAILABILITYTASK_H
+
+#include "ThreadPool.h"
+#include "../datastructure/Schedule.h"
+#include "../datastructure/TimeSlot.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <vector>
+
+// 一位教师在某一周与学生的共同空闲时间
+struct AvailabilityResult {
+    std::size_t professor;          // DataManager 中的教师句柄
+    std::string professorName;
+    std::string professorEmail;
+    std::uint64_t professorRevision;
+    int weekOffset;
+    std::vector<TimeSlot> slots;
+    bool complete;                  // 因取消而未计算时为 false
+};
+
+// 在线程池上异步计算多位教师、多周的可用时间
+// 每个（教师, 周）是一个独立任务，全部结束后 getFuture() 就绪，结果按查询顺序排列；
+// 日程都是写时复制的快照，界面线程可以在计算期间继续修改数据
+class AvailabilityTask {
+public:
+    struct Query {
+        std::size_t professor;
+        std::string professorName;
+        std::string professorEmail;
+        std::uint64_t professorRevision;
+        Schedule officeHours;       // 拷贝只共享数据，O(1)
+        int weekOffset;
+    };
+
+    AvailabilityTask(ThreadPool& pool, Schedule studentSchedule, std::vector<Query> queries);
+    ~AvailabilityTask();
+
+    AvailabilityTask(const AvailabilityTask&) = delete;
+    AvailabilityTask& operator=(const AvailabilityTask&) = delete;
+
+    // 把全部查询提交到线程池
+    void start();
+
+    // 请求取消：尚未开始的查询直接跳过，future 仍会就绪并带回已完成的部分
+    void cancel();
+    bool isCancelled() const;
+
+    std::size_t getCompletedCount() const;
+    std::size_t getTotalCount() const;
+    int getProgressPercent() const;
+    bool isFinished() const;
+
+    // 全部查询结束后就绪，只能取一次结果
+    std::future<std::vector<AvailabilityResult>>& getFuture();
+
+private:
+    ThreadPool& pool;
+    Schedule studentSchedule;
+    std::vector<Query> queries;
+    std::vector<AvailabilityResult> results;    // 每个查询只由自己的任务写入
+    std::atomic<std::size_t> completed;
+    std::atomic<bool> cancelled;
+    std::promise<std::vector<AvailabilityResult>> promise;
+    std::future<std::vector<AvailabilityResult>> future;
+    std::vector<std::future<void>> jobs;
+
+    void run(std::size_t index);
+};
+
+#endif // AVAILABILITYTASK_H
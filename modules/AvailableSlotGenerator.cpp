@@ -0,0 +1,95 @@
+#include "AvailableSlotGenerator.h"
+#include "SchedulerLogic.h"
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+AvailableSlotGenerator::AvailableSlotGenerator(Schedule student, std::vector<Schedule> offices,
+                                               int firstWeek, int weekCount, int minDuration)
+    : studentSchedule(std::move(student)),
+      officeHours(std::move(offices)),
+      endWeek(firstWeek + std::max(0, weekCount)),
+      minDurationMinutes(minDuration),
+      pending(officeHours.size()),
+      computedCount(0) {
+    heap.reserve(officeHours.size());
+    for (std::size_t i = 0; i < officeHours.size(); ++i) {
+        // 没有办公时间的教师不会产出任何结果
+        if (!officeHours[i].getAllEvents().empty()) {
+            pushWeek(i, firstWeek);
+        }
+    }
+}
+
+void AvailableSlotGenerator::push(const Cursor& cursor) {
+    heap.push_back(cursor);
+    std::push_heap(heap.begin(), heap.end(), CursorAfter());
+}
+
+void AvailableSlotGenerator::pushWeek(std::size_t source, int week) {
+    if (week >= endWeek) {
+        return;
+    }
+    auto monday = builder.timeAt(week, 0, 0);
+    push(Cursor{std::chrono::system_clock::to_time_t(monday), source, week, 0, false});
+}
+
+const std::vector<ScheduleEvent>& AvailableSlotGenerator::studentWeek(int week) {
+    // 周按先后顺序计算，更早的周不会再用到
+    studentWeeks.erase(studentWeeks.begin(), studentWeeks.lower_bound(week));
+    auto found = studentWeeks.find(week);
+    if (found == studentWeeks.end()) {
+        found = studentWeeks.emplace(week, studentSchedule.getEventsForWeekCopy(week)).first;
+    }
+    return found->second;
+}
+
+bool AvailableSlotGenerator::next(AvailableSlot& out) {
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), CursorAfter());
+        Cursor cursor = heap.back();
+        heap.pop_back();
+
+        std::vector<TimeSlot>& slots = pending[cursor.source];
+        if (!cursor.computed) {
+            // 轮到这一周时才计算
+            slots = SchedulerLogic::subtractBusy(studentWeek(cursor.week),
+                                                 officeHours[cursor.source].getEventsForWeekCopy(cursor.week),
+                                                 minDurationMinutes);
+            computedCount++;
+            std::sort(slots.begin(), slots.end(), [](const TimeSlot& a, const TimeSlot& b) {
+                return a.getStartTime() < b.getStartTime();
+            });
+            if (slots.empty()) {
+                pushWeek(cursor.source, cursor.week + 1);
+            } else {
+                push(Cursor{std::chrono::system_clock::to_time_t(slots.front().getStartTime()),
+                            cursor.source, cursor.week, 0, true});
+            }
+            continue;
+        }
+
+        out = AvailableSlot{cursor.source, cursor.week, slots[cursor.index]};
+        if (cursor.index + 1 < slots.size()) {
+            push(Cursor{std::chrono::system_clock::to_time_t(slots[cursor.index + 1].getStartTime()),
+                        cursor.source, cursor.week, cursor.index + 1, true});
+        } else {
+            pushWeek(cursor.source, cursor.week + 1);
+        }
+        return true;
+    }
+    return false;
+}
+
+std::vector<AvailableSlot> AvailableSlotGenerator::take(std::size_t count) {
+    std::vector<AvailableSlot> result;
+    AvailableSlot slot;
+    while (result.size() < count && next(slot)) {
+        result.push_back(slot);
+    }
+    return result;
+}
+
+std::size_t AvailableSlotGenerator::getComputedCount() const {
+    return computedCount;
+}
@@ -0,0 +1,70 @@
+#ifndef AVAILABLESLOTGENERATOR_H
+#define AVAILABLESLOTGENERATOR_H
+
+#include "SchedulerLogic.h"
+#include "WeekLayout.h"
+#include "../datastructure/Schedule.h"
+#include "../datastructure/TimeSlot.h"
+#include <cstddef>
+#include <ctime>
+#include <map>
+#include <vector>
+
+// 生成器产出的一个空闲时间段
+struct AvailableSlot {
+    std::size_t source;     // 对应构造时 officeHours 中的下标
+    int weekOffset;
+    TimeSlot slot;
+};
+
+// 按时间先后逐个产出学生与多位教师的共同空闲时间，跨周、跨教师归并
+// 每个（教师, 周）只在堆顶需要它时才计算：未计算的周以该周周一零点作为排序键放在堆中，
+// 因此只取前几个结果时，后面的周根本不会被计算
+// 学生日程按周缓存，多位教师共用；日程为写时复制的拷贝，可在后台线程中使用
+class AvailableSlotGenerator {
+public:
+    // 计算 [firstWeek, firstWeek + weekCount) 周，只产出不短于 minDurationMinutes 的时间段
+    AvailableSlotGenerator(Schedule studentSchedule, std::vector<Schedule> officeHours,
+                           int firstWeek, int weekCount,
+                           int minDurationMinutes = SchedulerLogic::DEFAULT_MIN_DURATION_MINUTES);
+
+    // 取下一个时间段，全部产出后返回 false
+    bool next(AvailableSlot& out);
+
+    // 最多再取 count 个
+    std::vector<AvailableSlot> take(std::size_t count);
+
+    // 已计算的（教师, 周）组合数
+    std::size_t getComputedCount() const;
+
+private:
+    struct Cursor {
+        std::time_t key;        // 未计算时为该周周一零点，否则为下一个时间段的开始时间
+        std::size_t source;
+        int week;
+        std::size_t index;      // 在 pending[source] 中的位置
+        bool computed;
+    };
+
+    struct CursorAfter {
+        bool operator()(const Cursor& a, const Cursor& b) const {
+            return a.key > b.key || (a.key == b.key && a.source > b.source);
+        }
+    };
+
+    Schedule studentSchedule;
+    std::vector<Schedule> officeHours;
+    int endWeek;
+    int minDurationMinutes;
+    WeekLayoutBuilder builder;
+    std::vector<Cursor> heap;
+    std::vector<std::vector<TimeSlot>> pending;             // 每位教师当前周的结果，按开始时间排序
+    std::map<int, std::vector<ScheduleEvent>> studentWeeks;
+    std::size_t computedCount;
+
+    void pushWeek(std::size_t source, int week);
+    void push(const Cursor& cursor);
+    const std::vector<ScheduleEvent>& studentWeek(int week);
+};
+
+#endif // AVAILABLESLOTGENERATOR_H
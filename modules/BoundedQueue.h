@@ -0,0 +1,87 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+// 有界阻塞队列，用于流水线各阶段之间传递数据
+// 队列满时生产者阻塞，close() 之后所有等待者立即返回
+template <typename T>
+class BoundedQueue {
+private:
+    std::deque<T> items;
+    std::size_t capacity;
+    bool closed;
+    mutable std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+
+public:
+    explicit BoundedQueue(std::size_t maxItems)
+        : capacity(maxItems > 0 ? maxItems : 1), closed(false) {
+    }
+
+    // 放入一项，队列已关闭时返回 false
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this] { return closed || items.size() < capacity; });
+        if (closed) {
+            return false;
+        }
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    // 取出一项，队列已关闭且为空时返回 false
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty()) {
+            return false;
+        }
+        item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    // 不阻塞地取出一项
+    bool tryPop(T& item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (items.empty()) {
+            return false;
+        }
+        item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    // 关闭队列：不再接受新数据，已有数据仍可取出
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+    // 关闭并丢弃剩余数据（取消时使用）
+    void abort() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        items.clear();
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+    // 已关闭且没有剩余数据
+    bool isDrained() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return closed && items.empty();
+    }
+};
+
+#endif // BOUNDEDQUEUE_H
@@ -0,0 +1,149 @@
+#include "BusySummary.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+using Interval = std::pair<int, int>;
+
+// 合并后的总长度，结果不超过一天
+int unionMinutes(std::vector<Interval>& intervals) {
+    std::sort(intervals.begin(), intervals.end());
+    int total = 0;
+    int coveredUntil = 0;
+    for (const auto& interval : intervals) {
+        int start = std::max(interval.first, coveredUntil);
+        if (interval.second > start) {
+            total += interval.second - start;
+            coveredUntil = interval.second;
+        }
+    }
+    return std::min(total, 1440);
+}
+
+bool isVisible(const CompressedBitmap* visible, int eventId) {
+    return !visible || visible->contains(static_cast<std::uint32_t>(eventId));
+}
+
+} // namespace
+
+BusySummary::BusySummary() : firstWeek(0), weekCount(0), courseMinutes{} {
+}
+
+void BusySummary::reset(const User& user, const CompressedBitmap* visible, int first, int count) {
+    builder = WeekLayoutBuilder();
+    firstWeek = first;
+    weekCount = std::max(count, 0);
+    for (auto& bucket : courseBuckets) {
+        bucket.clear();
+    }
+    personalBuckets.assign(static_cast<std::size_t>(weekCount) * 7, Bucket());
+    placements.clear();
+    minutes.assign(personalBuckets.size(), 0);
+
+    std::vector<bool> dirtyDays(minutes.size(), false);
+    std::array<bool, 7> dirtyWeekdays{};
+    for (bool course : {true, false}) {
+        const Schedule& schedule = course ? user.getCourses() : user.getPersonalSchedule();
+        for (const auto& event : schedule.getAllEvents()) {
+            if (isVisible(visible, event.getId())) {
+                insert(event, course, dirtyDays, dirtyWeekdays);
+            }
+        }
+    }
+    dirtyWeekdays.fill(true);
+    recompute(dirtyDays, dirtyWeekdays);
+}
+
+void BusySummary::apply(const ChangeSet& changes, const CompressedBitmap* visible) {
+    std::vector<bool> dirtyDays(minutes.size(), false);
+    std::array<bool, 7> dirtyWeekdays{};
+    // 按发生顺序逐个处理，同一事件多次变化后只留下最终状态
+    for (const auto& change : changes.changes) {
+        erase(change.event.getId(), dirtyDays, dirtyWeekdays);
+        if (change.kind != EventChange::Kind::Removed && isVisible(visible, change.event.getId())) {
+            insert(change.event, change.course, dirtyDays, dirtyWeekdays);
+        }
+    }
+    recompute(dirtyDays, dirtyWeekdays);
+}
+
+const std::vector<int>& BusySummary::getMinutes() const {
+    return minutes;
+}
+
+void BusySummary::insert(const ScheduleEvent& event, bool course, std::vector<bool>& dirtyDays,
+                         std::array<bool, 7>& dirtyWeekdays) {
+    LaidOutEvent placed;
+    std::size_t bucket;
+    if (course) {
+        if (!builder.place(event, 0, placed)) {
+            return;
+        }
+        bucket = static_cast<std::size_t>(placed.day);
+        dirtyWeekdays[bucket] = true;
+    } else {
+        int week = builder.weekOf(event);
+        if (week < firstWeek || week >= firstWeek + weekCount || !builder.place(event, week, placed)) {
+            return;
+        }
+        bucket = static_cast<std::size_t>(week - firstWeek) * 7 + placed.day;
+        dirtyDays[bucket] = true;
+    }
+
+    Interval interval(std::max(placed.startMinute, 0), std::min(placed.endMinute, 1440));
+    Bucket& target = course ? courseBuckets[bucket] : personalBuckets[bucket];
+    target.emplace_back(interval, event.getId());
+    placements[event.getId()] = Placement{course, bucket};
+}
+
+void BusySummary::erase(int eventId, std::vector<bool>& dirtyDays, std::array<bool, 7>& dirtyWeekdays) {
+    auto found = placements.find(eventId);
+    if (found == placements.end()) {
+        return;
+    }
+    Placement placement = found->second;
+    placements.erase(found);
+
+    Bucket& bucket = placement.course ? courseBuckets[placement.bucket] : personalBuckets[placement.bucket];
+    bucket.erase(std::remove_if(bucket.begin(), bucket.end(),
+                                [eventId](const std::pair<Interval, int>& item) { return item.second == eventId; }),
+                 bucket.end());
+    if (placement.course) {
+        dirtyWeekdays[placement.bucket] = true;
+    } else {
+        dirtyDays[placement.bucket] = true;
+    }
+}
+
+void BusySummary::recompute(const std::vector<bool>& dirtyDays, const std::array<bool, 7>& dirtyWeekdays) {
+    std::vector<Interval> intervals;
+    auto collect = [&intervals](const Bucket& bucket) {
+        for (const auto& item : bucket) {
+            intervals.push_back(item.first);
+        }
+    };
+
+    for (int day = 0; day < 7; ++day) {
+        if (dirtyWeekdays[day]) {
+            intervals.clear();
+            collect(courseBuckets[day]);
+            courseMinutes[day] = unionMinutes(intervals);
+        }
+    }
+
+    for (std::size_t index = 0; index < minutes.size(); ++index) {
+        int day = static_cast<int>(index % 7);
+        if (!dirtyDays[index] && !dirtyWeekdays[day]) {
+            continue;
+        }
+        if (personalBuckets[index].empty()) {
+            minutes[index] = courseMinutes[day];
+            continue;
+        }
+        intervals.clear();
+        collect(courseBuckets[day]);
+        collect(personalBuckets[index]);
+        minutes[index] = unionMinutes(intervals);
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef BUSYSUMMARY_H
+#define BUSYSUMMARY_H
+
+#include "CompressedBitmap.h"
+#include "ScheduleChange.h"
+#include "WeekLayout.h"
+#include "../datastructure/User.h"
+#include <array>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 按天汇总的忙碌分钟数，供学期总览使用
+// 同一天内重叠的事件只计一次；课程每周重复，个人日程只计入所属周
+// 事件的区间按天分桶常驻，日程变化时只重算受影响的天：
+// 个人日程只影响所在的一天，课程影响范围内每一周的同一星期
+class BusySummary {
+public:
+    BusySummary();
+
+    // 统计全部事件，周偏移相对于本周（加载、切换用户或更换筛选条件时调用）
+    // visible 不为空时只统计其中的事件编号
+    void reset(const User& user, const CompressedBitmap* visible, int firstWeek, int weekCount);
+
+    // 按变化更新，visible 为变化后的筛选结果；changes.reset 为 true 时调用方应改用 reset
+    void apply(const ChangeSet& changes, const CompressedBitmap* visible);
+
+    // weekCount * 7 个值，依次为 firstWeek 周的周一、周二……
+    const std::vector<int>& getMinutes() const;
+
+private:
+    using Interval = std::pair<int, int>;           // [开始分钟, 结束分钟)
+    using Bucket = std::vector<std::pair<Interval, int>>;   // 区间及其事件编号
+
+    struct Placement {
+        bool course;
+        std::size_t bucket;     // 课程为星期（0..6），个人日程为 minutes 中的下标
+    };
+
+    WeekLayoutBuilder builder;
+    int firstWeek;
+    int weekCount;
+    std::array<Bucket, 7> courseBuckets;
+    std::vector<Bucket> personalBuckets;
+    std::unordered_map<int, Placement> placements;
+    std::array<int, 7> courseMinutes;
+    std::vector<int> minutes;
+
+    void insert(const ScheduleEvent& event, bool course, std::vector<bool>& dirtyDays,
+                std::array<bool, 7>& dirtyWeekdays);
+    void erase(int eventId, std::vector<bool>& dirtyDays, std::array<bool, 7>& dirtyWeekdays);
+    void recompute(const std::vector<bool>& dirtyDays, const std::array<bool, 7>& dirtyWeekdays);
+};
+
+#endif // BUSYSUMMARY_H
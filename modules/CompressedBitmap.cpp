@@ -0,0 +1,356 @@
+#include "CompressedBitmap.h"
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+
+namespace {
+
+// 数组容器的上限，超过后转为位图容器（此时两者内存相当）
+const std::uint32_t ARRAY_LIMIT = 4096;
+const std::size_t BITMAP_WORDS = 65536 / 64;
+
+int popcount64(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(value);
+#else
+    int count = 0;
+    while (value) {
+        value &= value - 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+} // namespace
+
+bool CompressedBitmap::Container::contains(std::uint16_t low) const {
+    if (isBitmap()) {
+        return (bits[low >> 6] >> (low & 63)) & 1;
+    }
+    return std::binary_search(array.begin(), array.end(), low);
+}
+
+void CompressedBitmap::Container::add(std::uint16_t low) {
+    if (isBitmap()) {
+        std::uint64_t mask = std::uint64_t(1) << (low & 63);
+        if (!(bits[low >> 6] & mask)) {
+            bits[low >> 6] |= mask;
+            count++;
+        }
+        return;
+    }
+
+    auto it = std::lower_bound(array.begin(), array.end(), low);
+    if (it != array.end() && *it == low) {
+        return;
+    }
+    array.insert(it, low);
+    count++;
+    if (count > ARRAY_LIMIT) {
+        toBitmap();
+    }
+}
+
+void CompressedBitmap::Container::remove(std::uint16_t low) {
+    if (isBitmap()) {
+        std::uint64_t mask = std::uint64_t(1) << (low & 63);
+        if (bits[low >> 6] & mask) {
+            bits[low >> 6] &= ~mask;
+            count--;
+            toArrayIfSparse();
+        }
+        return;
+    }
+
+    auto it = std::lower_bound(array.begin(), array.end(), low);
+    if (it != array.end() && *it == low) {
+        array.erase(it);
+        count--;
+    }
+}
+
+void CompressedBitmap::Container::toBitmap() {
+    bits.assign(BITMAP_WORDS, 0);
+    for (std::uint16_t low : array) {
+        bits[low >> 6] |= std::uint64_t(1) << (low & 63);
+    }
+    array.clear();
+    array.shrink_to_fit();
+}
+
+void CompressedBitmap::Container::toArrayIfSparse() {
+    if (!isBitmap() || count > ARRAY_LIMIT) {
+        return;
+    }
+    array.clear();
+    array.reserve(count);
+    for (std::size_t word = 0; word < BITMAP_WORDS; ++word) {
+        std::uint64_t value = bits[word];
+        while (value) {
+            int bit = popcount64((value & (~value + 1)) - 1);
+            array.push_back(static_cast<std::uint16_t>(word * 64 + bit));
+            value &= value - 1;
+        }
+    }
+    bits.clear();
+    bits.shrink_to_fit();
+}
+
+void CompressedBitmap::Container::appendTo(std::vector<std::uint32_t>& out) const {
+    std::uint32_t high = static_cast<std::uint32_t>(key) << 16;
+    if (!isBitmap()) {
+        for (std::uint16_t low : array) {
+            out.push_back(high | low);
+        }
+        return;
+    }
+    for (std::size_t word = 0; word < BITMAP_WORDS; ++word) {
+        std::uint64_t value = bits[word];
+        while (value) {
+            int bit = popcount64((value & (~value + 1)) - 1);
+            out.push_back(high | static_cast<std::uint32_t>(word * 64 + bit));
+            value &= value - 1;
+        }
+    }
+}
+
+CompressedBitmap::CompressedBitmap() {
+}
+
+std::size_t CompressedBitmap::findContainer(std::uint16_t key) const {
+    auto it = std::lower_bound(containers.begin(), containers.end(), key,
+                               [](const Container& c, std::uint16_t k) { return c.key < k; });
+    return static_cast<std::size_t>(it - containers.begin());
+}
+
+void CompressedBitmap::add(std::uint32_t value) {
+    std::uint16_t key = static_cast<std::uint16_t>(value >> 16);
+    std::size_t index = findContainer(key);
+    if (index == containers.size() || containers[index].key != key) {
+        Container container;
+        container.key = key;
+        container.count = 0;
+        containers.insert(containers.begin() + index, std::move(container));
+    }
+    containers[index].add(static_cast<std::uint16_t>(value & 0xFFFF));
+}
+
+void CompressedBitmap::remove(std::uint32_t value) {
+    std::uint16_t key = static_cast<std::uint16_t>(value >> 16);
+    std::size_t index = findContainer(key);
+    if (index == containers.size() || containers[index].key != key) {
+        return;
+    }
+    containers[index].remove(static_cast<std::uint16_t>(value & 0xFFFF));
+    if (containers[index].count == 0) {
+        containers.erase(containers.begin() + index);
+    }
+}
+
+bool CompressedBitmap::contains(std::uint32_t value) const {
+    std::uint16_t key = static_cast<std::uint16_t>(value >> 16);
+    std::size_t index = findContainer(key);
+    return index < containers.size() && containers[index].key == key &&
+           containers[index].contains(static_cast<std::uint16_t>(value & 0xFFFF));
+}
+
+void CompressedBitmap::clear() {
+    containers.clear();
+}
+
+std::size_t CompressedBitmap::cardinality() const {
+    std::size_t total = 0;
+    for (const auto& container : containers) {
+        total += container.count;
+    }
+    return total;
+}
+
+bool CompressedBitmap::isEmpty() const {
+    return containers.empty();
+}
+
+std::vector<std::uint32_t> CompressedBitmap::toVector() const {
+    std::vector<std::uint32_t> out;
+    out.reserve(cardinality());
+    for (const auto& container : containers) {
+        container.appendTo(out);
+    }
+    return out;
+}
+
+CompressedBitmap CompressedBitmap::fromSorted(const std::vector<std::uint32_t>& values) {
+    CompressedBitmap result;
+    for (std::size_t i = 0; i < values.size(); ) {
+        Container container;
+        container.key = static_cast<std::uint16_t>(values[i] >> 16);
+        container.count = 0;
+        std::size_t end = i;
+        while (end < values.size() && (values[end] >> 16) == container.key) {
+            std::uint16_t low = static_cast<std::uint16_t>(values[end] & 0xFFFF);
+            if (container.array.empty() || container.array.back() != low) {
+                container.array.push_back(low);
+            }
+            end++;
+        }
+        container.count = static_cast<std::uint32_t>(container.array.size());
+        if (container.count > ARRAY_LIMIT) {
+            container.toBitmap();
+        }
+        result.containers.push_back(std::move(container));
+        i = end;
+    }
+    return result;
+}
+
+CompressedBitmap::Container CompressedBitmap::intersectContainers(const Container& a, const Container& b) {
+    Container result;
+    result.key = a.key;
+    result.count = 0;
+
+    if (a.isBitmap() && b.isBitmap()) {
+        result.bits.assign(BITMAP_WORDS, 0);
+        for (std::size_t i = 0; i < BITMAP_WORDS; ++i) {
+            result.bits[i] = a.bits[i] & b.bits[i];
+            result.count += popcount64(result.bits[i]);
+        }
+        result.toArrayIfSparse();
+    } else if (a.isBitmap() || b.isBitmap()) {
+        // 数组逐个查位图
+        const Container& sparse = a.isBitmap() ? b : a;
+        const Container& dense = a.isBitmap() ? a : b;
+        for (std::uint16_t low : sparse.array) {
+            if (dense.contains(low)) {
+                result.array.push_back(low);
+            }
+        }
+        result.count = static_cast<std::uint32_t>(result.array.size());
+    } else {
+        std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                              std::back_inserter(result.array));
+        result.count = static_cast<std::uint32_t>(result.array.size());
+    }
+    return result;
+}
+
+CompressedBitmap::Container CompressedBitmap::uniteContainers(const Container& a, const Container& b) {
+    Container result;
+    result.key = a.key;
+    result.count = 0;
+
+    if (!a.isBitmap() && !b.isBitmap() && a.count + b.count <= ARRAY_LIMIT) {
+        std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                       std::back_inserter(result.array));
+        result.count = static_cast<std::uint32_t>(result.array.size());
+        return result;
+    }
+
+    result.bits.assign(BITMAP_WORDS, 0);
+    for (const Container* source : {&a, &b}) {
+        if (source->isBitmap()) {
+            for (std::size_t i = 0; i < BITMAP_WORDS; ++i) {
+                result.bits[i] |= source->bits[i];
+            }
+        } else {
+            for (std::uint16_t low : source->array) {
+                result.bits[low >> 6] |= std::uint64_t(1) << (low & 63);
+            }
+        }
+    }
+    for (std::size_t i = 0; i < BITMAP_WORDS; ++i) {
+        result.count += popcount64(result.bits[i]);
+    }
+    result.toArrayIfSparse();
+    return result;
+}
+
+CompressedBitmap::Container CompressedBitmap::subtractContainers(const Container& a, const Container& b) {
+    Container result;
+    result.key = a.key;
+    result.count = 0;
+
+    if (a.isBitmap()) {
+        result.bits = a.bits;
+        if (b.isBitmap()) {
+            for (std::size_t i = 0; i < BITMAP_WORDS; ++i) {
+                result.bits[i] &= ~b.bits[i];
+            }
+        } else {
+            for (std::uint16_t low : b.array) {
+                result.bits[low >> 6] &= ~(std::uint64_t(1) << (low & 63));
+            }
+        }
+        for (std::size_t i = 0; i < BITMAP_WORDS; ++i) {
+            result.count += popcount64(result.bits[i]);
+        }
+        result.toArrayIfSparse();
+    } else {
+        for (std::uint16_t low : a.array) {
+            if (!b.contains(low)) {
+                result.array.push_back(low);
+            }
+        }
+        result.count = static_cast<std::uint32_t>(result.array.size());
+    }
+    return result;
+}
+
+CompressedBitmap CompressedBitmap::intersect(const CompressedBitmap& a, const CompressedBitmap& b) {
+    CompressedBitmap result;
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (i < a.containers.size() && j < b.containers.size()) {
+        if (a.containers[i].key < b.containers[j].key) {
+            i++;
+        } else if (a.containers[i].key > b.containers[j].key) {
+            j++;
+        } else {
+            Container merged = intersectContainers(a.containers[i], b.containers[j]);
+            if (merged.count > 0) {
+                result.containers.push_back(std::move(merged));
+            }
+            i++;
+            j++;
+        }
+    }
+    return result;
+}
+
+CompressedBitmap CompressedBitmap::unite(const CompressedBitmap& a, const CompressedBitmap& b) {
+    CompressedBitmap result;
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (i < a.containers.size() || j < b.containers.size()) {
+        if (j == b.containers.size() ||
+            (i < a.containers.size() && a.containers[i].key < b.containers[j].key)) {
+            result.containers.push_back(a.containers[i++]);
+        } else if (i == a.containers.size() || b.containers[j].key < a.containers[i].key) {
+            result.containers.push_back(b.containers[j++]);
+        } else {
+            result.containers.push_back(uniteContainers(a.containers[i], b.containers[j]));
+            i++;
+            j++;
+        }
+    }
+    return result;
+}
+
+CompressedBitmap CompressedBitmap::subtract(const CompressedBitmap& a, const CompressedBitmap& b) {
+    CompressedBitmap result;
+    std::size_t j = 0;
+    for (const auto& container : a.containers) {
+        while (j < b.containers.size() && b.containers[j].key < container.key) {
+            j++;
+        }
+        if (j < b.containers.size() && b.containers[j].key == container.key) {
+            Container remaining = subtractContainers(container, b.containers[j]);
+            if (remaining.count > 0) {
+                result.containers.push_back(std::move(remaining));
+            }
+        } else {
+            result.containers.push_back(container);
+        }
+    }
+    return result;
+}
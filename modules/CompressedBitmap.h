@@ -0,0 +1,59 @@
+#ifndef COMPRESSEDBITMAP_H
+#define COMPRESSEDBITMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 压缩位图（Roaring 结构的简化版）
+// 按高16位把整数分成若干块，每块按密度选择存储方式：
+// 元素不超过 4096 个时用有序数组，否则用 65536 位的位图
+// 稀疏的事件编号集合只占少量内存，交并运算按块进行
+class CompressedBitmap {
+public:
+    CompressedBitmap();
+
+    void add(std::uint32_t value);
+    void remove(std::uint32_t value);
+    bool contains(std::uint32_t value) const;
+    void clear();
+
+    std::size_t cardinality() const;
+    bool isEmpty() const;
+
+    // 按升序取出全部元素
+    std::vector<std::uint32_t> toVector() const;
+
+    // 集合运算
+    static CompressedBitmap intersect(const CompressedBitmap& a, const CompressedBitmap& b);
+    static CompressedBitmap unite(const CompressedBitmap& a, const CompressedBitmap& b);
+    static CompressedBitmap subtract(const CompressedBitmap& a, const CompressedBitmap& b);
+
+    // 由有序（可重复）数组构建
+    static CompressedBitmap fromSorted(const std::vector<std::uint32_t>& values);
+
+private:
+    struct Container {
+        std::uint16_t key;                  // 高16位
+        std::vector<std::uint16_t> array;   // 稀疏时使用，升序
+        std::vector<std::uint64_t> bits;    // 稠密时使用，1024 个字
+        std::uint32_t count;
+
+        bool isBitmap() const { return !bits.empty(); }
+        bool contains(std::uint16_t low) const;
+        void add(std::uint16_t low);
+        void remove(std::uint16_t low);
+        void toBitmap();
+        void toArrayIfSparse();
+        void appendTo(std::vector<std::uint32_t>& out) const;
+    };
+
+    std::vector<Container> containers;      // 按 key 升序
+
+    std::size_t findContainer(std::uint16_t key) const;
+    static Container intersectContainers(const Container& a, const Container& b);
+    static Container uniteContainers(const Container& a, const Container& b);
+    static Container subtractContainers(const Container& a, const Container& b);
+};
+
+#endif // COMPRESSEDBITMAP_H
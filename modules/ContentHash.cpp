@@ -0,0 +1,74 @@
+#include "ContentHash.h"
+#include <ctime>
+
+namespace {
+
+const std::uint64_t FNV_OFFSET = 14695981039346656037ULL;
+const std::uint64_t FNV_PRIME = 1099511628211ULL;
+
+std::uint64_t fnvBytes(std::uint64_t hash, const void* data, std::size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// 字符串连同长度一起哈希，避免 "ab"+"c" 与 "a"+"bc" 冲突
+std::uint64_t fnvString(std::uint64_t hash, const std::string& text) {
+    std::uint64_t length = text.size();
+    hash = fnvBytes(hash, &length, sizeof(length));
+    return fnvBytes(hash, text.data(), text.size());
+}
+
+std::uint64_t fnvInt(std::uint64_t hash, std::int64_t value) {
+    return fnvBytes(hash, &value, sizeof(value));
+}
+
+// 求和之前打散各位，避免相近的 FNV 值相加后相互抵消
+std::uint64_t mix(std::uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+} // namespace
+
+std::uint64_t ContentHash::hashEvent(const ScheduleEvent& event) {
+    TimeSlot slot = event.getTimeSlot();
+    std::uint64_t hash = FNV_OFFSET;
+    hash = fnvString(hash, event.getEventName());
+    hash = fnvString(hash, event.getLocation());
+    hash = fnvString(hash, event.getDescription());
+    hash = fnvInt(hash, event.getWeekday());
+    hash = fnvInt(hash, static_cast<std::int64_t>(std::chrono::system_clock::to_time_t(slot.getStartTime())));
+    hash = fnvInt(hash, static_cast<std::int64_t>(std::chrono::system_clock::to_time_t(slot.getEndTime())));
+    hash = fnvInt(hash, slot.getIsCourse() ? 1 : 0);
+    // 无标签时不计入，保持与旧数据的哈希一致
+    if (event.getTags() != 0) {
+        hash = fnvInt(hash, event.getTags());
+    }
+    return mix(hash);
+}
+
+std::uint64_t ContentHash::hashSchedule(const Schedule& schedule) {
+    std::uint64_t sum = 0;
+    for (const auto& event : schedule.getAllEvents()) {
+        sum += hashEvent(event);
+    }
+    return sum;
+}
+
+std::uint64_t ContentHash::hashProfessor(const std::string& email, std::uint64_t officeHoursHash) {
+    std::uint64_t hash = fnvString(FNV_OFFSET, email);
+    hash = fnvInt(hash, static_cast<std::int64_t>(officeHoursHash));
+    return mix(hash);
+}
+
+std::uint64_t ContentHash::hashProfessor(const Professor& prof) {
+    return hashProfessor(prof.getEmail(), hashSchedule(prof.getOfficeHours()));
+}
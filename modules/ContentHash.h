@@ -0,0 +1,21 @@
+#ifndef CONTENTHASH_H
+#define CONTENTHASH_H
+
+#include "../datastructure/Professor.h"
+#include <cstdint>
+#include <string>
+
+// 日程内容哈希，用于判断重新导入的数据是否有变化
+// 事件哈希不含事件编号（每次导入都会重新分配）；
+// 日程哈希是各事件哈希之和，与事件顺序无关，可以在流式导入时逐行累加
+class ContentHash {
+public:
+    static std::uint64_t hashEvent(const ScheduleEvent& event);
+    static std::uint64_t hashSchedule(const Schedule& schedule);
+
+    // 教师哈希 = 邮箱 + 办公时间哈希（姓名作为键，不计入）
+    static std::uint64_t hashProfessor(const std::string& email, std::uint64_t officeHoursHash);
+    static std::uint64_t hashProfessor(const Professor& prof);
+};
+
+#endif // CONTENTHASH_H
@@ -0,0 +1,291 @@
+#include "CsvTokenizer.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CSV_USE_SSE2 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+namespace {
+
+#ifdef CSV_USE_SSE2
+inline int lowestBit(unsigned int mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+// 查找 [p, end) 中第一个等于 a/b/c/d 之一的字节，找不到返回 end
+inline const char* findAny(const char* p, const char* end, char a, char b, char c, char d) {
+#ifdef CSV_USE_SSE2
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+    const __m128i vc = _mm_set1_epi8(c);
+    const __m128i vd = _mm_set1_epi8(d);
+    while (end - p >= 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hit = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(block, va), _mm_cmpeq_epi8(block, vb)),
+            _mm_or_si128(_mm_cmpeq_epi8(block, vc), _mm_cmpeq_epi8(block, vd)));
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(hit));
+        if (mask != 0) {
+            return p + lowestBit(mask);
+        }
+        p += 16;
+    }
+#endif
+    for (; p < end; ++p) {
+        char ch = *p;
+        if (ch == a || ch == b || ch == c || ch == d) {
+            return p;
+        }
+    }
+    return end;
+}
+
+// 从 p 起按 nextRecord 的规则扫描到 end，每遇到一个记录结尾就以结尾之后的偏移调用 onBoundary；
+// onBoundary 返回 true 时立即停止。返回停止的位置，state 更新为该处的状态
+template <typename OnBoundary>
+const char* scanRecords(const char* base, const char* p, const char* end,
+                        CsvTokenizer::ScanState& state, OnBoundary onBoundary) {
+    using State = CsvTokenizer::ScanState;
+    while (p < end) {
+        switch (state) {
+            case State::CarriageReturn:
+                // \r\n 整体作为记录结尾
+                state = State::FieldStart;
+                if (*p == '\n') {
+                    ++p;
+                }
+                if (onBoundary(static_cast<std::size_t>(p - base))) {
+                    return p;
+                }
+                break;
+            case State::FieldStart:
+                if (*p == '"') {
+                    state = State::Quoted;
+                    ++p;
+                } else {
+                    state = State::Unquoted;
+                }
+                break;
+            case State::Unquoted:
+                // 普通字段中的引号按普通字符处理，只找分隔符和换行
+                p = findAny(p, end, ',', '\n', '\r', ',');
+                if (p >= end) {
+                    break;
+                }
+                if (*p == ',') {
+                    state = State::FieldStart;
+                    ++p;
+                } else if (*p == '\r') {
+                    state = State::CarriageReturn;
+                    ++p;
+                } else {
+                    state = State::FieldStart;
+                    ++p;
+                    if (onBoundary(static_cast<std::size_t>(p - base))) {
+                        return p;
+                    }
+                }
+                break;
+            case State::Quoted: {
+                const char* q = static_cast<const char*>(std::memchr(p, '"', end - p));
+                if (q == nullptr) {
+                    p = end;
+                } else {
+                    state = State::QuoteSeen;
+                    p = q + 1;
+                }
+                break;
+            }
+            case State::QuoteSeen:
+                // "" 为转义；否则字段已闭合，到分隔符之前的多余字符与普通字段一样跳过
+                if (*p == '"') {
+                    state = State::Quoted;
+                    ++p;
+                } else {
+                    state = State::Unquoted;
+                }
+                break;
+        }
+    }
+    return p;
+}
+
+} // namespace
+
+std::string_view CsvField::view() const {
+    return raw;
+}
+
+std::string CsvField::toString() const {
+    if (!hasEscapedQuotes) {
+        return std::string(raw);
+    }
+    std::string result;
+    result.reserve(raw.size());
+    for (std::size_t i = 0; i < raw.size(); ++i) {
+        result.push_back(raw[i]);
+        if (raw[i] == '"' && i + 1 < raw.size() && raw[i + 1] == '"') {
+            ++i;
+        }
+    }
+    return result;
+}
+
+CsvTokenizer::CsvTokenizer(std::string_view input, char delim)
+    : data(input), pos(0), recordNo(0), delimiter(delim) {
+}
+
+bool CsvTokenizer::nextRecord(std::vector<CsvField>& fields) {
+    fields.clear();
+    if (pos >= data.size()) {
+        return false;
+    }
+
+    const char* base = data.data();
+    const char* end = base + data.size();
+    const char* p = base + pos;
+
+    while (true) {
+        CsvField field;
+        if (p < end && *p == '"') {
+            // 带引号字段：一直读到未成对的引号
+            field.quoted = true;
+            const char* start = ++p;
+            while (true) {
+                const char* q = static_cast<const char*>(std::memchr(p, '"', end - p));
+                if (q == nullptr) {
+                    // 引号未闭合，取到数据末尾
+                    field.raw = std::string_view(start, end - start);
+                    p = end;
+                    break;
+                }
+                if (q + 1 < end && q[1] == '"') {
+                    field.hasEscapedQuotes = true;
+                    p = q + 2;
+                    continue;
+                }
+                field.raw = std::string_view(start, q - start);
+                p = q + 1;
+                break;
+            }
+            // 闭合引号与分隔符之间的多余字符忽略
+            p = findAny(p, end, delimiter, '\n', '\r', delimiter);
+        } else {
+            // 普通字段：非引号字段中出现的引号按普通字符处理
+            const char* start = p;
+            while (true) {
+                p = findAny(p, end, delimiter, '"', '\n', '\r');
+                if (p < end && *p == '"') {
+                    ++p;
+                    continue;
+                }
+                break;
+            }
+            field.raw = std::string_view(start, p - start);
+        }
+        fields.push_back(field);
+
+        if (p >= end) {
+            pos = data.size();
+            break;
+        }
+        if (*p == delimiter) {
+            ++p;
+            continue;
+        }
+
+        // 记录结束：\r\n、\n 或单独的 \r
+        if (*p == '\r') {
+            ++p;
+            if (p < end && *p == '\n') {
+                ++p;
+            }
+        } else {
+            ++p;
+        }
+        pos = static_cast<std::size_t>(p - base);
+        break;
+    }
+
+    ++recordNo;
+    return true;
+}
+
+bool CsvTokenizer::skipRecord() {
+    std::vector<CsvField> fields;
+    return nextRecord(fields);
+}
+
+std::size_t CsvTokenizer::recordNumber() const {
+    return recordNo;
+}
+
+std::size_t CsvTokenizer::position() const {
+    return pos;
+}
+
+bool CsvTokenizer::isBlankRecord(const std::vector<CsvField>& fields) {
+    return fields.size() == 1 && fields[0].raw.empty() && !fields[0].quoted;
+}
+
+std::size_t CsvTokenizer::lastRecordEnd(std::string_view input) {
+    std::size_t scanned = 0;
+    ScanState state = ScanState::FieldStart;
+    return lastRecordEnd(input, scanned, state);
+}
+
+std::size_t CsvTokenizer::lastRecordEnd(std::string_view input, std::size_t& scanned, ScanState& state) {
+    const char* base = input.data();
+    std::size_t last = 0;
+    scanRecords(base, base + std::min(scanned, input.size()), base + input.size(), state,
+                [&last](std::size_t boundary) {
+                    last = boundary;
+                    return false;
+                });
+    scanned = input.size();
+    return last;
+}
+
+std::vector<std::string_view> CsvTokenizer::splitRecordAligned(std::string_view input, int chunkCount) {
+    std::vector<std::string_view> chunks;
+    const char* base = input.data();
+    const char* end = base + input.size();
+
+    std::size_t begin = 0;
+    const char* scanned = base;                 // 已扫描到的位置
+    ScanState state = ScanState::FieldStart;    // scanned 处的状态
+
+    for (int i = 1; i < chunkCount && begin < input.size(); ++i) {
+        std::size_t target = input.size() * i / chunkCount;
+        if (target <= begin) continue;
+
+        // 先扫描到目标位置确定状态，再向后找第一个记录边界
+        scanned = scanRecords(base, scanned, base + target, state, [](std::size_t) { return false; });
+        std::size_t boundary = 0;
+        scanned = scanRecords(base, scanned, end, state, [&boundary](std::size_t offset) {
+            boundary = offset;
+            return true;
+        });
+        if (boundary == 0) break;
+
+        chunks.push_back(input.substr(begin, boundary - begin));
+        begin = boundary;
+    }
+
+    if (begin < input.size()) {
+        chunks.push_back(input.substr(begin));
+    }
+    return chunks;
+}
@@ -0,0 +1,72 @@
+#ifndef CSVTOKENIZER_H
+#define CSVTOKENIZER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// CSV字段：指向原始数据的视图，不做拷贝
+struct CsvField {
+    std::string_view raw;           // 去掉外层引号后的内容（"" 尚未还原）
+    bool quoted = false;            // 是否为带引号的字段
+    bool hasEscapedQuotes = false;  // 内容中是否含有 "" 转义
+
+    // 不含转义时可直接使用的视图
+    std::string_view view() const;
+
+    // 还原转义后拷贝为字符串
+    std::string toString() const;
+};
+
+// 符合 RFC 4180 的CSV分词器
+// 支持带引号字段、"" 转义以及引号内的逗号和换行；CRLF 和 LF 行尾均可
+// 引号外的分隔符/引号/换行查找使用 SSE2 一次扫描16字节
+class CsvTokenizer {
+private:
+    std::string_view data;
+    std::size_t pos;
+    std::size_t recordNo;
+    char delimiter;
+
+public:
+    // 记录边界扫描的状态，规则与 nextRecord 相同：只有字段开头的引号开启带引号字段，
+    // 普通字段中的引号按普通字符处理；\n、\r\n 和单独的 \r 都结束记录
+    enum class ScanState : unsigned char {
+        FieldStart,         // 字段开头
+        Unquoted,           // 普通字段内，或带引号字段闭合之后、分隔符之前
+        Quoted,             // 带引号字段内
+        QuoteSeen,          // 带引号字段内刚遇到引号：后面是引号则为转义，否则字段闭合
+        CarriageReturn      // 刚遇到 \r：后面是 \n 时一起作为记录结尾
+    };
+
+    explicit CsvTokenizer(std::string_view input, char delim = ',');
+
+    // 读取下一条记录到 fields（复用其容量），没有更多数据时返回 false
+    bool nextRecord(std::vector<CsvField>& fields);
+
+    // 跳过一条记录（例如表头）
+    bool skipRecord();
+
+    // 最近一次返回的记录序号（从1开始）
+    std::size_t recordNumber() const;
+
+    // 下一条记录在输入中的起始偏移
+    std::size_t position() const;
+
+    // 是否为空行（只有一个空的未加引号字段）
+    static bool isBlankRecord(const std::vector<CsvField>& fields);
+
+    // 返回最后一条完整记录之后的偏移，没有完整记录时返回0；分隔符为逗号
+    // input 必须从记录边界开始；末尾单独的 \r 要等到下一个字节才能确定，不算作边界
+    static std::size_t lastRecordEnd(std::string_view input);
+
+    // 同上，用于不断追加的缓冲区：从 scanned 处以 state 的状态继续扫描，
+    // 返回时两者更新为扫描到末尾时的状态；只在新扫描的部分中查找，没有完整记录时返回0
+    static std::size_t lastRecordEnd(std::string_view input, std::size_t& scanned, ScanState& state);
+
+    // 按记录边界把数据切成最多 chunkCount 块，边界与 nextRecord 逐条解析的结果一致
+    static std::vector<std::string_view> splitRecordAligned(std::string_view input, int chunkCount);
+};
+
+#endif // CSVTOKENIZER_H
@@ -1,177 +1,511 @@
 #include "DataManager.h"
+#include "LineTokenizer.h"
+#include "ContentHash.h"
+#include "RecordFormat.h"
+#include "MappedFile.h"
+#include <algorithm>
 #include <fstream>
-#include <sstream>
-#include <iomanip>
+#include <initializer_list>
 
-DataManager::DataManager() {
+namespace {
+
+// 房间占用的来源编号：学生事件为事件编号，教师办公时间为（教师句柄 + 1, 序号）
+std::uint64_t userRoomOwner(int eventId) {
+    return static_cast<std::uint32_t>(eventId);
+}
+
+std::uint64_t professorRoomOwner(std::size_t handle, std::size_t index) {
+    return (static_cast<std::uint64_t>(handle + 1) << 32) | static_cast<std::uint32_t>(index);
+}
+
+} // namespace
+
+DataManager::DataManager() : revisionCounter(0), professorsDirty(false), nextListenerId(1) {
 }
 
 bool DataManager::saveUserData(const User& userData, const std::string& filePath) {
-    std::ofstream file(filePath);
-    if (!file.is_open()) {
+    return RecordFormat::writeUserFile(userData, filePath);
+}
+
+bool DataManager::loadUserData(User& userData, const std::string& filePath) {
+    if (!RecordFormat::readUserFile(userData, filePath, lastLoadErrors)) {
         return false;
     }
 
-    // 保存用户名
-    file << "USER:" << userData.getName() << "\n";
-    
-    // 保存课程
-    file << "COURSES:\n";
-    for (const auto& event : userData.getCourses().getAllEvents()) {
-        auto startTime = std::chrono::system_clock::to_time_t(event.getTimeSlot().getStartTime());
-        auto endTime = std::chrono::system_clock::to_time_t(event.getTimeSlot().getEndTime());
-        
-        file << event.getId() << ","
-             << event.getEventName() << ","
-             << event.getLocation() << ","
-             << event.getDescription() << ","
-             << event.getWeekday() << ","
-             << startTime << ","
-             << endTime << ","
-             << event.getTimeSlot().getIsCourse() << "\n";
+    if (&userData == &user) {
+        history.clear();
+        reindexUserEvents();
+        queueReset();
+        notifyIfIdle();
     }
-    
-    // 保存个人日程
-    file << "PERSONAL:\n";
-    for (const auto& event : userData.getPersonalSchedule().getAllEvents()) {
-        auto startTime = std::chrono::system_clock::to_time_t(event.getTimeSlot().getStartTime());
-        auto endTime = std::chrono::system_clock::to_time_t(event.getTimeSlot().getEndTime());
-        
-        file << event.getId() << ","
-             << event.getEventName() << ","
-             << event.getLocation() << ","
-             << event.getDescription() << ","
-             << event.getWeekday() << ","
-             << startTime << ","
-             << endTime << ","
-             << event.getTimeSlot().getIsCourse() << "\n";
+    return true;
+}
+
+User& DataManager::getUser() {
+    return user;
+}
+
+const User& DataManager::getUser() const {
+    return user;
+}
+
+std::shared_ptr<const User> DataManager::getUserSnapshot() const {
+    return user.snapshot();
+}
+
+bool DataManager::openUserStore(const std::string& directory) {
+    currentUserId.clear();
+    return userStore.open(directory);
+}
+
+UserStore& DataManager::getUserStore() {
+    return userStore;
+}
+
+const std::string& DataManager::getCurrentUserId() const {
+    return currentUserId;
+}
+
+bool DataManager::switchUser(const std::string& userId) {
+    if (!userStore.contains(userId)) {
+        return false;
+    }
+    if (!currentUserId.empty() && currentUserId != userId) {
+        userStore.storeUser(currentUserId, user);
     }
 
-    file.close();
+    std::shared_ptr<User> loaded = userStore.getUser(userId);
+    if (!loaded) {
+        return false;
+    }
+    lastLoadErrors = userStore.getLastLoadErrors();
+
+    user = *loaded;
+    currentUserId = userId;
+    history.clear();
+    reindexUserEvents();
+    queueReset();
+    notifyIfIdle();
     return true;
 }
 
-bool DataManager::loadUserData(User& userData, const std::string& filePath) {
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
+bool DataManager::reloadCurrentUser() {
+    if (currentUserId.empty()) {
         return false;
     }
+    userStore.discard(currentUserId);
 
-    //加载前清空，避免重复累计
-    userData.getCourses().clear();
-    userData.getPersonalSchedule().clear();
-    std::string line;
-    std::string section;
-    
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-        
-        if (line.substr(0, 5) == "USER:") {
-            userData.setName(line.substr(5));
-        } else if (line == "COURSES:") {
-            section = "COURSES";
-        } else if (line == "PERSONAL:") {
-            section = "PERSONAL";
-        } else {
-            // 解析事件
-            std::istringstream iss(line);
-            std::string id, name, location, description, weekday, startTime, endTime, isCourse;
-            
-            std::getline(iss, id, ',');
-            std::getline(iss, name, ',');
-            std::getline(iss, location, ',');
-            std::getline(iss, description, ',');
-            std::getline(iss, weekday, ',');
-            std::getline(iss, startTime, ',');
-            std::getline(iss, endTime, ',');
-            std::getline(iss, isCourse, ',');
-            
-            if (!id.empty()) {
-                std::time_t start_t = std::stoll(startTime);
-                std::time_t end_t = std::stoll(endTime);
-                
-                TimeSlot slot(std::chrono::system_clock::from_time_t(start_t),
-                            std::chrono::system_clock::from_time_t(end_t),
-                            isCourse == "1");
-                
-                ScheduleEvent event(std::stoi(id), name, location, description,
-                                  std::stoi(weekday), slot);
-                
-                if (section == "COURSES") {
-                    userData.getCourses().addEvent(event);
-                } else if (section == "PERSONAL") {
-                    userData.getPersonalSchedule().addEvent(event);
-                }
+    std::shared_ptr<User> loaded = userStore.getUser(currentUserId);
+    if (!loaded) {
+        return false;
+    }
+    lastLoadErrors = userStore.getLastLoadErrors();
+    user = *loaded;
+    history.clear();
+    reindexUserEvents();
+    queueReset();
+    notifyIfIdle();
+    return true;
+}
+
+bool DataManager::saveCurrentUser() {
+    if (currentUserId.empty()) {
+        return false;
+    }
+    return userStore.storeUser(currentUserId, user);
+}
+
+bool DataManager::addUserEvent(const ScheduleEvent& event, std::string& errorMsg) {
+    if (event.getTimeSlot().getIsCourse()) {
+        return addCourse(event, errorMsg);
+    }
+    return addPersonalEvent(event, errorMsg);
+}
+
+bool DataManager::addCourse(const ScheduleEvent& event, std::string& errorMsg) {
+    if (!user.getCourses().addEventSafely(event, errorMsg)) {
+        return false;
+    }
+    indexUserEvent(event);
+    history.record("添加课程", EventEdit{EventEdit::Kind::Insert, true, event});
+    queueChange(EventChange::Kind::Inserted, true, event);
+    notifyIfIdle();
+    return true;
+}
+
+bool DataManager::addPersonalEvent(const ScheduleEvent& event, std::string& errorMsg) {
+    if (!user.getPersonalSchedule().addEventSafely(event, errorMsg)) {
+        return false;
+    }
+    indexUserEvent(event);
+    history.record("添加日程", EventEdit{EventEdit::Kind::Insert, false, event});
+    queueChange(EventChange::Kind::Inserted, false, event);
+    notifyIfIdle();
+    return true;
+}
+
+bool DataManager::removeUserEvent(int eventId) {
+    // 先取出被删除的事件，撤销时原样恢复
+    for (bool course : {true, false}) {
+        const Schedule& schedule = course ? user.getCourses() : user.getPersonalSchedule();
+        for (const auto& event : schedule.getAllEvents()) {
+            if (event.getId() != eventId) {
+                continue;
             }
+            EventEdit edit{EventEdit::Kind::Remove, course, event};
+            removeEventsUnrecorded(course, {&edit.event});
+            history.record("删除事件", std::move(edit));
+            notifyIfIdle();
+            return true;
         }
     }
+    return false;
+}
 
-    file.close();
+bool DataManager::updateUserEvent(const ScheduleEvent& event, std::string& errorMsg) {
+    const ScheduleEvent* found = nullptr;
+    bool oldCourse = true;
+    for (bool course : {true, false}) {
+        const Schedule& schedule = course ? user.getCourses() : user.getPersonalSchedule();
+        for (const auto& existing : schedule.getAllEvents()) {
+            if (existing.getId() == event.getId()) {
+                found = &existing;
+                oldCourse = course;
+                break;
+            }
+        }
+        if (found) {
+            break;
+        }
+    }
+    if (!found) {
+        errorMsg = "未找到指定事件";
+        return false;
+    }
+    ScheduleEvent previous = *found;
+
+    // 拷贝日程只是共享事件表，冲突时直接换回
+    bool newCourse = event.getTimeSlot().getIsCourse();
+    Schedule& source = oldCourse ? user.getCourses() : user.getPersonalSchedule();
+    Schedule& target = newCourse ? user.getCourses() : user.getPersonalSchedule();
+    Schedule sourceBackup = source;
+    Schedule targetBackup = target;
+    source.removeEvent(event.getId());
+    if (!target.addEventSafely(event, errorMsg)) {
+        source = sourceBackup;
+        target = targetBackup;
+        return false;
+    }
+
+    searchIndex.removeEvent(previous.getId());
+    tagIndex.remove(static_cast<std::uint32_t>(previous.getId()));
+    timeIndex.remove(static_cast<std::uint32_t>(previous.getId()));
+    roomCalendar.release(userRoomOwner(previous.getId()));
+    indexUserEvent(event);
+
+    history.beginGroup("修改事件");
+    history.record("修改事件", EventEdit{EventEdit::Kind::Remove, oldCourse, previous});
+    history.record("修改事件", EventEdit{EventEdit::Kind::Insert, newCourse, event});
+    history.endGroup();
+
+    queueChange(EventChange::Kind::Modified, newCourse, event, &previous);
+    notifyIfIdle();
     return true;
 }
 
-User& DataManager::getUser() {
-    return user;
+const ScheduleEvent* DataManager::findUserEvent(int eventId) const {
+    for (const Schedule* schedule : {&user.getCourses(), &user.getPersonalSchedule()}) {
+        for (const auto& existing : schedule->getAllEvents()) {
+            if (existing.getId() == eventId) {
+                return &existing;
+            }
+        }
+    }
+    return nullptr;
 }
 
-const User& DataManager::getUser() const {
-    return user;
+std::vector<int> DataManager::findConflicts(const ScheduleEvent& candidate) const {
+    // 与 updateUserEvent 一样只查目标日程，并使用 addEventSafely 的同一判断，预览与落下的结果一致
+    const Schedule& target = candidate.getTimeSlot().getIsCourse() ? user.getCourses()
+                                                                   : user.getPersonalSchedule();
+    std::vector<int> conflicts = target.findConflicts(candidate, candidate.getId());
+    std::sort(conflicts.begin(), conflicts.end());
+    return conflicts;
+}
+
+void DataManager::beginEdit(const std::string& label) {
+    history.beginGroup(label);
+}
+
+void DataManager::endEdit() {
+    history.endGroup();
+    notifyIfIdle();
+}
+
+bool DataManager::undo() {
+    const EditHistory::Step* step = history.takeUndo();
+    if (!step) {
+        return false;
+    }
+    applyEdits(step->edits, true);
+    notifyIfIdle();
+    return true;
+}
+
+bool DataManager::redo() {
+    const EditHistory::Step* step = history.takeRedo();
+    if (!step) {
+        return false;
+    }
+    applyEdits(step->edits, false);
+    notifyIfIdle();
+    return true;
+}
+
+bool DataManager::canUndo() const {
+    return history.canUndo() && !history.isGrouping();
+}
+
+bool DataManager::canRedo() const {
+    return history.canRedo() && !history.isGrouping();
+}
+
+const std::string& DataManager::getUndoLabel() const {
+    return history.getUndoLabel();
+}
+
+const std::string& DataManager::getRedoLabel() const {
+    return history.getRedoLabel();
+}
+
+void DataManager::clearHistory() {
+    history.clear();
+}
+
+int DataManager::subscribe(ChangeListener listener) {
+    int listenerId = nextListenerId++;
+    listeners.emplace_back(listenerId, std::move(listener));
+    return listenerId;
+}
+
+void DataManager::unsubscribe(int listenerId) {
+    for (auto it = listeners.begin(); it != listeners.end(); ++it) {
+        if (it->first == listenerId) {
+            listeners.erase(it);
+            return;
+        }
+    }
+}
+
+void DataManager::flushChanges() {
+    if (pendingChanges.empty()) {
+        return;
+    }
+    // 先取出再通知，订阅者在回调中再修改数据时产生的是下一批变化
+    ChangeSet changes = std::move(pendingChanges);
+    pendingChanges = ChangeSet();
+    auto current = listeners;
+    for (const auto& entry : current) {
+        entry.second(changes);
+    }
+}
+
+void DataManager::queueChange(EventChange::Kind kind, bool course, const ScheduleEvent& event,
+                              const ScheduleEvent* previous) {
+    if (pendingChanges.reset) {
+        // 订阅者反正要整体重建，不必再逐条记录
+        return;
+    }
+    EventChange change{kind, course, event, previous ? *previous : ScheduleEvent()};
+    pendingChanges.changes.push_back(std::move(change));
+}
+
+void DataManager::queueReset() {
+    pendingChanges.reset = true;
+    pendingChanges.changes.clear();
+}
+
+void DataManager::notifyIfIdle() {
+    if (!history.isGrouping()) {
+        flushChanges();
+    }
+}
+
+void DataManager::insertEventUnrecorded(const EventEdit& edit) {
+    // 撤销/重做时原样放回，不再做冲突检查
+    Schedule& schedule = edit.course ? user.getCourses() : user.getPersonalSchedule();
+    schedule.addEvent(edit.event);
+    indexUserEvent(edit.event);
+    queueChange(EventChange::Kind::Inserted, edit.course, edit.event);
+}
+
+void DataManager::removeEventsUnrecorded(bool course, const std::vector<const ScheduleEvent*>& removed) {
+    std::vector<int> eventIds;
+    eventIds.reserve(removed.size());
+    for (const ScheduleEvent* event : removed) {
+        eventIds.push_back(event->getId());
+    }
+
+    Schedule& schedule = course ? user.getCourses() : user.getPersonalSchedule();
+    schedule.removeEvents(eventIds);
+    for (const ScheduleEvent* event : removed) {
+        int eventId = event->getId();
+        searchIndex.removeEvent(eventId);
+        tagIndex.remove(static_cast<std::uint32_t>(eventId));
+        timeIndex.remove(static_cast<std::uint32_t>(eventId));
+        roomCalendar.release(userRoomOwner(eventId));
+        queueChange(EventChange::Kind::Removed, course, *event);
+    }
+}
+
+void DataManager::applyEdits(const std::vector<EventEdit>& edits, bool undoing) {
+    // 撤销时逆序执行逆操作；连续的删除攒成一批，整张表只遍历一次
+    std::vector<const ScheduleEvent*> pendingRemovals;
+    bool pendingCourse = true;
+    auto flushRemovals = [&]() {
+        if (!pendingRemovals.empty()) {
+            removeEventsUnrecorded(pendingCourse, pendingRemovals);
+            pendingRemovals.clear();
+        }
+    };
+
+    std::size_t count = edits.size();
+    for (std::size_t i = 0; i < count; ++i) {
+        const EventEdit& edit = edits[undoing ? count - 1 - i : i];
+        bool inserting = (edit.kind == EventEdit::Kind::Insert) != undoing;
+        if (inserting) {
+            flushRemovals();
+            insertEventUnrecorded(edit);
+            continue;
+        }
+        if (!pendingRemovals.empty() && pendingCourse != edit.course) {
+            flushRemovals();
+        }
+        pendingCourse = edit.course;
+        pendingRemovals.push_back(&edit.event);
+    }
+    flushRemovals();
+}
+
+const SearchIndex& DataManager::getSearchIndex() const {
+    return searchIndex;
+}
+
+const TagIndex& DataManager::getTagIndex() const {
+    return tagIndex;
+}
+
+const EventTimeIndex& DataManager::getTimeIndex() const {
+    return timeIndex;
+}
+
+const RoomCalendar& DataManager::getRoomCalendar() const {
+    return roomCalendar;
+}
+
+std::pair<std::uint64_t, std::uint64_t> DataManager::getProfessorRoomOwners(ProfessorHandle handle) const {
+    return std::make_pair(professorRoomOwner(handle, 0), professorRoomOwner(handle + 1, 0) - 1);
+}
+
+void DataManager::indexProfessorRooms(ProfessorHandle handle) {
+    std::pair<std::uint64_t, std::uint64_t> owners = getProfessorRoomOwners(handle);
+    roomCalendar.releaseRange(owners.first, owners.second);
+    const auto& officeHours = professors[handle].getOfficeHours().getAllEvents();
+    for (std::size_t i = 0; i < officeHours.size(); ++i) {
+        TimeSlot slot = officeHours[i].getTimeSlot();
+        roomCalendar.occupy(professorRoomOwner(handle, i), officeHours[i].getLocation(),
+                            std::chrono::system_clock::to_time_t(slot.getStartTime()),
+                            std::chrono::system_clock::to_time_t(slot.getEndTime()),
+                            slot.getIsCourse());
+    }
+}
+
+CompressedBitmap DataManager::filterEvents(unsigned int requiredTags, unsigned int anyTags,
+                                           std::time_t from, std::time_t to) const {
+    CompressedBitmap result = tagIndex.matchAll(requiredTags);
+    if (anyTags != 0) {
+        result = CompressedBitmap::intersect(result, tagIndex.matchAny(anyTags));
+    }
+    if (from < to && !result.isEmpty()) {
+        result = CompressedBitmap::intersect(result, timeIndex.overlapping(from, to));
+    }
+    return result;
+}
+
+void DataManager::indexUserEvent(const ScheduleEvent& event) {
+    std::uint32_t id = static_cast<std::uint32_t>(event.getId());
+    TimeSlot slot = event.getTimeSlot();
+    searchIndex.addEvent(event);
+    tagIndex.insert(id, event.getTags());
+    timeIndex.insert(id,
+                     std::chrono::system_clock::to_time_t(slot.getStartTime()),
+                     std::chrono::system_clock::to_time_t(slot.getEndTime()),
+                     slot.getIsCourse());
+    roomCalendar.occupy(userRoomOwner(event.getId()), event.getLocation(),
+                        std::chrono::system_clock::to_time_t(slot.getStartTime()),
+                        std::chrono::system_clock::to_time_t(slot.getEndTime()),
+                        slot.getIsCourse());
+}
+
+void DataManager::reindexUserEvents() {
+    searchIndex.clearEvents();
+    tagIndex.clear();
+    timeIndex.clear();
+    roomCalendar.releaseRange(userRoomOwner(0), professorRoomOwner(0, 0) - 1);
+    for (const auto& event : user.getCourses().getAllEvents()) {
+        indexUserEvent(event);
+    }
+    for (const auto& event : user.getPersonalSchedule().getAllEvents()) {
+        indexUserEvent(event);
+    }
 }
 
 bool DataManager::loadProfessorsData(const std::string& filePath) {
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
+    MappedFile file;
+    if (!file.open(filePath)) {
         return false;
     }
 
     professors.clear();
-    std::string line;
-    Professor* currentProf = nullptr;
+    professorByName.clear();
+    professorByEmail.clear();
+    professorHashes.clear();
+    professorRevisions.clear();
+    searchIndex.clearProfessors();
+    roomCalendar.releaseRange(professorRoomOwner(0, 0), ~std::uint64_t(0));
+    lastLoadErrors.clear();
+
+    RecordReader reader(file.data());
+    std::vector<CsvField> fields;
+    std::string errorMsg;
+    ProfessorHandle currentProf = invalidProfessor;
     
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
+    while (reader.next(fields)) {
+        std::string head = fields[0].toString();
         
-        if (line.substr(0, 10) == "PROFESSOR:") {
-            std::string profInfo = line.substr(10);
-            std::istringstream iss(profInfo);
-            std::string name, email;
-            
-            std::getline(iss, name, ',');
-            std::getline(iss, email, ',');
-            
-            professors.push_back(Professor(name, email));
-            currentProf = &professors.back();
-        } else if (currentProf != nullptr) {
+        if (head.compare(0, 10, "PROFESSOR:") == 0) {
+            std::string email = fields.size() > 1 ? fields[1].toString() : std::string();
+            currentProf = upsertProfessor(Professor(head.substr(10), email));
+        } else if (currentProf != invalidProfessor) {
             // 解析办公时间
-            std::istringstream iss(line);
-            std::string id, name, location, description, weekday, startTime, endTime, isCourse;
-            
-            std::getline(iss, id, ',');
-            std::getline(iss, name, ',');
-            std::getline(iss, location, ',');
-            std::getline(iss, description, ',');
-            std::getline(iss, weekday, ',');
-            std::getline(iss, startTime, ',');
-            std::getline(iss, endTime, ',');
-            std::getline(iss, isCourse, ',');
-            
-            if (!id.empty()) {
-                std::time_t start_t = std::stoll(startTime);
-                std::time_t end_t = std::stoll(endTime);
-                
-                TimeSlot slot(std::chrono::system_clock::from_time_t(start_t),
-                            std::chrono::system_clock::from_time_t(end_t),
-                            isCourse == "1");
-                
-                ScheduleEvent event(std::stoi(id), name, location, description,
-                                  std::stoi(weekday), slot);
-                
-                currentProf->getOfficeHours().addEvent(event);
+            ScheduleEvent event;
+            if (!RecordFormat::parseEventRecord(fields, event, errorMsg)) {
+                if (!errorMsg.empty()) {
+                    lastLoadErrors.push_back({reader.lineNumber(), errorMsg});
+                }
+                continue;
             }
+            professors[currentProf].getOfficeHours().addEvent(event);
         }
     }
 
-    file.close();
+    // 办公时间是逐行追加的，加载完成后统一计算哈希
+    for (ProfessorHandle i = 0; i < professors.size(); ++i) {
+        professorHashes[i] = ContentHash::hashProfessor(professors[i]);
+        indexProfessorRooms(i);
+    }
+    professorsDirty = false;
+
     return true;
 }
 
@@ -179,37 +513,124 @@ const std::vector<Professor>& DataManager::getProfessors() const {
     return professors;
 }
 
-Professor DataManager::getProfessorByName(const std::string& name) const {
-    for (const auto& prof : professors) {
-        if (prof.getName() == name) {
-            return prof;
+const Professor* DataManager::getProfessorByName(const std::string& name) const {
+    ProfessorHandle handle = findProfessorByName(name);
+    return handle == invalidProfessor ? nullptr : &professors[handle];
+}
+
+DataManager::ProfessorHandle DataManager::findProfessorByName(const std::string& name) const {
+    auto it = professorByName.find(name);
+    return it == professorByName.end() ? invalidProfessor : it->second;
+}
+
+DataManager::ProfessorHandle DataManager::findProfessorByEmail(const std::string& email) const {
+    auto it = professorByEmail.find(email);
+    return it == professorByEmail.end() ? invalidProfessor : it->second;
+}
+
+const Professor& DataManager::getProfessor(ProfessorHandle handle) const {
+    return professors[handle];
+}
+
+std::uint64_t DataManager::getProfessorHash(ProfessorHandle handle) const {
+    return professorHashes[handle];
+}
+
+std::uint64_t DataManager::getProfessorRevision(ProfessorHandle handle) const {
+    return professorRevisions[handle];
+}
+
+DataManager::ProfessorHandle DataManager::upsertProfessor(Professor prof) {
+    std::uint64_t contentHash = ContentHash::hashProfessor(prof);
+    bool changed = false;
+    return upsertProfessor(std::move(prof), contentHash, changed);
+}
+
+DataManager::ProfessorHandle DataManager::upsertProfessor(Professor prof, std::uint64_t contentHash,
+                                                          bool& changed) {
+    auto inserted = professorByName.emplace(prof.getName(), professors.size());
+    ProfessorHandle handle = inserted.first->second;
+
+    if (inserted.second) {
+        professors.push_back(std::move(prof));
+        professorHashes.push_back(contentHash);
+        professorRevisions.push_back(++revisionCounter);
+        indexProfessorEmail(std::string(), handle);
+        searchIndex.addProfessor(handle, professors[handle]);
+        indexProfessorRooms(handle);
+        changed = true;
+    } else if (professorHashes[handle] == contentHash) {
+        // 内容未变，保留原对象，依赖它的缓存继续有效
+        changed = false;
+    } else {
+        std::string oldEmail = professors[handle].getEmail();
+        professors[handle] = std::move(prof);
+        professorHashes[handle] = contentHash;
+        professorRevisions[handle] = ++revisionCounter;
+        indexProfessorEmail(oldEmail, handle);
+        searchIndex.addProfessor(handle, professors[handle]);
+        indexProfessorRooms(handle);
+        changed = true;
+    }
+
+    professorsDirty = professorsDirty || changed;
+    return handle;
+}
+
+std::size_t DataManager::upsertProfessors(std::vector<Professor> profs) {
+    professors.reserve(professors.size() + profs.size());
+    professorByName.reserve(professors.size() + profs.size());
+
+    std::size_t changedCount = 0;
+    for (auto& prof : profs) {
+        std::uint64_t contentHash = ContentHash::hashProfessor(prof);
+        bool changed = false;
+        upsertProfessor(std::move(prof), contentHash, changed);
+        if (changed) {
+            changedCount++;
         }
     }
-    return Professor();
+    return changedCount;
+}
+
+bool DataManager::isProfessorDataDirty() const {
+    return professorsDirty;
+}
+
+void DataManager::indexProfessorEmail(const std::string& oldEmail, ProfessorHandle handle) {
+    std::string email = professors[handle].getEmail();
+
+    // 邮箱变化时移除旧映射（仅当旧映射仍指向该教师）
+    if (!oldEmail.empty() && oldEmail != email) {
+        auto it = professorByEmail.find(oldEmail);
+        if (it != professorByEmail.end() && it->second == handle) {
+            professorByEmail.erase(it);
+        }
+    }
+    if (!email.empty()) {
+        professorByEmail[email] = handle;
+    }
+}
+
+const std::vector<LineError>& DataManager::getLastLoadErrors() const {
+    return lastLoadErrors;
 }
 
 bool DataManager::saveProfessorsData(const std::vector<Professor>& profs,
                                     const std::string& filePath) {
-    std::ofstream file(filePath);
+    std::ofstream file(filePath, std::ios::binary);
     if (!file.is_open()) {
         return false;
     }
 
     for (const auto& prof : profs) {
-        file << "PROFESSOR:" << prof.getName() << "," << prof.getEmail() << "\n";
+        RecordFormat::writeField(file, "PROFESSOR:" + prof.getName());
+        file << ",";
+        RecordFormat::writeField(file, prof.getEmail());
+        file << "\n";
         
         for (const auto& event : prof.getOfficeHours().getAllEvents()) {
-            auto startTime = std::chrono::system_clock::to_time_t(event.getTimeSlot().getStartTime());
-            auto endTime = std::chrono::system_clock::to_time_t(event.getTimeSlot().getEndTime());
-            
-            file << event.getId() << ","
-                 << event.getEventName() << ","
-                 << event.getLocation() << ","
-                 << event.getDescription() << ","
-                 << event.getWeekday() << ","
-                 << startTime << ","
-                 << endTime << ","
-                 << event.getTimeSlot().getIsCourse() << "\n";
+            RecordFormat::writeEventRecord(file, event);
         }
     }
 
@@ -217,3 +638,13 @@ bool DataManager::saveProfessorsData(const std::vector<Professor>& profs,
     return true;
 }
 
+bool DataManager::saveProfessorsIfChanged(const std::string& filePath) {
+    if (!professorsDirty) {
+        return true;
+    }
+    if (!saveProfessorsData(professors, filePath)) {
+        return false;
+    }
+    professorsDirty = false;
+    return true;
+}
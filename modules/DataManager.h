@@ -3,13 +3,74 @@
 
 #include "../datastructure/User.h"
 #include "../datastructure/Professor.h"
+#include "LineTokenizer.h"
+#include "SearchIndex.h"
+#include "TagIndex.h"
+#include "EventTimeIndex.h"
+#include "RoomCalendar.h"
+#include "UserStore.h"
+#include "EditHistory.h"
+#include "ScheduleChange.h"
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <unordered_map>
+#include <memory>
 #include <vector>
 #include <string>
+#include <utility>
 
 class DataManager {
+public:
+    // 教师句柄：教师在列表中的下标，教师只增不删，因此句柄一直有效
+    using ProfessorHandle = std::size_t;
+    static constexpr ProfessorHandle invalidProfessor = static_cast<ProfessorHandle>(-1);
+
 private:
-    User user;
+    User user;                          // 当前用户，索引只针对当前用户
+    UserStore userStore;
+    std::string currentUserId;
     std::vector<Professor> professors;
+    std::vector<LineError> lastLoadErrors;
+
+    // 姓名/邮箱 -> 教师下标，保持与 professors 同步
+    std::unordered_map<std::string, ProfessorHandle> professorByName;
+    std::unordered_map<std::string, ProfessorHandle> professorByEmail;
+
+    // 与 professors 一一对应：内容哈希和修订号（内容变化时递增）
+    std::vector<std::uint64_t> professorHashes;
+    std::vector<std::uint64_t> professorRevisions;
+    std::uint64_t revisionCounter;      // 全局递增，重新加载后修订号也不会重复
+    bool professorsDirty;
+
+    // 事件和教师的全文索引、标签索引、时间索引，随下面的修改接口同步更新
+    SearchIndex searchIndex;
+    TagIndex tagIndex;
+    EventTimeIndex timeIndex;
+    void indexUserEvent(const ScheduleEvent& event);
+    void reindexUserEvents();
+
+    // 房间占用：来自学生事件和教师办公时间的地点，同样随修改接口同步更新
+    RoomCalendar roomCalendar;
+    void indexProfessorRooms(ProfessorHandle handle);
+
+    // 学生日程的撤销/重做历史，切换或重新加载用户时清空
+    EditHistory history;
+    void insertEventUnrecorded(const EventEdit& edit);
+    void removeEventsUnrecorded(bool course, const std::vector<const ScheduleEvent*>& removed);
+    void applyEdits(const std::vector<EventEdit>& edits, bool undoing);
+
+    // 变化通知：修改先进入 pendingChanges，一次操作（或一个编辑分组）结束时统一发出
+    std::vector<std::pair<int, std::function<void(const ChangeSet&)>>> listeners;
+    int nextListenerId;
+    ChangeSet pendingChanges;
+    void queueChange(EventChange::Kind kind, bool course, const ScheduleEvent& event,
+                     const ScheduleEvent* previous = nullptr);
+    void queueReset();
+    void notifyIfIdle();
+
+    void indexProfessorEmail(const std::string& oldEmail, ProfessorHandle handle);
 
 public:
     DataManager();
@@ -21,20 +82,122 @@ public:
     bool loadUserData(User& userData, const std::string& filePath);
     
     // 获取用户对象
+    // 直接修改日程不会更新搜索索引，应使用下面的事件修改接口
     User& getUser();
     const User& getUser() const;
     
+    // 当前用户的不可变快照（O(1)），供后台线程只读使用；须在 GUI 线程调用
+    std::shared_ptr<const User> getUserSnapshot() const;
+    
+    // 多用户存储：每个学生一个文件，只在切换或保存时读写对应学生的文件
+    bool openUserStore(const std::string& directory);
+    UserStore& getUserStore();
+    const std::string& getCurrentUserId() const;
+    
+    // 切换当前用户：先写回当前用户，再加载目标用户并重建索引
+    bool switchUser(const std::string& userId);
+    
+    // 放弃内存中的修改，从文件重新加载当前用户
+    bool reloadCurrentUser();
+    
+    // 写回当前用户（只写该用户的文件）
+    bool saveCurrentUser();
+    
+    // 添加事件（检查冲突和重复）：课程加入课程表，其余加入个人日程
+    bool addUserEvent(const ScheduleEvent& event, std::string& errorMsg);
+    bool addCourse(const ScheduleEvent& event, std::string& errorMsg);
+    bool addPersonalEvent(const ScheduleEvent& event, std::string& errorMsg);
+    
+    // 按编号删除课程或个人日程中的事件
+    bool removeUserEvent(int eventId);
+    
+    // 按编号整体替换一个事件（可在课程与个人日程之间移动），与其他事件冲突时不修改
+    bool updateUserEvent(const ScheduleEvent& event, std::string& errorMsg);
+    
+    // 按编号查找课程或个人日程中的事件，不存在时返回 nullptr
+    const ScheduleEvent* findUserEvent(int eventId) const;
+    
+    // 与候选事件时间冲突的事件编号（升序，不含候选事件自身）
+    // 只与同一日程比较，判断与 addEventSafely 相同，拖动预览为红色的位置落下时一定会被拒绝
+    std::vector<int> findConflicts(const ScheduleEvent& candidate) const;
+    
+    // 撤销/重做：上面的添加、删除接口都会记入历史
+    // beginEdit/endEdit 之间的修改（如一次导入）作为一步撤销
+    void beginEdit(const std::string& label);
+    void endEdit();
+    bool undo();
+    bool redo();
+    bool canUndo() const;
+    bool canRedo() const;
+    const std::string& getUndoLabel() const;
+    const std::string& getRedoLabel() const;
+    void clearHistory();
+    
+    // 订阅学生日程的变化，返回的编号用于取消订阅
+    // 单次修改在操作结束时通知；beginEdit/endEdit 分组内的修改在 endEdit 或 flushChanges 时通知
+    using ChangeListener = std::function<void(const ChangeSet&)>;
+    int subscribe(ChangeListener listener);
+    void unsubscribe(int listenerId);
+    
+    // 立即发出已积累的变化（如导入过程中按批次刷新界面）
+    void flushChanges();
+    
+    // 全文搜索索引
+    const SearchIndex& getSearchIndex() const;
+    
+    // 标签与时间索引
+    const TagIndex& getTagIndex() const;
+    const EventTimeIndex& getTimeIndex() const;
+    const RoomCalendar& getRoomCalendar() const;
+
+    // 教师办公时间在房间日历中的占用来源范围 [first, last]，找会面房间时据此忽略教师自己的办公室
+    std::pair<std::uint64_t, std::uint64_t> getProfessorRoomOwners(ProfessorHandle handle) const;
+    
+    // 按标签和时间筛选事件编号：
+    // requiredTags 中的标签必须全部具备，anyTags 中至少具备一个（为 0 时不限）；
+    // from < to 时只保留与 [from, to) 相交的事件（课程按每周重复计算）
+    CompressedBitmap filterEvents(unsigned int requiredTags, unsigned int anyTags,
+                                  std::time_t from = 0, std::time_t to = 0) const;
+    
     // 从文件加载教师数据
     bool loadProfessorsData(const std::string& filePath);
     
     // 获取教师列表
     const std::vector<Professor>& getProfessors() const;
     
-    // 根据姓名获取教师信息
-    Professor getProfessorByName(const std::string& name) const;
+    // 根据姓名获取教师信息，不存在时返回 nullptr
+    const Professor* getProfessorByName(const std::string& name) const;
+    
+    // 按姓名/邮箱查找教师句柄，不存在时返回 invalidProfessor
+    ProfessorHandle findProfessorByName(const std::string& name) const;
+    ProfessorHandle findProfessorByEmail(const std::string& email) const;
+    
+    // 通过句柄访问教师
+    const Professor& getProfessor(ProfessorHandle handle) const;
+    
+    // 教师内容哈希与修订号，修订号只在内容哈希变化时递增，可作为依赖缓存的版本
+    std::uint64_t getProfessorHash(ProfessorHandle handle) const;
+    std::uint64_t getProfessorRevision(ProfessorHandle handle) const;
+    
+    // 按姓名插入或替换教师（同名教师整体替换，包括办公时间），返回其句柄
+    // 内容哈希与已有教师相同时不做替换，changed 为 false
+    ProfessorHandle upsertProfessor(Professor prof);
+    ProfessorHandle upsertProfessor(Professor prof, std::uint64_t contentHash, bool& changed);
+    
+    // 批量插入或替换，返回新增或内容有变化的教师数
+    std::size_t upsertProfessors(std::vector<Professor> profs);
+    
+    // 上次加载/保存之后教师数据是否有变化
+    bool isProfessorDataDirty() const;
+    
+    // 最近一次加载时被跳过的格式错误行
+    const std::vector<LineError>& getLastLoadErrors() const;
     
     // 保存教师信息
     bool saveProfessorsData(const std::vector<Professor>& profs, const std::string& filePath);
+    
+    // 教师数据有变化时才写回文件，没有变化时直接返回 true
+    bool saveProfessorsIfChanged(const std::string& filePath);
 };
 
 #endif // DATAMANAGER_H
@@ -0,0 +1,111 @@
+#include "EditHistory.h"
+#include <utility>
+
+EditHistory::EditHistory(std::size_t maxSteps, std::size_t maxEdits)
+    : groupDepth(0), maxSteps(maxSteps), maxEdits(maxEdits), editCount(0) {
+}
+
+void EditHistory::beginGroup(const std::string& label) {
+    if (groupDepth++ == 0) {
+        pending.label = label;
+        pending.edits.clear();
+    }
+}
+
+void EditHistory::endGroup() {
+    if (groupDepth == 0 || --groupDepth > 0) {
+        return;
+    }
+    if (!pending.edits.empty()) {
+        pushStep(std::move(pending));
+    }
+    pending = Step();
+}
+
+bool EditHistory::isGrouping() const {
+    return groupDepth > 0;
+}
+
+void EditHistory::record(const std::string& label, EventEdit edit) {
+    clearRedo();
+    if (groupDepth > 0) {
+        pending.edits.push_back(std::move(edit));
+        editCount++;
+        return;
+    }
+
+    Step step;
+    step.label = label;
+    step.edits.push_back(std::move(edit));
+    editCount++;
+    pushStep(std::move(step));
+}
+
+bool EditHistory::canUndo() const {
+    return !undoSteps.empty();
+}
+
+bool EditHistory::canRedo() const {
+    return !redoSteps.empty();
+}
+
+const std::string& EditHistory::getUndoLabel() const {
+    static const std::string empty;
+    return undoSteps.empty() ? empty : undoSteps.back().label;
+}
+
+const std::string& EditHistory::getRedoLabel() const {
+    static const std::string empty;
+    return redoSteps.empty() ? empty : redoSteps.back().label;
+}
+
+const EditHistory::Step* EditHistory::takeUndo() {
+    if (undoSteps.empty() || groupDepth > 0) {
+        return nullptr;
+    }
+    redoSteps.push_back(std::move(undoSteps.back()));
+    undoSteps.pop_back();
+    return &redoSteps.back();
+}
+
+const EditHistory::Step* EditHistory::takeRedo() {
+    if (redoSteps.empty() || groupDepth > 0) {
+        return nullptr;
+    }
+    undoSteps.push_back(std::move(redoSteps.back()));
+    redoSteps.pop_back();
+    return &undoSteps.back();
+}
+
+void EditHistory::clear() {
+    undoSteps.clear();
+    redoSteps.clear();
+    pending = Step();
+    groupDepth = 0;
+    editCount = 0;
+}
+
+std::size_t EditHistory::getEditCount() const {
+    return editCount;
+}
+
+void EditHistory::pushStep(Step step) {
+    undoSteps.push_back(std::move(step));
+    trim();
+}
+
+void EditHistory::clearRedo() {
+    for (const auto& step : redoSteps) {
+        editCount -= step.edits.size();
+    }
+    redoSteps.clear();
+}
+
+void EditHistory::trim() {
+    // 至少保留最新的一步，即使它本身超过事件上限
+    while (undoSteps.size() > 1 &&
+           (undoSteps.size() > maxSteps || editCount > maxEdits)) {
+        editCount -= undoSteps.front().edits.size();
+        undoSteps.pop_front();
+    }
+}
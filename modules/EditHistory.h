@@ -0,0 +1,72 @@
+#ifndef EDITHISTORY_H
+#define EDITHISTORY_H
+
+#include "../datastructure/ScheduleEvent.h"
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+
+// 对学生日程的一次修改，只记录被插入或删除的那个事件
+struct EventEdit {
+    enum class Kind {
+        Insert,
+        Remove
+    };
+
+    Kind kind;
+    bool course;            // true 为课程表，false 为个人日程
+    ScheduleEvent event;
+};
+
+// 撤销/重做历史
+// 每一步只保存变化的事件，不保存整份日程，内存与修改量成正比；
+// beginGroup/endGroup 之间的修改合并为一步（如一次导入上千个事件）
+// 新的修改会清空重做栈；步数或事件总数超过上限时丢弃最早的步骤
+class EditHistory {
+public:
+    struct Step {
+        std::string label;
+        std::vector<EventEdit> edits;   // 按执行顺序
+    };
+
+    explicit EditHistory(std::size_t maxSteps = 100, std::size_t maxEdits = 200000);
+
+    // 分组可以嵌套，最外层结束时才形成一步；空分组不产生步骤
+    void beginGroup(const std::string& label);
+    void endGroup();
+    bool isGrouping() const;
+
+    // 记录一次修改；不在分组中时单独成为一步
+    void record(const std::string& label, EventEdit edit);
+
+    bool canUndo() const;
+    bool canRedo() const;
+    const std::string& getUndoLabel() const;
+    const std::string& getRedoLabel() const;
+
+    // 把栈顶的一步移到另一侧并返回，调用方负责执行（撤销时逆序执行其逆操作）
+    // 没有可用步骤时返回 nullptr；返回的指针在下一次修改历史前有效
+    const Step* takeUndo();
+    const Step* takeRedo();
+
+    void clear();
+
+    // 历史中保存的事件总数
+    std::size_t getEditCount() const;
+
+private:
+    std::deque<Step> undoSteps;
+    std::vector<Step> redoSteps;
+    Step pending;
+    int groupDepth;
+    std::size_t maxSteps;
+    std::size_t maxEdits;
+    std::size_t editCount;
+
+    void pushStep(Step step);
+    void clearRedo();
+    void trim();
+};
+
+#endif // EDITHISTORY_H
@@ -0,0 +1,140 @@
+#include "EventTimeIndex.h"
+#include "../datastructure/TimeConvert.h"
+#include <algorithm>
+
+namespace {
+
+const std::time_t SECONDS_PER_WEEK = 7 * 24 * 3600;
+
+// 向下取整的除法（开始时间可能晚于查询起点）
+std::time_t floorDiv(std::time_t a, std::time_t b) {
+    std::time_t q = a / b;
+    if ((a % b != 0) && ((a < 0) != (b < 0))) {
+        q--;
+    }
+    return q;
+}
+
+// 本地墙上时间的秒数，转换失败时退回 UTC 秒数
+std::time_t wallSeconds(std::time_t t) {
+    long long wall;
+    return toLocalWallSeconds(t, wall) ? static_cast<std::time_t>(wall) : t;
+}
+
+// 墙上时间在本周内的相位，从周一零点起算（1970-01-01 是周四）
+std::time_t weekPhase(std::time_t wall) {
+    const std::time_t sinceMonday = wall + 3 * 24 * 3600;
+    return sinceMonday - floorDiv(sinceMonday, SECONDS_PER_WEEK) * SECONDS_PER_WEEK;
+}
+
+} // namespace
+
+EventTimeIndex::EventTimeIndex() : dirty(false) {
+}
+
+void EventTimeIndex::insert(std::uint32_t eventId, std::time_t start, std::time_t end, bool weekly) {
+    intervals[eventId] = {start, end, weekly};
+    dirty = true;
+}
+
+void EventTimeIndex::remove(std::uint32_t eventId) {
+    if (intervals.erase(eventId) > 0) {
+        dirty = true;
+    }
+}
+
+void EventTimeIndex::clear() {
+    intervals.clear();
+    dirty = true;
+}
+
+void EventTimeIndex::rebuild() const {
+    sorted.clear();
+    weeklyEntries.clear();
+    for (const auto& item : intervals) {
+        Entry entry{item.second.start, item.second.end, item.first};
+        if (item.second.weekly) {
+            // 超过一周的重复事件按一周处理
+            // 相位取本地星期和时刻，夏令时前后的发生落在同一相位
+            std::time_t phase = weekPhase(wallSeconds(item.second.start));
+            std::time_t length = std::min(item.second.end - item.second.start, SECONDS_PER_WEEK);
+            weeklyEntries.push_back(Entry{phase, phase + length, item.first});
+        } else {
+            sorted.push_back(entry);
+        }
+    }
+
+    auto byStart = [](const Entry& a, const Entry& b) {
+        return a.start < b.start || (a.start == b.start && a.id < b.id);
+    };
+    auto buildPrefix = [](const std::vector<Entry>& entries, std::vector<std::time_t>& prefix) {
+        prefix.resize(entries.size());
+        std::time_t maxEnd = 0;
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            maxEnd = (i == 0) ? entries[i].end : std::max(maxEnd, entries[i].end);
+            prefix[i] = maxEnd;
+        }
+    };
+    std::sort(sorted.begin(), sorted.end(), byStart);
+    std::sort(weeklyEntries.begin(), weeklyEntries.end(), byStart);
+    buildPrefix(sorted, prefixMaxEnd);
+    buildPrefix(weeklyEntries, weeklyPrefixMaxEnd);
+    dirty = false;
+}
+
+void EventTimeIndex::collect(const std::vector<Entry>& entries, const std::vector<std::time_t>& prefixMaxEnd,
+                             std::time_t from, std::time_t to, std::vector<std::uint32_t>& result) {
+    // 开始时间早于 to 的事件都在 [0, upper) 中
+    auto upper = std::lower_bound(entries.begin(), entries.end(), to,
+                                  [](const Entry& e, std::time_t t) { return e.start < t; });
+    for (std::size_t i = static_cast<std::size_t>(upper - entries.begin()); i > 0; --i) {
+        // 更早的事件都在 from 之前结束
+        if (prefixMaxEnd[i - 1] <= from) {
+            break;
+        }
+        if (entries[i - 1].end > from) {
+            result.push_back(entries[i - 1].id);
+        }
+    }
+}
+
+std::vector<std::uint32_t> EventTimeIndex::overlappingIds(std::time_t from, std::time_t to) const {
+    if (dirty) {
+        rebuild();
+    }
+
+    std::vector<std::uint32_t> result;
+    if (from >= to) {
+        return result;
+    }
+
+    collect(sorted, prefixMaxEnd, from, to, result);
+
+    // 查询区间同样换算到本地墙上时间，跨夏令时切换的区间长度按墙上时间计
+    std::time_t wallFrom = wallSeconds(from);
+    std::time_t wallTo = wallSeconds(to);
+    if ((wallTo - wallFrom) >= SECONDS_PER_WEEK) {
+        // 查询区间覆盖整周，所有重复事件都会出现
+        for (const auto& entry : weeklyEntries) {
+            result.push_back(entry.id);
+        }
+    } else {
+        // 查询区间和事件都换算到相位后，只可能与事件在前一、本、后一周期的发生相交
+        std::time_t phaseFrom = weekPhase(wallFrom);
+        std::time_t phaseTo = phaseFrom + (wallTo - wallFrom);
+        std::size_t before = result.size();
+        collect(weeklyEntries, weeklyPrefixMaxEnd, phaseFrom, phaseTo, result);
+        collect(weeklyEntries, weeklyPrefixMaxEnd, phaseFrom - SECONDS_PER_WEEK, phaseTo - SECONDS_PER_WEEK, result);
+        collect(weeklyEntries, weeklyPrefixMaxEnd, phaseFrom + SECONDS_PER_WEEK, phaseTo + SECONDS_PER_WEEK, result);
+        // 多次查询可能命中同一事件
+        std::sort(result.begin() + before, result.end());
+        result.erase(std::unique(result.begin() + before, result.end()), result.end());
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+CompressedBitmap EventTimeIndex::overlapping(std::time_t from, std::time_t to) const {
+    return CompressedBitmap::fromSorted(overlappingIds(from, to));
+}
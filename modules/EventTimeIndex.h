@@ -0,0 +1,55 @@
+#ifndef EVENTTIMEINDEX_H
+#define EVENTTIMEINDEX_H
+
+#include "CompressedBitmap.h"
+#include <cstdint>
+#include <ctime>
+#include <unordered_map>
+#include <vector>
+
+// 事件时间索引：按开始时间排序，并记录前缀最大结束时间，
+// 区间相交查询只需二分定位再向前扫描到前缀最大结束时间不再覆盖查询起点为止
+// 每周重复的事件（课程）单独存放，按周内相位（开始时间的本地星期和时刻）排序，
+// 查询区间同样换算到本地相位后在相邻三个周期上各做一次同样的查询
+// 修改只更新映射表，排序数组在下次查询时重建
+class EventTimeIndex {
+public:
+    EventTimeIndex();
+
+    void insert(std::uint32_t eventId, std::time_t start, std::time_t end, bool weekly);
+    void remove(std::uint32_t eventId);
+    void clear();
+
+    // 与 [from, to) 相交的事件
+    CompressedBitmap overlapping(std::time_t from, std::time_t to) const;
+
+    // 与 [from, to) 相交的事件编号，升序
+    std::vector<std::uint32_t> overlappingIds(std::time_t from, std::time_t to) const;
+
+private:
+    struct Interval {
+        std::time_t start;
+        std::time_t end;
+        bool weekly;
+    };
+
+    struct Entry {
+        std::time_t start;
+        std::time_t end;
+        std::uint32_t id;
+    };
+
+    std::unordered_map<std::uint32_t, Interval> intervals;
+
+    mutable std::vector<Entry> sorted;
+    mutable std::vector<std::time_t> prefixMaxEnd;
+    mutable std::vector<Entry> weeklyEntries;     // start/end 为周内相位
+    mutable std::vector<std::time_t> weeklyPrefixMaxEnd;
+    mutable bool dirty;
+
+    void rebuild() const;
+    static void collect(const std::vector<Entry>& entries, const std::vector<std::time_t>& prefixMaxEnd,
+                        std::time_t from, std::time_t to, std::vector<std::uint32_t>& result);
+};
+
+#endif // EVENTTIMEINDEX_H
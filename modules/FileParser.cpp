@@ -1,168 +1,360 @@
 #include "FileParser.h"
+#include "ContentHash.h"
+#include "CsvTokenizer.h"
+#include "LineTokenizer.h"
+#include "TimeParser.h"
+#include "MappedFile.h"
+#include "ICalendar.h"
+#include "../datastructure/TimeConvert.h"
 #include <fstream>
-#include <sstream>
 #include <ctime>
-#include <iomanip>
 #include <algorithm>
+#include <future>
+#include <iterator>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 
-Schedule FileParser::parseCsv(const std::string& filePath) {
-    Schedule schedule;
-    std::ifstream file(filePath);
-    
+namespace {
+
+// 每个并行块至少包含的字节数，小文件直接单线程解析
+const std::size_t MIN_CHUNK_BYTES = 256 * 1024;
+
+// 跳过表头（表头也可能含有带引号的换行），返回数据部分
+std::string_view skipHeader(std::string_view content) {
+    CsvTokenizer tokenizer(content);
+    if (!tokenizer.skipRecord()) {
+        return std::string_view();
+    }
+    return content.substr(tokenizer.position());
+}
+
+// 读取 .ics 中与窗口相交的所有发生，逐个转换为事件
+// 重复规则无法正确展开的事件整体跳过，计入 skippedEvents
+template <typename Fn>
+bool forEachIcsOccurrence(const std::string& filePath, std::time_t windowStart, std::time_t windowEnd,
+                          int& skippedEvents, Fn fn) {
+    skippedEvents = 0;
+    std::ifstream file(filePath, std::ios::binary);
     if (!file.is_open()) {
+        return false;
+    }
+
+    ICalendarReader reader(file);
+    ICalEvent icalEvent;
+    while (reader.nextEvent(icalEvent)) {
+        if (!icalEvent.ruleSupported) {
+            skippedEvents++;
+            continue;
+        }
+        std::time_t duration = icalEvent.end - icalEvent.start;
+        RecurrenceIterator occurrences(icalEvent, windowStart, windowEnd);
+        std::time_t start;
+        while (occurrences.next(start)) {
+            // 星期由发生日期决定（周一=1 ... 周日=7）
+            std::tm startTm = {};
+            toLocalTm(start, startTm);
+            int weekday = startTm.tm_wday == 0 ? SUNDAY : startTm.tm_wday;
+
+            TimeSlot slot(std::chrono::system_clock::from_time_t(start),
+                          std::chrono::system_clock::from_time_t(start + duration),
+                          false);
+            fn(ScheduleEvent(0, icalEvent.summary, icalEvent.location,
+                             icalEvent.description, weekday, slot));
+        }
+    }
+    return true;
+}
+
+// 取第 index 个字段，缺失时返回空字段
+const CsvField& fieldAt(const std::vector<CsvField>& fields, std::size_t index) {
+    static const CsvField empty;
+    return index < fields.size() ? fields[index] : empty;
+}
+
+// 去掉未加引号字段首尾的空白后拷贝出来；带引号字段保留原样内容
+std::string trimmedField(const std::vector<CsvField>& fields, std::size_t index) {
+    const CsvField& field = fieldAt(fields, index);
+    if (field.quoted) {
+        return field.toString();
+    }
+    return std::string(LineTokenizer::trim(field.raw));
+}
+
+int resolveThreadCount(int requested, std::size_t bytes) {
+    int count = requested;
+    if (count <= 0) {
+        count = static_cast<int>(std::thread::hardware_concurrency());
+        if (count <= 0) count = 1;
+    }
+    int maxByBytes = static_cast<int>(bytes / MIN_CHUNK_BYTES);
+    return std::max(1, std::min(count, maxByBytes));
+}
+
+// 解析所有块：每块得到一个行结果数组，按块的原始顺序返回
+// 工作线程里抛出的异常会在 get() 时按块顺序重新抛出，与单线程行为一致
+template <typename Row, typename ParseRecord>
+std::vector<std::vector<Row>> parseChunks(std::string_view body, int threadCount, ParseRecord parseRecord) {
+    auto parseOne = [&parseRecord](std::string_view chunk) {
+        std::vector<Row> rows;
+        std::vector<CsvField> fields;
+        CsvTokenizer tokenizer(chunk);
+        while (tokenizer.nextRecord(fields)) {
+            // 跳过空行
+            if (CsvTokenizer::isBlankRecord(fields)) {
+                continue;
+            }
+            Row row;
+            if (parseRecord(fields, row)) {
+                rows.push_back(std::move(row));
+            }
+        }
+        return rows;
+    };
+
+    std::vector<std::vector<Row>> results;
+    int threads = resolveThreadCount(threadCount, body.size());
+    if (threads <= 1) {
+        results.push_back(parseOne(body));
+        return results;
+    }
+
+    std::vector<std::future<std::vector<Row>>> futures;
+    for (std::string_view chunk : CsvTokenizer::splitRecordAligned(body, threads)) {
+        futures.push_back(std::async(std::launch::async, parseOne, chunk));
+    }
+    for (auto& f : futures) {
+        results.push_back(f.get());
+    }
+    return results;
+}
+
+// 按块顺序拼接各块的结果
+template <typename Row>
+std::vector<Row> flatten(std::vector<std::vector<Row>> chunks) {
+    if (chunks.size() == 1) {
+        return std::move(chunks.front());
+    }
+    std::vector<Row> rows;
+    std::size_t total = 0;
+    for (const auto& chunk : chunks) {
+        total += chunk.size();
+    }
+    rows.reserve(total);
+    for (auto& chunk : chunks) {
+        std::move(chunk.begin(), chunk.end(), std::back_inserter(rows));
+    }
+    return rows;
+}
+
+} // namespace
+
+// 字段：name,location,description,weekday,start,end,isCourse
+bool FileParser::parseCourseRecord(const std::vector<CsvField>& fields, ScheduleEvent& event) {
+    const CsvField& nameField = fieldAt(fields, 0);
+    if (nameField.raw.empty()) {
+        return false;
+    }
+
+    int weekday;
+    if (!LineTokenizer::parseInt(fieldAt(fields, 3).raw, weekday)) {
+        return false;
+    }
+
+    // 解析时间（格式为 YYYY-MM-DD HH:MM），无法解析的行跳过
+    std::time_t start_t;
+    std::time_t end_t;
+    if (TimeParser::parseDateTime(fieldAt(fields, 4).raw, start_t) != TimeParseError::None ||
+        TimeParser::parseDateTime(fieldAt(fields, 5).raw, end_t) != TimeParseError::None) {
+        return false;
+    }
+
+    std::string_view isCourseStr = fieldAt(fields, 6).raw;
+    bool isCourse = (isCourseStr == "1" || isCourseStr == "true");
+
+    TimeSlot slot(std::chrono::system_clock::from_time_t(start_t),
+                std::chrono::system_clock::from_time_t(end_t),
+                isCourse);
+
+    event = ScheduleEvent(0, nameField.toString(), fieldAt(fields, 1).toString(),
+                          fieldAt(fields, 2).toString(), weekday, slot);
+    return true;
+}
+
+// 字段：profName,profEmail,eventName,location,description,weekday,start,end
+bool FileParser::parseProfessorRecord(const std::vector<CsvField>& fields, ProfessorRecord& row) {
+    row.profName = trimmedField(fields, 0);
+    row.profEmail = trimmedField(fields, 1);
+    row.hasEvent = false;
+
+    std::string eventName = trimmedField(fields, 2);
+
+    // 添加办公时间
+    if (!eventName.empty()) {
+        std::time_t start_t;
+        std::time_t end_t;
+
+        //如果解析失败或者开始时间比结束时间大，则跳过不插入
+        //时间字段可以是 YYYY-MM-DD HH:MM，也可以是纪元秒
+        if (TimeParser::parse(fieldAt(fields, 6).raw, start_t) != TimeParseError::None ||
+            TimeParser::parse(fieldAt(fields, 7).raw, end_t) != TimeParseError::None) {
+            return true;
+        }
+        if (end_t <= start_t) {
+            return true;
+        }
+
+        int weekday;
+        if (!LineTokenizer::parseInt(fieldAt(fields, 5).raw, weekday)) {
+            return true;
+        }
+
+        TimeSlot slot(std::chrono::system_clock::from_time_t(start_t),
+                      std::chrono::system_clock::from_time_t(end_t),
+                      true);  // 办公时间标记为true
+
+        row.event = ScheduleEvent(0, eventName, trimmedField(fields, 3),
+                                  trimmedField(fields, 4), weekday, slot);
+        row.hasEvent = true;
+    }
+    return true;
+}
+
+std::vector<ScheduleEvent> FileParser::parseCourseRecords(std::string_view text, int threadCount) {
+    return flatten(parseChunks<ScheduleEvent>(text, threadCount, parseCourseRecord));
+}
+
+std::vector<FileParser::ProfessorRecord> FileParser::parseProfessorRecords(std::string_view text,
+                                                                           int threadCount) {
+    return flatten(parseChunks<ProfessorRecord>(text, threadCount, parseProfessorRecord));
+}
+
+Schedule FileParser::parseCsv(const std::string& filePath, int threadCount) {
+    Schedule schedule;
+    MappedFile file;
+
+    // 字段直接引用映射内存，只在构造 ScheduleEvent 时拷贝一次
+    if (!file.open(filePath)) {
         return schedule;
     }
 
-    std::string line;
-    // 跳过表头
-    std::getline(file, line);
-    
+    auto chunks = parseChunks<ScheduleEvent>(skipHeader(file.data()), threadCount, parseCourseRecord);
+
+    // 按块顺序合并，编号与单线程解析保持一致
     int eventId = 1;
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-        
-        std::istringstream iss(line);
-        std::string name, location, description, weekdayStr, startTimeStr, endTimeStr, isCourseStr;
-        
-        std::getline(iss, name, ',');
-        std::getline(iss, location, ',');
-        std::getline(iss, description, ',');
-        std::getline(iss, weekdayStr, ',');
-        std::getline(iss, startTimeStr, ',');
-        std::getline(iss, endTimeStr, ',');
-        std::getline(iss, isCourseStr, ',');
-        
-        if (!name.empty()) {
-            // 解析时间（假设格式为 YYYY-MM-DD HH:MM）
-            std::tm start_tm = {};
-            std::tm end_tm = {};
-            
-            std::istringstream start_ss(startTimeStr);
-            start_ss >> std::get_time(&start_tm, "%Y-%m-%d %H:%M");
-            
-            std::istringstream end_ss(endTimeStr);
-            end_ss >> std::get_time(&end_tm, "%Y-%m-%d %H:%M");
-            
-            std::time_t start_t = std::mktime(&start_tm);
-            std::time_t end_t = std::mktime(&end_tm);
-            
-            bool isCourse = (isCourseStr == "1" || isCourseStr == "true");
-            
-            TimeSlot slot(std::chrono::system_clock::from_time_t(start_t),
-                        std::chrono::system_clock::from_time_t(end_t),
-                        isCourse);
-            
-            int weekday = std::stoi(weekdayStr);
-            ScheduleEvent event(eventId++, name, location, description, weekday, slot);
-            
+    for (auto& rows : chunks) {
+        for (auto& event : rows) {
+            event.setId(eventId++);
             schedule.addEvent(event);
         }
     }
 
-    file.close();
     return schedule;
 }
 
-std::vector<Professor> FileParser::parseProfessorsCsv(const std::string& filePath) {
+std::vector<Professor> FileParser::parseProfessorsCsv(const std::string& filePath, int threadCount) {
+    std::vector<std::uint64_t> contentHashes;
+    return parseProfessorsCsv(filePath, contentHashes, threadCount);
+}
+
+std::vector<Professor> FileParser::parseProfessorsCsv(const std::string& filePath,
+                                                      std::vector<std::uint64_t>& contentHashes,
+                                                      int threadCount) {
     std::vector<Professor> professors;
-    std::ifstream file(filePath);
+    MappedFile file;
+    contentHashes.clear();
 
-    if (!file.is_open()) {
+    if (!file.open(filePath)) {
         return professors;
     }
 
-    std::string line;
-    // 跳过表头
-    std::getline(file, line);
+    auto chunks = parseChunks<ProfessorRecord>(skipHeader(file.data()), threadCount, parseProfessorRecord);
 
-    std::string currentProfName;
-    std::string currentProfEmail;
-    Professor* currentProf = nullptr;
+    // 按块顺序合并：同名教师按首次出现的位置归并，编号依次分配
+    std::unordered_map<std::string, std::size_t> indexByName;
+    const std::size_t none = static_cast<std::size_t>(-1);
+    std::size_t current = none;
     int eventId = 1;
 
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-
-        std::istringstream iss(line);
-        std::string profName, profEmail, eventName, location, description, weekdayStr, startTimeStr, endTimeStr;
-
-        std::getline(iss, profName, ',');
-        std::getline(iss, profEmail, ',');
-        std::getline(iss, eventName, ',');
-        std::getline(iss, location, ',');
-        std::getline(iss, description, ',');
-        std::getline(iss, weekdayStr, ',');
-        std::getline(iss, startTimeStr, ',');
-        std::getline(iss, endTimeStr, ',');
-
-
-        //删除多余的空格
-        auto trim = [](std::string& s) {
-            auto not_space = [](unsigned char ch){ return !std::isspace(ch); };
-            s.erase(s.begin(), std::find_if(s.begin(), s.end(), not_space));
-            s.erase(std::find_if(s.rbegin(), s.rend(), not_space).base(), s.end());
-            if (!s.empty() && s.front()=='"' && s.back()=='"') {
-                s = s.substr(1, s.size()-2);
-            }
-        };
-        trim(profName); trim(profEmail); trim(eventName); trim(location);
-        trim(description); trim(weekdayStr); trim(startTimeStr); trim(endTimeStr);
-
-        // 如果是新教师
-        if (!profName.empty() && (profName != currentProfName)) {
-            currentProfName = profName;
-            currentProfEmail = profEmail;
-            professors.push_back(Professor(profName, profEmail));
-            currentProf = &professors.back();
-        }
-
-        // 添加办公时间
-        if (currentProf != nullptr && !eventName.empty()) {
-            std::time_t start_t;
-            std::time_t end_t;
-
-            //这里是定义了一个lambda表达式当做临时的函数使用，用来解析时间字符串。
-            auto parseTime = [](const std::string& s, std::time_t& out) -> bool {
-                std::tm tm = {};
-                std::istringstream ss(s);
-                ss >> std::get_time(&tm, "%Y-%m-%d %H:%M");
-                if (!ss.fail()) {
-                    out = std::mktime(&tm);
-                    return true;
-                }
-                try {
-                    out = static_cast<std::time_t>(std::stoll(s));
-                    return true;
-                } catch (...) {
-                    return false;
+    for (auto& rows : chunks) {
+        for (auto& row : rows) {
+            // 如果是新教师
+            if (!row.profName.empty()) {
+                auto it = indexByName.find(row.profName);
+                if (it == indexByName.end()) {
+                    it = indexByName.emplace(row.profName, professors.size()).first;
+                    professors.push_back(Professor(row.profName, row.profEmail));
+                    contentHashes.push_back(0);
                 }
-            };
-
-            //如果解析失败或者开始时间比结束时间大，则跳过不插入
-            if (!parseTime(startTimeStr, start_t) || !parseTime(endTimeStr, end_t)) {
-                continue;
-            }
-            if (end_t <= start_t) {
-                continue;
+                current = it->second;
             }
 
-            int weekday;
-            try {
-                weekday = std::stoi(weekdayStr);
-            } catch (...) {
-                continue;
+            if (current != none && row.hasEvent) {
+                row.event.setId(eventId++);
+                contentHashes[current] += ContentHash::hashEvent(row.event);
+                professors[current].getOfficeHours().addEvent(row.event);
             }
-
-            TimeSlot slot(std::chrono::system_clock::from_time_t(start_t),
-                          std::chrono::system_clock::from_time_t(end_t),
-                          true);  // 办公时间标记为true
-
-            ScheduleEvent event(eventId++, eventName, location, description, weekday, slot);
-            currentProf->getOfficeHours().addEvent(event);
         }
     }
 
-    file.close();
+    // 办公时间哈希与顺序无关，逐行累加后再并入邮箱
+    for (std::size_t i = 0; i < professors.size(); ++i) {
+        contentHashes[i] = ContentHash::hashProfessor(professors[i].getEmail(), contentHashes[i]);
+    }
+
     return professors;
 }
 
+Schedule FileParser::parseIcs(const std::string& filePath, std::time_t windowStart, std::time_t windowEnd) {
+    int skippedEvents = 0;
+    return parseIcs(filePath, windowStart, windowEnd, skippedEvents);
+}
+
+Schedule FileParser::parseIcs(const std::string& filePath, std::time_t windowStart, std::time_t windowEnd,
+                              int& skippedEvents) {
+    Schedule schedule;
+    int eventId = 1;
+    forEachIcsOccurrence(filePath, windowStart, windowEnd, skippedEvents, [&](ScheduleEvent event) {
+        event.setId(eventId++);
+        schedule.addEvent(event);
+    });
+    return schedule;
+}
+
+Professor FileParser::parseProfessorIcs(const std::string& filePath,
+                                        const std::string& profName,
+                                        const std::string& profEmail,
+                                        std::time_t windowStart, std::time_t windowEnd) {
+    int skippedEvents = 0;
+    return parseProfessorIcs(filePath, profName, profEmail, windowStart, windowEnd, skippedEvents);
+}
+
+Professor FileParser::parseProfessorIcs(const std::string& filePath,
+                                        const std::string& profName,
+                                        const std::string& profEmail,
+                                        std::time_t windowStart, std::time_t windowEnd,
+                                        int& skippedEvents) {
+    // 日历中的每次发生都带有具体日期，因此不标记为每周重复的课程，按所在周参与计算
+    Professor professor(profName, profEmail);
+    int eventId = 1;
+    forEachIcsOccurrence(filePath, windowStart, windowEnd, skippedEvents, [&](ScheduleEvent event) {
+        event.setId(eventId++);
+        professor.getOfficeHours().addEvent(event);
+    });
+    return professor;
+}
+
+bool FileParser::writeIcs(const Schedule& schedule, const std::string& filePath) {
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    ICalendarWriter writer(file);
+    writer.begin();
+    for (const auto& event : schedule.getAllEvents()) {
+        writer.writeEvent(event, "event");
+    }
+    writer.end();
+    return file.good();
+}
@@ -3,17 +3,69 @@
 
 #include "../datastructure/Schedule.h"
 #include "../datastructure/Professor.h"
+#include "CsvTokenizer.h"
+#include <cstdint>
+#include <ctime>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class FileParser {
 public:
+    // 教师CSV中的一行：教师信息 + 可选的办公时间
+    // 没有教师名的行属于上一位教师，由调用方在合并时处理
+    struct ProfessorRecord {
+        std::string profName;
+        std::string profEmail;
+        bool hasEvent = false;
+        ScheduleEvent event;
+    };
+
     // 解析CSV文件，生成Schedule
-    static Schedule parseCsv(const std::string& filePath);
+    // threadCount: 1 为单线程；0 表示按硬件线程数自动选择；大于1时按行切块并行解析
+    // 并行模式下事件顺序和编号与单线程解析完全一致
+    static Schedule parseCsv(const std::string& filePath, int threadCount = 1);
+    
+    // 解析教师CSV文件，同名教师的办公时间按首次出现的顺序合并
+    static std::vector<Professor> parseProfessorsCsv(const std::string& filePath, int threadCount = 1);
     
-    // 解析教师CSV文件
-    static std::vector<Professor> parseProfessorsCsv(const std::string& filePath);
+    // 同上，并在解析时顺带算出每位教师的内容哈希（与 ContentHash::hashProfessor 一致）
+    static std::vector<Professor> parseProfessorsCsv(const std::string& filePath,
+                                                     std::vector<std::uint64_t>& contentHashes,
+                                                     int threadCount = 1);
+
+    // 流式解析 .ics 日历，把与 [windowStart, windowEnd) 相交的每次发生展开为个人日程
+    // 重复事件只在窗口内展开，内存占用与窗口内的事件数成正比，与文件大小无关
+    static Schedule parseIcs(const std::string& filePath, std::time_t windowStart, std::time_t windowEnd);
+
+    // 同上，skippedEvents 为重复规则无法展开（如含 BYMONTH、BYSETPOS）而跳过的事件数
+    static Schedule parseIcs(const std::string& filePath, std::time_t windowStart, std::time_t windowEnd,
+                             int& skippedEvents);
+
+    // 解析教师的 .ics 日历作为办公时间（同样只展开窗口内的发生）
+    static Professor parseProfessorIcs(const std::string& filePath,
+                                       const std::string& profName,
+                                       const std::string& profEmail,
+                                       std::time_t windowStart, std::time_t windowEnd);
+    static Professor parseProfessorIcs(const std::string& filePath,
+                                       const std::string& profName,
+                                       const std::string& profEmail,
+                                       std::time_t windowStart, std::time_t windowEnd,
+                                       int& skippedEvents);
+
+    // 把日程逐条写出为 .ics
+    static bool writeIcs(const Schedule& schedule, const std::string& filePath);
+
+    // 解析一段由完整记录组成的CSV正文（不含表头），结果按记录顺序排列，编号由调用方分配
+    // threadCount 含义同 parseCsv；流式导入的解析线程逐块调用
+    static std::vector<ScheduleEvent> parseCourseRecords(std::string_view text, int threadCount = 1);
+    static std::vector<ProfessorRecord> parseProfessorRecords(std::string_view text, int threadCount = 1);
+
+    // 解析学生课程CSV的一条记录，编号由调用方分配；记录无效时返回 false
+    static bool parseCourseRecord(const std::vector<CsvField>& fields, ScheduleEvent& event);
+
+    // 解析教师CSV的一条记录；办公时间无效时 hasEvent 为 false
+    static bool parseProfessorRecord(const std::vector<CsvField>& fields, ProfessorRecord& record);
 };
 
 #endif // FILEPARSER_H
-
@@ -0,0 +1,930 @@
+#include "ICalendar.h"
+#include "../datastructure/TimeConvert.h"
+#include "LineTokenizer.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+
+namespace {
+
+const long long SECONDS_PER_DAY = 24 * 60 * 60;
+
+// 公历日期与 1970-01-01 起天数之间的换算
+long long daysFromCivil(int year, int month, int day) {
+    year -= month <= 2 ? 1 : 0;
+    const long long era = (year >= 0 ? year : year - 399) / 400;
+    const long long yoe = year - era * 400;
+    const long long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+void civilFromDays(long long days, int& year, int& month, int& day) {
+    days += 719468;
+    const long long era = (days >= 0 ? days : days - 146096) / 146097;
+    const long long doe = days - era * 146097;
+    const long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const long long mp = (5 * doy + 2) / 153;
+    day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    year = static_cast<int>(yoe + era * 400 + (month <= 2 ? 1 : 0));
+}
+
+// 周一为0 ... 周日为6
+int weekdayIndex(long long days) {
+    long long wd = (days + 3) % 7;
+    return static_cast<int>(wd < 0 ? wd + 7 : wd);
+}
+
+int daysInMonth(int year, int month) {
+    static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return (month == 2 && leap) ? 29 : days[month - 1];
+}
+
+std::time_t localTimeOf(int year, int month, int day, int hour, int minute, int second) {
+    std::tm tm = {};
+    tm.tm_year = year - 1900;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = day;
+    tm.tm_hour = hour;
+    tm.tm_min = minute;
+    tm.tm_sec = second;
+    tm.tm_isdst = -1;
+    return std::mktime(&tm);
+}
+
+std::time_t utcTimeOf(int year, int month, int day, int hour, int minute, int second) {
+    return static_cast<std::time_t>(daysFromCivil(year, month, day) * SECONDS_PER_DAY +
+                                    hour * 3600 + minute * 60 + second);
+}
+
+bool readDigits(const std::string& text, std::size_t pos, int count, int& value) {
+    if (pos + count > text.size()) {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < count; ++i) {
+        char ch = text[pos + i];
+        if (ch < '0' || ch > '9') {
+            return false;
+        }
+        value = value * 10 + (ch - '0');
+    }
+    return true;
+}
+
+long long floorDays(long long seconds) {
+    long long days = seconds / SECONDS_PER_DAY;
+    return seconds % SECONDS_PER_DAY < 0 ? days - 1 : days;
+}
+
+// 墙上时间（1970-01-01 起的秒数，不含时区）按本机时区换算
+std::time_t localTimeOfWall(long long wall) {
+    long long days = floorDays(wall);
+    long long rest = wall - days * SECONDS_PER_DAY;
+    int year, month, day;
+    civilFromDays(days, year, month, day);
+    return localTimeOf(year, month, day, static_cast<int>(rest / 3600),
+                       static_cast<int>(rest / 60 % 60), static_cast<int>(rest % 60));
+}
+
+// 解析 DATE（YYYYMMDD）或 DATE-TIME（YYYYMMDDTHHMMSS[Z]）为墙上时间，不换算时区
+bool parseWallTime(const std::string& value, long long& wall, bool& isDate, bool& isUtc) {
+    int year, month, day;
+    if (!readDigits(value, 0, 4, year) || !readDigits(value, 4, 2, month) ||
+        !readDigits(value, 6, 2, day) || month < 1 || month > 12 ||
+        day < 1 || day > daysInMonth(year, month)) {
+        return false;
+    }
+
+    if (value.size() == 8) {
+        isDate = true;
+        isUtc = false;
+        wall = daysFromCivil(year, month, day) * SECONDS_PER_DAY;
+        return true;
+    }
+
+    int hour, minute, second;
+    if (value.size() < 15 || value[8] != 'T' ||
+        !readDigits(value, 9, 2, hour) || !readDigits(value, 11, 2, minute) ||
+        !readDigits(value, 13, 2, second)) {
+        return false;
+    }
+    isDate = false;
+    isUtc = value.size() > 15 && value[15] == 'Z';
+    wall = utcTimeOf(year, month, day, hour, minute, second);
+    return true;
+}
+
+// 解析日期或时刻：带 Z 的按 UTC；否则 zone 非空按该时区，utcZone 为 true 按 UTC，都没有时按本机时区
+// 只有日期的值总是本机当天零点
+bool parseDateTimeValue(const std::string& value, const ICalTimeZone* zone, bool utcZone,
+                        std::time_t& out, bool& isDate, bool& isUtc) {
+    long long wall;
+    if (!parseWallTime(value, wall, isDate, isUtc)) {
+        return false;
+    }
+    if (isDate) {
+        out = localTimeOfWall(wall);
+    } else if (isUtc || (zone == nullptr && utcZone)) {
+        isUtc = true;
+        out = static_cast<std::time_t>(wall);
+    } else if (zone != nullptr) {
+        out = static_cast<std::time_t>(wall - zone->offsetAtWall(wall));
+    } else {
+        out = localTimeOfWall(wall);
+    }
+    return out != static_cast<std::time_t>(-1);
+}
+
+// 解析 UTC 偏移，例如 +0800、-0430、+053000
+bool parseUtcOffset(const std::string& value, int& seconds) {
+    int hours, minutes, secs = 0;
+    if (value.size() < 5 || (value[0] != '+' && value[0] != '-') ||
+        !readDigits(value, 1, 2, hours) || !readDigits(value, 3, 2, minutes) ||
+        (value.size() >= 7 && !readDigits(value, 5, 2, secs))) {
+        return false;
+    }
+    seconds = (hours * 3600 + minutes * 60 + secs) * (value[0] == '-' ? -1 : 1);
+    return true;
+}
+
+// 解析 DURATION，例如 PT1H30M、P1D、P2W
+bool parseDuration(const std::string& value, std::time_t& out) {
+    std::size_t pos = 0;
+    int sign = 1;
+    if (pos < value.size() && (value[pos] == '+' || value[pos] == '-')) {
+        sign = value[pos] == '-' ? -1 : 1;
+        ++pos;
+    }
+    if (pos >= value.size() || value[pos] != 'P') {
+        return false;
+    }
+    ++pos;
+
+    long long total = 0;
+    long long number = 0;
+    bool hasNumber = false;
+    for (; pos < value.size(); ++pos) {
+        char ch = value[pos];
+        if (ch >= '0' && ch <= '9') {
+            number = number * 10 + (ch - '0');
+            hasNumber = true;
+            continue;
+        }
+        if (ch == 'T') continue;
+        if (!hasNumber) return false;
+        switch (ch) {
+        case 'W': total += number * 7 * SECONDS_PER_DAY; break;
+        case 'D': total += number * SECONDS_PER_DAY; break;
+        case 'H': total += number * 3600; break;
+        case 'M': total += number * 60; break;
+        case 'S': total += number; break;
+        default: return false;
+        }
+        number = 0;
+        hasNumber = false;
+    }
+    out = static_cast<std::time_t>(sign * total);
+    return true;
+}
+
+std::string unescapeText(const std::string& value) {
+    std::string result;
+    result.reserve(value.size());
+    for (std::size_t i = 0; i < value.size(); ++i) {
+        if (value[i] == '\\' && i + 1 < value.size()) {
+            char next = value[++i];
+            result.push_back(next == 'n' || next == 'N' ? '\n' : next);
+        } else {
+            result.push_back(value[i]);
+        }
+    }
+    return result;
+}
+
+std::string escapeText(const std::string& value) {
+    std::string result;
+    result.reserve(value.size());
+    for (char ch : value) {
+        switch (ch) {
+        case '\\': result += "\\\\"; break;
+        case ';': result += "\\;"; break;
+        case ',': result += "\\,"; break;
+        case '\n': result += "\\n"; break;
+        case '\r': break;
+        default: result.push_back(ch); break;
+        }
+    }
+    return result;
+}
+
+std::string toUpper(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char ch) { return static_cast<char>(std::toupper(ch)); });
+    return text;
+}
+
+// 拆分内容行 NAME;PARAM=...:VALUE，参数值中带引号的冒号不作为分隔
+void splitContentLine(const std::string& line, std::string& name, std::string& params, std::string& value) {
+    bool quoted = false;
+    std::size_t colon = std::string::npos;
+    for (std::size_t i = 0; i < line.size(); ++i) {
+        if (line[i] == '"') {
+            quoted = !quoted;
+        } else if (line[i] == ':' && !quoted) {
+            colon = i;
+            break;
+        }
+    }
+    std::string head = colon == std::string::npos ? line : line.substr(0, colon);
+    value = colon == std::string::npos ? std::string() : line.substr(colon + 1);
+
+    std::size_t semicolon = head.find(';');
+    name = toUpper(head.substr(0, semicolon));
+    params = semicolon == std::string::npos ? std::string() : toUpper(head.substr(semicolon + 1));
+}
+
+// 取参数 KEY=VALUE 的值（去掉引号），没有该参数时返回空串
+std::string paramValue(const std::string& params, const std::string& key) {
+    bool quoted = false;
+    std::size_t start = 0;
+    for (std::size_t i = 0; i <= params.size(); ++i) {
+        if (i < params.size() && params[i] == '"') {
+            quoted = !quoted;
+            continue;
+        }
+        if (i < params.size() && (params[i] != ';' || quoted)) continue;
+        std::string part = params.substr(start, i - start);
+        start = i + 1;
+        if (part.size() > key.size() && part.compare(0, key.size(), key) == 0 && part[key.size()] == '=') {
+            std::string result = part.substr(key.size() + 1);
+            result.erase(std::remove(result.begin(), result.end(), '"'), result.end());
+            return result;
+        }
+    }
+    return std::string();
+}
+
+// 没有对应 VTIMEZONE 时也能确定为 UTC 的 TZID
+bool isUtcZoneName(const std::string& tzid) {
+    static const char* names[] = {"UTC", "UCT", "GMT", "Z", "ZULU", "UNIVERSAL",
+                                  "ETC/UTC", "ETC/UCT", "ETC/GMT", "ETC/ZULU", "ETC/UNIVERSAL"};
+    for (const char* name : names) {
+        if (tzid == name) return true;
+    }
+    return false;
+}
+
+// 解析 BYDAY 中的一项，例如 MO、2TU、-1SU；不带序号时 ordinal 为0
+bool parseByDayToken(const std::string& token, int& ordinal, int& weekday) {
+    static const char* dayNames[] = {"MO", "TU", "WE", "TH", "FR", "SA", "SU"};
+    weekday = -1;
+    if (token.size() >= 2) {
+        std::string day = token.substr(token.size() - 2);
+        for (int i = 0; i < 7; ++i) {
+            if (day == dayNames[i]) weekday = i;
+        }
+    }
+    ordinal = 0;
+    std::string prefix = token.size() >= 2 ? token.substr(0, token.size() - 2) : std::string();
+    if (!prefix.empty() && prefix[0] == '+') prefix.erase(0, 1);
+    return weekday >= 0 && (prefix.empty() ||
+        (LineTokenizer::parseInt(prefix, ordinal) && ordinal != 0 && ordinal >= -5 && ordinal <= 5));
+}
+
+// 规则中有本程序无法展开的部分时返回 false
+bool parseRule(const std::string& value, RecurrenceRule& rule) {
+    rule = RecurrenceRule();
+    bool supported = true;
+
+    std::size_t pos = 0;
+    while (pos <= value.size()) {
+        std::size_t next = value.find(';', pos);
+        std::string part = value.substr(pos, next == std::string::npos ? std::string::npos : next - pos);
+        pos = next == std::string::npos ? value.size() + 1 : next + 1;
+
+        std::size_t eq = part.find('=');
+        if (eq == std::string::npos) continue;
+        std::string key = toUpper(part.substr(0, eq));
+        std::string val = toUpper(part.substr(eq + 1));
+
+        if (key == "FREQ") {
+            if (val == "DAILY") rule.frequency = RecurrenceRule::Frequency::Daily;
+            else if (val == "WEEKLY") rule.frequency = RecurrenceRule::Frequency::Weekly;
+            else if (val == "MONTHLY") rule.frequency = RecurrenceRule::Frequency::Monthly;
+            else if (val == "YEARLY") rule.frequency = RecurrenceRule::Frequency::Yearly;
+            else return false;  // 不支持按小时/分钟重复
+        } else if (key == "INTERVAL") {
+            if (!LineTokenizer::parseInt(val, rule.interval) || rule.interval < 1) rule.interval = 1;
+        } else if (key == "COUNT") {
+            if (!LineTokenizer::parseInt(val, rule.count) || rule.count < 0) rule.count = 0;
+        } else if (key == "UNTIL") {
+            bool isDate = false, isUtc = false;
+            if (parseDateTimeValue(val, nullptr, false, rule.until, isDate, isUtc) && isDate) {
+                // 只有日期的 UNTIL 包含当天
+                rule.until += SECONDS_PER_DAY - 1;
+            }
+        } else if (key == "BYDAY") {
+            std::size_t dayPos = 0;
+            while (dayPos < val.size()) {
+                std::size_t comma = val.find(',', dayPos);
+                std::string token = val.substr(dayPos, comma == std::string::npos ? std::string::npos : comma - dayPos);
+                dayPos = comma == std::string::npos ? val.size() : comma + 1;
+
+                int ordinal, weekday;
+                if (!parseByDayToken(token, ordinal, weekday)) {
+                    supported = false;
+                    continue;
+                }
+                if (ordinal == 0) {
+                    rule.byDayMask |= 1u << weekday;
+                } else {
+                    rule.byDayOrdinals.emplace_back(ordinal, weekday);
+                }
+            }
+        } else if (key != "WKST") {
+            // BYMONTH、BYMONTHDAY、BYSETPOS 等会改变发生日期，忽略它们会展开出错误的日期
+            supported = false;
+        }
+    }
+
+    if (rule.frequency == RecurrenceRule::Frequency::None) {
+        return false;
+    }
+    bool byDay = rule.byDayMask != 0 || !rule.byDayOrdinals.empty();
+    if (rule.frequency == RecurrenceRule::Frequency::Yearly && byDay) {
+        return false;
+    }
+    // 序号只对 MONTHLY 有意义，其余频率按不带序号处理
+    if (rule.frequency != RecurrenceRule::Frequency::Monthly) {
+        for (const auto& item : rule.byDayOrdinals) {
+            rule.byDayMask |= 1u << item.second;
+        }
+        rule.byDayOrdinals.clear();
+    }
+    return supported;
+}
+
+// VTIMEZONE 的一段在 year 年的生效时刻（墙上时间，按 offsetFrom）；该年不生效时返回 false
+bool onsetIn(const ICalTimeZone::Observance& observance, int year, long long& wall) {
+    long long onsetDays = floorDays(observance.onset);
+    int onsetYear, onsetMonth, onsetDay;
+    civilFromDays(onsetDays, onsetYear, onsetMonth, onsetDay);
+    if (observance.byMonth == 0) {
+        wall = observance.onset;
+        return year == onsetYear;
+    }
+    if (year < onsetYear) {
+        return false;
+    }
+
+    long long first = daysFromCivil(year, observance.byMonth, 1);
+    int lastDay = daysInMonth(year, observance.byMonth);
+    int day;
+    if (observance.ordinal > 0) {
+        day = 1 + (observance.weekday - weekdayIndex(first) + 7) % 7 + 7 * (observance.ordinal - 1);
+    } else {
+        day = lastDay - (weekdayIndex(first + lastDay - 1) - observance.weekday + 7) % 7 +
+              7 * (observance.ordinal + 1);
+    }
+    if (day < 1 || day > lastDay) {
+        return false;
+    }
+    wall = (first + day - 1) * SECONDS_PER_DAY + (observance.onset - onsetDays * SECONDS_PER_DAY);
+    return wall >= observance.onset &&
+           (observance.until == 0 || wall - observance.offsetFrom <= observance.until);
+}
+
+// 取在 t 之前最后生效的一段；t 为 UTC 时刻或本时区墙上时间
+int offsetAt(const ICalTimeZone& zone, long long t, bool isUtc) {
+    if (zone.observances.empty()) {
+        return 0;
+    }
+    int year, month, day;
+    civilFromDays(floorDays(t), year, month, day);
+
+    const ICalTimeZone::Observance* active = nullptr;
+    const ICalTimeZone::Observance* earliest = &zone.observances.front();
+    long long activeAt = 0;
+    for (const auto& observance : zone.observances) {
+        if (observance.onset < earliest->onset) {
+            earliest = &observance;
+        }
+        // 规则带 UNTIL 时，截止那一年可能是最后一次生效
+        int untilYear = year;
+        if (observance.until != 0) {
+            int untilMonth, untilDay;
+            civilFromDays(floorDays(observance.until), untilYear, untilMonth, untilDay);
+        }
+        const int years[] = {year - 1, year, year + 1, std::min(untilYear, year - 1)};
+        for (int candidateYear : years) {
+            long long wall;
+            if (!onsetIn(observance, candidateYear, wall)) continue;
+            long long at = isUtc ? wall - observance.offsetFrom : wall;
+            if (at <= t && (active == nullptr || at > activeAt)) {
+                active = &observance;
+                activeAt = at;
+            }
+        }
+        if (observance.byMonth == 0) {
+            long long at = isUtc ? observance.onset - observance.offsetFrom : observance.onset;
+            if (at <= t && (active == nullptr || at > activeAt)) {
+                active = &observance;
+                activeAt = at;
+            }
+        }
+    }
+    // 早于所有段时用最早一段生效前的偏移
+    return active != nullptr ? active->offsetTo : earliest->offsetFrom;
+}
+
+// 事件时区中的日期和时刻
+bool eventTm(const ICalEvent& event, std::time_t t, std::tm& tm) {
+    if (event.zone) {
+        return toUtcTm(t + event.zone->offsetAtUtc(t), tm);
+    }
+    return event.utc ? toUtcTm(t, tm) : toLocalTm(t, tm);
+}
+
+// 事件时区中的墙上时间换算成时刻
+std::time_t eventTimeOf(const ICalEvent& event, int year, int month, int day, int hour, int minute, int second) {
+    if (event.zone) {
+        long long wall = utcTimeOf(year, month, day, hour, minute, second);
+        return static_cast<std::time_t>(wall - event.zone->offsetAtWall(wall));
+    }
+    return event.utc ? utcTimeOf(year, month, day, hour, minute, second)
+                     : localTimeOf(year, month, day, hour, minute, second);
+}
+
+std::string formatLocal(std::time_t t) {
+    std::tm tm = {};
+    toLocalTm(t, tm);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y%m%dT%H%M%S", &tm);
+    return buffer;
+}
+
+std::string formatUtc(std::time_t t) {
+    std::tm tm = {};
+    toUtcTm(t, tm);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y%m%dT%H%M%SZ", &tm);
+    return buffer;
+}
+
+} // namespace
+
+int ICalTimeZone::offsetAtWall(long long wallSeconds) const {
+    return offsetAt(*this, wallSeconds, false);
+}
+
+int ICalTimeZone::offsetAtUtc(std::time_t utc) const {
+    return offsetAt(*this, utc, true);
+}
+
+RecurrenceIterator::RecurrenceIterator(const ICalEvent& icalEvent, std::time_t rangeStart, std::time_t rangeEnd)
+    : event(icalEvent), windowStart(rangeStart), windowEnd(rangeEnd),
+      duration(icalEvent.end > icalEvent.start ? icalEvent.end - icalEvent.start : 0),
+      startTm(), startDays(0), period(0), dayInPeriod(0), generated(0), finished(false) {
+    if (!eventTm(event, event.start, startTm)) {
+        finished = true;
+        return;
+    }
+    startDays = daysFromCivil(startTm.tm_year + 1900, startTm.tm_mon + 1, startTm.tm_mday);
+
+    // 没有 COUNT 时直接跳到窗口附近，留一个周期的余量应对夏令时
+    const RecurrenceRule& rule = event.rule;
+    long long gapDays = (static_cast<long long>(windowStart) - duration - event.start) / SECONDS_PER_DAY;
+    if (rule.count == 0 && gapDays > 0) {
+        long long periodDays = 0;
+        switch (rule.frequency) {
+        case RecurrenceRule::Frequency::Daily: periodDays = rule.interval; break;
+        case RecurrenceRule::Frequency::Weekly: periodDays = 7LL * rule.interval; break;
+        case RecurrenceRule::Frequency::Monthly: periodDays = 31LL * rule.interval; break;
+        case RecurrenceRule::Frequency::Yearly: periodDays = 366LL * rule.interval; break;
+        default: break;
+        }
+        if (periodDays > 0) {
+            period = std::max(0LL, gapDays / periodDays - 1);
+        }
+    }
+}
+
+bool RecurrenceIterator::candidate(long long periodIndex, int dayIndex, std::time_t& occurrence) const {
+    const RecurrenceRule& rule = event.rule;
+    int year = startTm.tm_year + 1900;
+    int month = startTm.tm_mon + 1;
+    int day = startTm.tm_mday;
+
+    switch (rule.frequency) {
+    case RecurrenceRule::Frequency::None:
+        occurrence = event.start;
+        return true;
+    case RecurrenceRule::Frequency::Daily:
+        civilFromDays(startDays + periodIndex * rule.interval, year, month, day);
+        if (rule.byDayMask != 0 &&
+            (rule.byDayMask & (1u << weekdayIndex(startDays + periodIndex * rule.interval))) == 0) {
+            return false;
+        }
+        break;
+    case RecurrenceRule::Frequency::Weekly:
+        if (rule.byDayMask == 0) {
+            civilFromDays(startDays + 7 * rule.interval * periodIndex, year, month, day);
+        } else {
+            long long weekStart = startDays - weekdayIndex(startDays);
+            civilFromDays(weekStart + 7 * rule.interval * periodIndex + dayIndex, year, month, day);
+        }
+        break;
+    case RecurrenceRule::Frequency::Monthly: {
+        long long months = (year * 12LL + month - 1) + periodIndex * rule.interval;
+        year = static_cast<int>(months / 12);
+        month = static_cast<int>(months % 12) + 1;
+        if (rule.byDayMask != 0 || !rule.byDayOrdinals.empty()) {
+            // 检查该日期是否是规则中的某个（第 n 个）星期
+            day = dayIndex + 1;
+            int lastDay = daysInMonth(year, month);
+            if (day > lastDay) {
+                return false;
+            }
+            int wd = weekdayIndex(daysFromCivil(year, month, day));
+            bool matched = (rule.byDayMask & (1u << wd)) != 0;
+            for (const auto& item : rule.byDayOrdinals) {
+                if (item.second == wd &&
+                    (item.first > 0 ? (day - 1) / 7 + 1 == item.first
+                                    : (lastDay - day) / 7 + 1 == -item.first)) {
+                    matched = true;
+                }
+            }
+            if (!matched) {
+                return false;
+            }
+        } else if (day > daysInMonth(year, month)) {
+            return false;   // 例如没有 31 号的月份，按 RFC 5545 跳过
+        }
+        break;
+    }
+    case RecurrenceRule::Frequency::Yearly:
+        year += static_cast<int>(periodIndex * rule.interval);
+        if (day > daysInMonth(year, month)) {
+            return false;
+        }
+        break;
+    }
+
+    occurrence = eventTimeOf(event, year, month, day, startTm.tm_hour, startTm.tm_min, startTm.tm_sec);
+    return occurrence != static_cast<std::time_t>(-1);
+}
+
+bool RecurrenceIterator::next(std::time_t& occurrenceStart) {
+    const RecurrenceRule& rule = event.rule;
+    // WEEKLY/MONTHLY 带 BYDAY 时逐个检查周期内的每一天（一周7天、一个月最多31天）
+    bool hasByDay = rule.byDayMask != 0 || !rule.byDayOrdinals.empty();
+    int lastInPeriod = -1;
+    if (hasByDay && rule.frequency == RecurrenceRule::Frequency::Weekly) {
+        lastInPeriod = 6;
+    } else if (hasByDay && rule.frequency == RecurrenceRule::Frequency::Monthly) {
+        lastInPeriod = 30;
+    }
+    bool byDay = lastInPeriod >= 0;
+    int guard = 0;
+
+    while (!finished) {
+        // 防止异常规则造成死循环
+        if (++guard > 100000) {
+            finished = true;
+            break;
+        }
+
+        std::time_t occurrence;
+        bool valid;
+        if (rule.frequency == RecurrenceRule::Frequency::None) {
+            if (period > 0) {
+                finished = true;
+                break;
+            }
+            valid = candidate(period++, 0, occurrence);
+        } else if (byDay) {
+            if (dayInPeriod > lastInPeriod) {
+                ++period;
+                dayInPeriod = 0;
+                continue;
+            }
+            int index = dayInPeriod++;
+            if (rule.frequency == RecurrenceRule::Frequency::Weekly &&
+                (rule.byDayMask & (1u << index)) == 0) {
+                continue;
+            }
+            valid = candidate(period, index, occurrence);
+        } else {
+            valid = candidate(period++, 0, occurrence);
+        }
+
+        if (!valid || occurrence < event.start) {
+            continue;
+        }
+        if (rule.until != 0 && occurrence > rule.until) {
+            finished = true;
+            break;
+        }
+        if (rule.count > 0 && ++generated > rule.count) {
+            finished = true;
+            break;
+        }
+        if (occurrence >= windowEnd) {
+            finished = true;
+            break;
+        }
+        if (occurrence + duration <= windowStart) {
+            continue;
+        }
+        if (std::find(event.exdates.begin(), event.exdates.end(), occurrence) != event.exdates.end()) {
+            continue;
+        }
+
+        occurrenceStart = occurrence;
+        return true;
+    }
+    return false;
+}
+
+ICalendarReader::ICalendarReader(std::istream& in)
+    : input(in), hasLookahead(false) {
+}
+
+bool ICalendarReader::readUnfoldedLine(std::string& line) {
+    if (hasLookahead) {
+        line = lookahead;
+        hasLookahead = false;
+    } else if (!std::getline(input, line)) {
+        return false;
+    }
+    if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+    }
+
+    // 以空格或制表符开头的行是上一行的续行
+    std::string raw;
+    while (std::getline(input, raw)) {
+        if (!raw.empty() && raw.back() == '\r') {
+            raw.pop_back();
+        }
+        if (!raw.empty() && (raw[0] == ' ' || raw[0] == '\t')) {
+            line.append(raw, 1, std::string::npos);
+        } else {
+            lookahead = raw;
+            hasLookahead = true;
+            break;
+        }
+    }
+    return true;
+}
+
+void ICalendarReader::readTimeZone() {
+    std::string line, name, params, value, tzid;
+    auto zone = std::make_shared<ICalTimeZone>();
+    ICalTimeZone::Observance observance;
+    bool inObservance = false;
+    bool supported = true;      // 含有无法换算的规则时不登记，该 TZID 按本机时区解释
+    int nestedDepth = 0;
+
+    while (readUnfoldedLine(line)) {
+        if (line.empty()) continue;
+        splitContentLine(line, name, params, value);
+        std::string upper = toUpper(value);
+
+        if (name == "BEGIN") {
+            if (!inObservance && nestedDepth == 0 && (upper == "STANDARD" || upper == "DAYLIGHT")) {
+                inObservance = true;
+                observance = ICalTimeZone::Observance();
+            } else {
+                ++nestedDepth;
+            }
+            continue;
+        }
+        if (name == "END") {
+            if (nestedDepth > 0) {
+                --nestedDepth;
+            } else if (inObservance) {
+                zone->observances.push_back(observance);
+                inObservance = false;
+            } else if (upper == "VTIMEZONE") {
+                break;
+            }
+            continue;
+        }
+        if (nestedDepth > 0) continue;
+
+        if (!inObservance) {
+            if (name == "TZID") tzid = upper;
+            continue;
+        }
+        bool isDate = false, isUtc = false;
+        if (name == "DTSTART") {
+            supported = parseWallTime(value, observance.onset, isDate, isUtc) && supported;
+        } else if (name == "TZOFFSETFROM") {
+            supported = parseUtcOffset(value, observance.offsetFrom) && supported;
+        } else if (name == "TZOFFSETTO") {
+            supported = parseUtcOffset(value, observance.offsetTo) && supported;
+        } else if (name == "RRULE") {
+            // 只认每年某月第 n 个星期几这一种写法
+            bool yearly = false;
+            std::size_t pos = 0;
+            while (pos <= upper.size()) {
+                std::size_t next = upper.find(';', pos);
+                std::string part = upper.substr(pos, next == std::string::npos ? std::string::npos : next - pos);
+                pos = next == std::string::npos ? upper.size() + 1 : next + 1;
+                std::size_t eq = part.find('=');
+                if (eq == std::string::npos) continue;
+                std::string key = part.substr(0, eq);
+                std::string val = part.substr(eq + 1);
+                if (key == "FREQ") {
+                    yearly = val == "YEARLY";
+                } else if (key == "BYMONTH") {
+                    supported = LineTokenizer::parseInt(val, observance.byMonth) &&
+                                observance.byMonth >= 1 && observance.byMonth <= 12 && supported;
+                } else if (key == "BYDAY") {
+                    supported = parseByDayToken(val, observance.ordinal, observance.weekday) &&
+                                observance.ordinal != 0 && supported;
+                } else if (key == "UNTIL") {
+                    supported = parseDateTimeValue(val, nullptr, true, observance.until, isDate, isUtc) &&
+                                supported;
+                } else if (key != "WKST" && key != "INTERVAL") {
+                    supported = false;
+                }
+            }
+            supported = supported && yearly && observance.byMonth != 0 && observance.ordinal != 0;
+        } else if (name == "RDATE") {
+            supported = false;
+        }
+    }
+
+    if (supported && !tzid.empty() && !zone->observances.empty()) {
+        zones[tzid] = zone;
+    }
+}
+
+bool ICalendarReader::nextEvent(ICalEvent& event) {
+    std::string line, name, params, value;
+    bool inEvent = false;
+    int nestedDepth = 0;        // VEVENT 内嵌套的 VALARM 等组件
+    bool hasStart = false;
+    bool hasEnd = false;
+    std::time_t duration = 0;
+    bool hasDuration = false;
+
+    while (readUnfoldedLine(line)) {
+        if (line.empty()) continue;
+        splitContentLine(line, name, params, value);
+
+        if (!inEvent) {
+            if (name == "BEGIN" && toUpper(value) == "VEVENT") {
+                inEvent = true;
+                event = ICalEvent();
+                hasStart = hasEnd = hasDuration = false;
+                nestedDepth = 0;
+            } else if (name == "BEGIN" && toUpper(value) == "VTIMEZONE") {
+                readTimeZone();
+            }
+            continue;
+        }
+
+        if (name == "BEGIN") {
+            ++nestedDepth;
+            continue;
+        }
+        if (name == "END") {
+            if (nestedDepth > 0) {
+                --nestedDepth;
+                continue;
+            }
+            if (toUpper(value) != "VEVENT") continue;
+
+            inEvent = false;
+            if (!hasStart) continue;   // 没有开始时间的事件无法使用
+            if (!hasEnd) {
+                if (hasDuration) {
+                    event.end = event.start + duration;
+                } else if (event.allDay) {
+                    event.end = event.start + SECONDS_PER_DAY;
+                } else {
+                    event.end = event.start;
+                }
+            }
+            return true;
+        }
+        if (nestedDepth > 0) continue;
+
+        // DTSTART/DTEND/EXDATE 的 TZID：优先用文件中的 VTIMEZONE，其次识别 UTC 的各种写法
+        bool isDate = false, isUtc = false;
+        std::string tzid = paramValue(params, "TZID");
+        auto found = tzid.empty() ? zones.end() : zones.find(tzid);
+        const ICalTimeZone* zone = found != zones.end() ? found->second.get() : nullptr;
+        bool utcZone = zone == nullptr && isUtcZoneName(tzid);
+        if (name == "UID") {
+            event.uid = value;
+        } else if (name == "SUMMARY") {
+            event.summary = unescapeText(value);
+        } else if (name == "LOCATION") {
+            event.location = unescapeText(value);
+        } else if (name == "DESCRIPTION") {
+            event.description = unescapeText(value);
+        } else if (name == "DTSTART") {
+            hasStart = parseDateTimeValue(value, zone, utcZone, event.start, isDate, isUtc);
+            event.allDay = hasStart && isDate;
+            event.utc = hasStart && isUtc;
+            event.zone = hasStart && !isDate && !isUtc && zone != nullptr ? found->second : nullptr;
+        } else if (name == "DTEND") {
+            hasEnd = parseDateTimeValue(value, zone, utcZone, event.end, isDate, isUtc);
+        } else if (name == "DURATION") {
+            hasDuration = parseDuration(value, duration);
+        } else if (name == "RRULE") {
+            event.ruleSupported = parseRule(value, event.rule);
+        } else if (name == "EXDATE") {
+            std::size_t pos = 0;
+            while (pos < value.size()) {
+                std::size_t comma = value.find(',', pos);
+                std::string item = value.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+                pos = comma == std::string::npos ? value.size() : comma + 1;
+                std::time_t excluded;
+                if (parseDateTimeValue(item, zone, utcZone, excluded, isDate, isUtc)) {
+                    event.exdates.push_back(excluded);
+                }
+            }
+        }
+    }
+    return false;
+}
+
+ICalendarWriter::ICalendarWriter(std::ostream& out)
+    : output(out), written(0) {
+}
+
+void ICalendarWriter::writeLine(const std::string& line) {
+    // 每行不超过75字节，续行以空格开头；不在 UTF-8 多字节字符中间折行
+    const std::size_t limit = 75;
+    std::size_t pos = 0;
+    bool first = true;
+    while (pos < line.size()) {
+        std::size_t room = first ? limit : limit - 1;
+        std::size_t len = std::min(room, line.size() - pos);
+        while (len > 0 && pos + len < line.size() &&
+               (static_cast<unsigned char>(line[pos + len]) & 0xC0) == 0x80) {
+            --len;
+        }
+        if (!first) {
+            output << ' ';
+        }
+        output.write(line.data() + pos, static_cast<std::streamsize>(len));
+        output << "\r\n";
+        pos += len;
+        first = false;
+    }
+    if (line.empty()) {
+        output << "\r\n";
+    }
+}
+
+void ICalendarWriter::begin() {
+    writeLine("BEGIN:VCALENDAR");
+    writeLine("VERSION:2.0");
+    writeLine("PRODID:-//Student Schedule System//Schedule Manager//ZH");
+    writeLine("CALSCALE:GREGORIAN");
+}
+
+void ICalendarWriter::writeEvent(const ScheduleEvent& event, const std::string& uidPrefix) {
+    std::time_t start = std::chrono::system_clock::to_time_t(event.getTimeSlot().getStartTime());
+    std::time_t end = std::chrono::system_clock::to_time_t(event.getTimeSlot().getEndTime());
+
+    writeLine("BEGIN:VEVENT");
+    writeLine("UID:" + uidPrefix + "-" + std::to_string(event.getId()) + "-" +
+              std::to_string(written++) + "@schedule-manager");
+    writeLine("DTSTAMP:" + formatUtc(std::time(nullptr)));
+    // 课程按本地墙上时间每周重复，写成浮动时间；写成 UTC 会在夏令时切换后偏移一小时
+    if (event.getTimeSlot().getIsCourse()) {
+        writeLine("DTSTART:" + formatLocal(start));
+        writeLine("DTEND:" + formatLocal(end));
+    } else {
+        writeLine("DTSTART:" + formatUtc(start));
+        writeLine("DTEND:" + formatUtc(end));
+    }
+    writeLine("SUMMARY:" + escapeText(event.getEventName()));
+    if (!event.getLocation().empty()) {
+        writeLine("LOCATION:" + escapeText(event.getLocation()));
+    }
+    if (!event.getDescription().empty()) {
+        writeLine("DESCRIPTION:" + escapeText(event.getDescription()));
+    }
+    // 课程在本程序中按周重复
+    if (event.getTimeSlot().getIsCourse()) {
+        writeLine("RRULE:FREQ=WEEKLY");
+    }
+    writeLine("END:VEVENT");
+}
+
+void ICalendarWriter::end() {
+    writeLine("END:VCALENDAR");
+    output.flush();
+}
@@ -0,0 +1,126 @@
+#ifndef ICALENDAR_H
+#define ICALENDAR_H
+
+#include "../datastructure/Schedule.h"
+#include <ctime>
+#include <istream>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 重复规则（RRULE 的常用子集：FREQ/INTERVAL/COUNT/UNTIL/BYDAY）
+// BYDAY 对 DAILY 是筛选，对 WEEKLY/MONTHLY 是在周期内展开；MONTHLY 支持 2TU、-1FR 之类的序号
+struct RecurrenceRule {
+    enum class Frequency { None, Daily, Weekly, Monthly, Yearly };
+
+    Frequency frequency = Frequency::None;
+    int interval = 1;
+    int count = 0;              // 0 表示不限次数
+    std::time_t until = 0;      // 0 表示没有截止时间
+    unsigned int byDayMask = 0; // 不带序号的星期，第0位=周一 ... 第6位=周日
+    std::vector<std::pair<int, int>> byDayOrdinals;    // MONTHLY 中带序号的星期：（序号, 星期）
+};
+
+// VTIMEZONE 的常用子集：每个 STANDARD/DAYLIGHT 段从生效时刻起改用 offsetTo
+// 年度规则只支持 FREQ=YEARLY;BYMONTH=m;BYDAY=nDD（如 -1SU），没有规则的段只在 DTSTART 生效一次
+struct ICalTimeZone {
+    struct Observance {
+        long long onset = 0;        // DTSTART 的墙上时间（按 offsetFrom），1970-01-01 起的秒数
+        int offsetFrom = 0;         // 相对 UTC 的秒数
+        int offsetTo = 0;
+        int byMonth = 0;            // 0 表示没有年度规则
+        int ordinal = 0;            // 月内第几个星期，负数从月末数起
+        int weekday = 0;            // 周一为0
+        std::time_t until = 0;      // 0 表示不限
+    };
+    std::vector<Observance> observances;
+
+    // 本时区的墙上时间（1970-01-01 起的秒数）或 UTC 时刻所对应的 UTC 偏移（秒）
+    int offsetAtWall(long long wallSeconds) const;
+    int offsetAtUtc(std::time_t utc) const;
+};
+
+// 一个未展开的 VEVENT
+struct ICalEvent {
+    std::string uid;
+    std::string summary;
+    std::string location;
+    std::string description;
+    std::time_t start = 0;      // 首次发生的开始时间
+    std::time_t end = 0;        // 首次发生的结束时间
+    bool allDay = false;
+    RecurrenceRule rule;
+    bool ruleSupported = true;  // RRULE 含有无法展开的部分（如 BYMONTH、BYSETPOS）时为 false
+    std::vector<std::time_t> exdates;
+    // 重复按 DTSTART 的哪种墙上时间展开：zone 非空按该 VTIMEZONE，utc 为 true 按 UTC，否则按本机时区（浮动时间）
+    std::shared_ptr<const ICalTimeZone> zone;
+    bool utc = false;
+};
+
+// 惰性展开重复事件：只生成与 [windowStart, windowEnd) 相交的发生时间
+// 不设 COUNT 的规则会直接跳到窗口附近，不逐个枚举窗口之前的发生
+class RecurrenceIterator {
+private:
+    const ICalEvent& event;
+    std::time_t windowStart;
+    std::time_t windowEnd;
+    std::time_t duration;
+    std::tm startTm;            // DTSTART 在事件时区中的日期和时刻
+    long long startDays;        // DTSTART 所在日期的天序号
+    long long period;           // 当前周期序号
+    int dayInPeriod;            // WEEKLY/MONTHLY+BYDAY 时当前周期内的下一个星期或日期
+    int generated;              // 已生成的发生次数（计入 COUNT）
+    bool finished;
+
+    // dayIndex：WEEKLY 为周内星期（周一为0），MONTHLY 为月内日期（从0起）
+    bool candidate(long long periodIndex, int dayIndex, std::time_t& occurrence) const;
+
+public:
+    RecurrenceIterator(const ICalEvent& icalEvent, std::time_t rangeStart, std::time_t rangeEnd);
+
+    // 取下一个发生的开始时间，没有更多时返回 false
+    bool next(std::time_t& occurrenceStart);
+};
+
+// 流式读取 .ics：每次只解析一个 VEVENT，不把整个文件读入内存
+// 带 Z 后缀或 TZID 为 UTC 的时间按 UTC 解释；TZID 指向文件中的 VTIMEZONE 时按其偏移换算
+// 浮动时间和找不到定义的 TZID（本程序没有时区数据库）按本机时区解释
+class ICalendarReader {
+private:
+    std::istream& input;
+    std::string lookahead;
+    bool hasLookahead;
+    std::map<std::string, std::shared_ptr<const ICalTimeZone>> zones;  // 已读到的 VTIMEZONE，键为大写 TZID
+
+    bool readUnfoldedLine(std::string& line);
+    void readTimeZone();
+
+public:
+    explicit ICalendarReader(std::istream& in);
+
+    // 读取下一个 VEVENT，没有更多时返回 false
+    bool nextEvent(ICalEvent& event);
+};
+
+// 流式写出 .ics
+// 课程（isCourse）按每周重复写出 RRULE，其余事件写成单次事件
+// 课程的 DTSTART/DTEND 写成本地浮动时间，重复按墙上时间展开，跨夏令时不会偏移一小时
+class ICalendarWriter {
+private:
+    std::ostream& output;
+    int written;
+
+    void writeLine(const std::string& line);
+
+public:
+    explicit ICalendarWriter(std::ostream& out);
+
+    void begin();
+    void writeEvent(const ScheduleEvent& event, const std::string& uidPrefix);
+    void end();
+};
+
+#endif // ICALENDAR_H
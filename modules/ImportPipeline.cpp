@@ -0,0 +1,216 @@
+#include "ImportPipeline.h"
+#include "CsvTokenizer.h"
+
+// 读取线程每次读取的字节数；解析线程再把一块切成多段并行解析，块太小时无法分段
+static const std::size_t READ_BLOCK_SIZE = 4 << 20;
+
+ImportPipeline::ImportPipeline(Kind importKind, const std::string& path, std::size_t rowsPerBatch,
+                               int threadCount)
+    : kind(importKind), filePath(path), batchSize(rowsPerBatch > 0 ? rowsPerBatch : 1),
+      parseThreads(threadCount),
+      totalBytes(0), bytesRead(0), cancelled(false),
+      chunkQueue(4), batchQueue(8) {
+}
+
+ImportPipeline::~ImportPipeline() {
+    cancel();
+    join();
+}
+
+bool ImportPipeline::start() {
+    if (mappedSource.open(filePath, false)) {
+        totalBytes = mappedSource.size();
+    } else {
+        // 无法映射（管道、空文件等），退回按块缓冲读取
+        input.open(filePath, std::ios::binary);
+        if (!input.is_open()) {
+            return false;
+        }
+
+        input.seekg(0, std::ios::end);
+        std::streamoff size = input.tellg();
+        totalBytes = size > 0 ? static_cast<std::uint64_t>(size) : 0;
+        input.seekg(0, std::ios::beg);
+        if (!input) {
+            input.clear();
+        }
+    }
+
+    readerThread = std::thread(&ImportPipeline::readLoop, this);
+    parserThread = std::thread(&ImportPipeline::parseLoop, this);
+    return true;
+}
+
+void ImportPipeline::cancel() {
+    cancelled = true;
+    chunkQueue.abort();
+    batchQueue.abort();
+}
+
+bool ImportPipeline::isCancelled() const {
+    return cancelled;
+}
+
+bool ImportPipeline::tryTakeBatch(Batch& batch) {
+    return batchQueue.tryPop(batch);
+}
+
+bool ImportPipeline::takeBatch(Batch& batch) {
+    return batchQueue.pop(batch);
+}
+
+bool ImportPipeline::isFinished() const {
+    return batchQueue.isDrained();
+}
+
+ImportPipeline::Kind ImportPipeline::getKind() const {
+    return kind;
+}
+
+std::uint64_t ImportPipeline::getBytesRead() const {
+    return bytesRead;
+}
+
+std::uint64_t ImportPipeline::getTotalBytes() const {
+    return totalBytes;
+}
+
+int ImportPipeline::getProgressPercent() const {
+    if (totalBytes == 0) {
+        return isFinished() ? 100 : 0;
+    }
+    return static_cast<int>(bytesRead * 100 / totalBytes);
+}
+
+void ImportPipeline::join() {
+    if (readerThread.joinable()) {
+        readerThread.join();
+    }
+    if (parserThread.joinable()) {
+        parserThread.join();
+    }
+}
+
+void ImportPipeline::readLoop() {
+    if (mappedSource.isMapped()) {
+        readMapped();
+    } else {
+        readBuffered();
+    }
+    chunkQueue.close();
+}
+
+void ImportPipeline::readMapped() {
+    std::string_view data = mappedSource.data();
+    std::size_t pos = 0;
+
+    while (!cancelled && pos < data.size()) {
+        // 取约一个块大小的窗口，截到最后一条完整记录；窗口内没有完整记录时扩大窗口
+        std::size_t window = READ_BLOCK_SIZE;
+        std::size_t cut = 0;
+        while (pos + window < data.size()) {
+            cut = CsvTokenizer::lastRecordEnd(data.substr(pos, window));
+            if (cut > 0) break;
+            window *= 2;
+        }
+        if (pos + window >= data.size()) {
+            cut = data.size() - pos;
+        }
+
+        Chunk chunk;
+        chunk.view = data.substr(pos, cut);
+        pos += cut;
+        bytesRead = pos;
+        if (!chunkQueue.push(std::move(chunk))) {
+            break;
+        }
+    }
+}
+
+void ImportPipeline::readBuffered() {
+    std::vector<char> block(READ_BLOCK_SIZE);
+    std::string pending;
+    std::size_t scanned = 0;    // pending 中已扫描的长度，跨越多块的长记录不必从头重扫
+    CsvTokenizer::ScanState state = CsvTokenizer::ScanState::FieldStart;
+
+    while (!cancelled) {
+        input.read(block.data(), static_cast<std::streamsize>(block.size()));
+        std::streamsize got = input.gcount();
+        if (got <= 0) {
+            break;
+        }
+        bytesRead += static_cast<std::uint64_t>(got);
+        pending.append(block.data(), static_cast<std::size_t>(got));
+
+        // 只把完整的记录交给解析线程，半条记录留到下一块
+        std::size_t cut = CsvTokenizer::lastRecordEnd(pending, scanned, state);
+        if (cut == 0) {
+            continue;
+        }
+        Chunk chunk;
+        chunk.owned = pending.substr(0, cut);
+        pending.erase(0, cut);
+        scanned -= cut;     // 切点在记录边界上，剩余部分的扫描状态不变
+        if (!chunkQueue.push(std::move(chunk))) {
+            break;
+        }
+    }
+
+    // 文件末尾没有换行的最后一条记录
+    if (!cancelled && !pending.empty()) {
+        Chunk chunk;
+        chunk.owned = std::move(pending);
+        chunkQueue.push(std::move(chunk));
+    }
+    input.close();
+}
+
+template <typename Row>
+bool ImportPipeline::pushRows(std::vector<Row>& rows, std::vector<Row> Batch::*target) {
+    for (auto& row : rows) {
+        if (cancelled) {
+            return false;
+        }
+        (pendingBatch.*target).push_back(std::move(row));
+        if ((pendingBatch.*target).size() >= batchSize) {
+            if (!batchQueue.push(std::move(pendingBatch))) {
+                return false;
+            }
+            pendingBatch = Batch();
+        }
+    }
+    return true;
+}
+
+void ImportPipeline::parseLoop() {
+    bool headerSkipped = false;
+    Chunk chunk;
+
+    while (!cancelled && chunkQueue.pop(chunk)) {
+        std::string_view text = chunk.text();
+        if (!headerSkipped) {
+            CsvTokenizer tokenizer(text);
+            tokenizer.skipRecord();
+            text = text.substr(tokenizer.position());
+            headerSkipped = true;
+        }
+
+        // 块内并行解析，结果已按记录顺序排列
+        bool pushed;
+        if (kind == Kind::StudentCourses) {
+            auto rows = FileParser::parseCourseRecords(text, parseThreads);
+            pushed = pushRows(rows, &Batch::courses);
+        } else {
+            auto rows = FileParser::parseProfessorRecords(text, parseThreads);
+            pushed = pushRows(rows, &Batch::professors);
+        }
+        if (!pushed) {
+            break;
+        }
+    }
+
+    if (!cancelled && (!pendingBatch.courses.empty() || !pendingBatch.professors.empty())) {
+        batchQueue.push(std::move(pendingBatch));
+    }
+    batchQueue.close();
+}
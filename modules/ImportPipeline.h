@@ -0,0 +1,97 @@
+#ifndef IMPORTPIPELINE_H
+#define IMPORTPIPELINE_H
+
+#include "BoundedQueue.h"
+#include "FileParser.h"
+#include "MappedFile.h"
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 流式导入流水线：读取线程 -> 解析线程 -> 合并阶段
+// 读取线程按记录边界切块，解析线程把每块再切成若干段并行解析（同 FileParser::parseCsv），
+// 按原顺序攒成批次；
+// 普通文件通过内存映射读取，块只是映射内存上的视图；管道等无法映射时按块缓冲读取
+// 合并阶段由调用方（通常是界面线程）通过 tryTakeBatch 逐批取出并写入 DataManager，
+// 因此界面可以在导入过程中持续刷新、显示进度并随时取消
+class ImportPipeline {
+public:
+    enum class Kind {
+        StudentCourses,     // 学生课程CSV
+        Professors          // 教师办公时间CSV
+    };
+
+    // 一批解析结果，按 kind 只有其中一个数组有内容
+    struct Batch {
+        std::vector<ScheduleEvent> courses;
+        std::vector<FileParser::ProfessorRecord> professors;
+    };
+
+    // threadCount 为解析每块时使用的线程数，含义同 FileParser::parseCsv（0 为按硬件线程数）
+    ImportPipeline(Kind importKind, const std::string& path, std::size_t rowsPerBatch = 500,
+                   int threadCount = 0);
+    ~ImportPipeline();
+
+    ImportPipeline(const ImportPipeline&) = delete;
+    ImportPipeline& operator=(const ImportPipeline&) = delete;
+
+    // 打开文件并启动读取、解析线程；文件无法打开时返回 false
+    bool start();
+
+    // 请求取消，后台线程会尽快退出，未取出的批次被丢弃
+    void cancel();
+    bool isCancelled() const;
+
+    // 不阻塞地取出一批结果
+    bool tryTakeBatch(Batch& batch);
+
+    // 阻塞直到取到一批结果，全部完成后返回 false
+    bool takeBatch(Batch& batch);
+
+    // 所有阶段都已结束且批次已全部取出
+    bool isFinished() const;
+
+    Kind getKind() const;
+    std::uint64_t getBytesRead() const;
+    std::uint64_t getTotalBytes() const;
+    int getProgressPercent() const;
+
+private:
+    Kind kind;
+    std::string filePath;
+    std::size_t batchSize;
+    int parseThreads;
+    MappedFile mappedSource;
+    std::ifstream input;
+    std::uint64_t totalBytes;
+    std::atomic<std::uint64_t> bytesRead;
+    std::atomic<bool> cancelled;
+
+    // 读取线程交给解析线程的一块数据：映射模式下只是视图，缓冲模式下持有数据
+    struct Chunk {
+        std::string owned;
+        std::string_view view;
+
+        std::string_view text() const { return owned.empty() ? view : std::string_view(owned); }
+    };
+
+    BoundedQueue<Chunk> chunkQueue;
+    BoundedQueue<Batch> batchQueue;
+    std::thread readerThread;
+    std::thread parserThread;
+    Batch pendingBatch;         // 解析线程正在攒的批次
+
+    void readLoop();
+    void readMapped();
+    void readBuffered();
+    void parseLoop();
+    // 把解析结果按 batchSize 攒成批次交给合并阶段；取消或队列中止时返回 false
+    template <typename Row>
+    bool pushRows(std::vector<Row>& rows, std::vector<Row> Batch::*target);
+    void join();
+};
+
+#endif // IMPORTPIPELINE_H
@@ -0,0 +1,138 @@
+#include "LineTokenizer.h"
+#include <charconv>
+#include <cstring>
+
+LineReader::LineReader(std::istream& in, std::size_t bufferSize)
+    : input(in), buffer(bufferSize > 0 ? bufferSize : 4096),
+      begin(0), end(0), lineNo(0), eof(false) {
+}
+
+bool LineReader::refill() {
+    if (eof) {
+        return false;
+    }
+
+    // 保留尚未消费的半行数据
+    std::size_t remaining = end - begin;
+    if (begin > 0 && remaining > 0) {
+        std::memmove(buffer.data(), buffer.data() + begin, remaining);
+    }
+    begin = 0;
+    end = remaining;
+
+    // 一整行比缓冲区还长时扩容
+    if (end == buffer.size()) {
+        buffer.resize(buffer.size() * 2);
+    }
+
+    input.read(buffer.data() + end, static_cast<std::streamsize>(buffer.size() - end));
+    std::streamsize got = input.gcount();
+    if (got <= 0) {
+        eof = true;
+        return false;
+    }
+    end += static_cast<std::size_t>(got);
+    return true;
+}
+
+bool LineReader::nextLine(std::string_view& line) {
+    std::size_t scanFrom = begin;
+    while (true) {
+        const char* base = buffer.data();
+        const void* nl = std::memchr(base + scanFrom, '\n', end - scanFrom);
+        if (nl != nullptr) {
+            std::size_t pos = static_cast<const char*>(nl) - base;
+            std::size_t len = pos - begin;
+            if (len > 0 && base[begin + len - 1] == '\r') {
+                --len;
+            }
+            line = std::string_view(base + begin, len);
+            begin = pos + 1;
+            ++lineNo;
+            return true;
+        }
+
+        // 当前缓冲区里没有完整的行，继续读取
+        std::size_t scanned = end - begin;
+        if (!refill()) {
+            // 文件末尾没有换行符的最后一行
+            if (end > begin) {
+                std::size_t len = end - begin;
+                if (buffer[begin + len - 1] == '\r') {
+                    --len;
+                }
+                line = std::string_view(buffer.data() + begin, len);
+                begin = end;
+                ++lineNo;
+                return true;
+            }
+            return false;
+        }
+        scanFrom = begin + scanned;
+    }
+}
+
+std::size_t LineReader::lineNumber() const {
+    return lineNo;
+}
+
+std::size_t LineTokenizer::split(std::string_view line, char delimiter,
+                                 std::string_view* fields, std::size_t maxFields) {
+    std::size_t count = 0;
+    std::size_t pos = 0;
+    while (count < maxFields) {
+        std::size_t next = line.find(delimiter, pos);
+        if (next == std::string_view::npos) {
+            fields[count++] = line.substr(pos);
+            break;
+        }
+        fields[count++] = line.substr(pos, next - pos);
+        pos = next + 1;
+    }
+
+    for (std::size_t i = count; i < maxFields; ++i) {
+        fields[i] = std::string_view();
+    }
+    return count;
+}
+
+bool LineTokenizer::parseInt(std::string_view text, int& out) {
+    text = trim(text);
+    if (text.empty()) {
+        return false;
+    }
+    const char* first = text.data();
+    const char* last = first + text.size();
+    if (*first == '+') {
+        ++first;
+    }
+    auto result = std::from_chars(first, last, out);
+    return result.ec == std::errc() && result.ptr == last;
+}
+
+bool LineTokenizer::parseInt64(std::string_view text, long long& out) {
+    text = trim(text);
+    if (text.empty()) {
+        return false;
+    }
+    const char* first = text.data();
+    const char* last = first + text.size();
+    if (*first == '+') {
+        ++first;
+    }
+    auto result = std::from_chars(first, last, out);
+    return result.ec == std::errc() && result.ptr == last;
+}
+
+std::string_view LineTokenizer::trim(std::string_view text) {
+    auto isSpace = [](char ch) {
+        return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n' || ch == '\f' || ch == '\v';
+    };
+    while (!text.empty() && isSpace(text.front())) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && isSpace(text.back())) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
@@ -0,0 +1,55 @@
+#ifndef LINETOKENIZER_H
+#define LINETOKENIZER_H
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 单行解析错误（行号从1开始）
+struct LineError {
+    std::size_t lineNumber;
+    std::string message;
+};
+
+// 大块缓冲的逐行读取器
+// 返回的 string_view 指向内部缓冲区，只在下一次调用 nextLine 之前有效
+class LineReader {
+private:
+    std::istream& input;
+    std::vector<char> buffer;
+    std::size_t begin;      // 缓冲区中未消费数据的起点
+    std::size_t end;        // 缓冲区中有效数据的终点
+    std::size_t lineNo;
+    bool eof;
+
+    // 把未消费的数据移到缓冲区头部并继续读取，缓冲区不足时扩容
+    bool refill();
+
+public:
+    explicit LineReader(std::istream& in, std::size_t bufferSize = 1 << 20);
+
+    // 读取下一行（已去掉行尾的 \r\n），没有更多数据时返回 false
+    bool nextLine(std::string_view& line);
+
+    // 最近一次返回的行号
+    std::size_t lineNumber() const;
+};
+
+class LineTokenizer {
+public:
+    // 按分隔符拆分一行，最多填充 maxFields 个字段，多余字段忽略，缺失字段为空
+    // 返回实际找到的字段数
+    static std::size_t split(std::string_view line, char delimiter,
+                             std::string_view* fields, std::size_t maxFields);
+
+    // 不抛异常的整数解析，要求整个字段都是数字
+    static bool parseInt(std::string_view text, int& out);
+    static bool parseInt64(std::string_view text, long long& out);
+
+    // 去掉首尾空白
+    static std::string_view trim(std::string_view text);
+};
+
+#endif // LINETOKENIZER_H
@@ -0,0 +1,155 @@
+#include "MappedFile.h"
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+    : mappedData(nullptr), mappedSize(0), mapped(false), opened(false)
+#ifdef _WIN32
+    , fileHandle(nullptr), mappingHandle(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& filePath, bool allowFallback) {
+    close();
+
+    // "-" 表示标准输入，只能缓冲读取
+    if (filePath == "-") {
+        return allowFallback && readBuffered(filePath);
+    }
+
+#ifdef _WIN32
+    // 路径为 UTF-8，转换为宽字符以支持中文文件名
+    int wideLen = MultiByteToWideChar(CP_UTF8, 0, filePath.c_str(), -1, nullptr, 0);
+    std::wstring widePath(wideLen > 0 ? wideLen - 1 : 0, L'\0');
+    if (wideLen > 1) {
+        MultiByteToWideChar(CP_UTF8, 0, filePath.c_str(), -1, &widePath[0], wideLen);
+    }
+
+    HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (GetFileType(file) == FILE_TYPE_DISK && GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr) {
+            void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (view != nullptr) {
+                fileHandle = file;
+                mappingHandle = mapping;
+                mappedData = static_cast<const char*>(view);
+                mappedSize = static_cast<std::size_t>(fileSize.QuadPart);
+                mapped = true;
+                opened = true;
+                return true;
+            }
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    // 只映射普通文件，管道和设备文件退回缓冲读取
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        void* view = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view != MAP_FAILED) {
+#ifdef MADV_SEQUENTIAL
+            madvise(view, static_cast<std::size_t>(info.st_size), MADV_SEQUENTIAL);
+#endif
+            mappedData = static_cast<const char*>(view);
+            mappedSize = static_cast<std::size_t>(info.st_size);
+            mapped = true;
+            opened = true;
+            // 映射建立后即可关闭文件描述符
+            ::close(fd);
+            return true;
+        }
+    }
+    ::close(fd);
+#endif
+
+    return allowFallback && readBuffered(filePath);
+}
+
+bool MappedFile::readBuffered(const std::string& filePath) {
+    std::ifstream file;
+    std::istream* input = &std::cin;
+    if (filePath != "-") {
+        file.open(filePath, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        input = &file;
+    }
+
+    // 分块追加，避免 ostringstream 再额外拷贝一份
+    char block[64 * 1024];
+    while (input->read(block, sizeof(block)) || input->gcount() > 0) {
+        buffer.append(block, static_cast<std::size_t>(input->gcount()));
+    }
+    opened = true;
+    return true;
+}
+
+void MappedFile::close() {
+    if (mapped) {
+#ifdef _WIN32
+        UnmapViewOfFile(mappedData);
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+#else
+        munmap(const_cast<char*>(mappedData), mappedSize);
+#endif
+    }
+    mappedData = nullptr;
+    mappedSize = 0;
+    mapped = false;
+    opened = false;
+    buffer.clear();
+    buffer.shrink_to_fit();
+}
+
+std::string_view MappedFile::data() const {
+    if (mapped) {
+        return std::string_view(mappedData, mappedSize);
+    }
+    return std::string_view(buffer);
+}
+
+std::size_t MappedFile::size() const {
+    return mapped ? mappedSize : buffer.size();
+}
+
+bool MappedFile::isOpen() const {
+    return opened;
+}
+
+bool MappedFile::isMapped() const {
+    return mapped;
+}
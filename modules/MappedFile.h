@@ -0,0 +1,44 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// 只读文件输入源
+// 普通文件通过内存映射直接访问，不经过 ifstream 缓冲；
+// 管道、标准输入（路径为 "-"）或映射失败时退回到一次性缓冲读取
+class MappedFile {
+private:
+    const char* mappedData;
+    std::size_t mappedSize;
+    std::string buffer;     // 退回缓冲读取时的数据
+    bool mapped;
+    bool opened;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+
+    bool readBuffered(const std::string& filePath);
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 打开文件；allowFallback 为 false 时只尝试映射，无法映射时返回 false 且不读取数据
+    bool open(const std::string& filePath, bool allowFallback = true);
+    void close();
+
+    // 整个文件内容，在 close() 或析构之前有效
+    std::string_view data() const;
+    std::size_t size() const;
+
+    bool isOpen() const;
+    bool isMapped() const;
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,214 @@
+#include "RecordFormat.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+namespace {
+
+// 字段取值：没有 "" 转义时直接返回视图，否则还原到 scratch 中
+std::string_view fieldText(const std::vector<CsvField>& fields, std::size_t index, std::string& scratch) {
+    if (index >= fields.size()) {
+        return std::string_view();
+    }
+    if (!fields[index].hasEscapedQuotes) {
+        return fields[index].view();
+    }
+    scratch = fields[index].toString();
+    return scratch;
+}
+
+std::string fieldString(const std::vector<CsvField>& fields, std::size_t index) {
+    return index < fields.size() ? fields[index].toString() : std::string();
+}
+
+} // namespace
+
+RecordReader::RecordReader(std::string_view input)
+    : data(input), tokenizer(input), counted(0), lineNo(1) {
+}
+
+bool RecordReader::next(std::vector<CsvField>& fields) {
+    while (true) {
+        // 只统计上一条记录以来新增的换行，整体仍是一次线性扫描
+        std::size_t start = tokenizer.position();
+        if (start > counted) {
+            lineNo += static_cast<std::size_t>(
+                std::count(data.begin() + counted, data.begin() + start, '\n'));
+            counted = start;
+        }
+        if (!tokenizer.nextRecord(fields)) {
+            return false;
+        }
+        if (!CsvTokenizer::isBlankRecord(fields)) {
+            return true;
+        }
+    }
+}
+
+std::size_t RecordReader::lineNumber() const {
+    return lineNo;
+}
+
+// 旧文件没有 tags 字段，按无标签处理
+bool RecordFormat::parseEventRecord(const std::vector<CsvField>& fields, ScheduleEvent& event,
+                                    std::string& errorMsg) {
+    errorMsg.clear();
+
+    std::string scratch;
+    std::string_view idField = fieldText(fields, 0, scratch);
+    if (idField.empty()) {
+        return false;
+    }
+
+    int id = 0;
+    int weekday = 0;
+    long long start = 0;
+    long long end = 0;
+    if (!LineTokenizer::parseInt(idField, id)) {
+        errorMsg = "事件编号无效";
+        return false;
+    }
+    if (!LineTokenizer::parseInt(fieldText(fields, 4, scratch), weekday)) {
+        errorMsg = "星期字段无效";
+        return false;
+    }
+    if (!LineTokenizer::parseInt64(fieldText(fields, 5, scratch), start) ||
+        !LineTokenizer::parseInt64(fieldText(fields, 6, scratch), end)) {
+        errorMsg = "时间字段无效";
+        return false;
+    }
+
+    TimeSlot slot(std::chrono::system_clock::from_time_t(static_cast<std::time_t>(start)),
+                  std::chrono::system_clock::from_time_t(static_cast<std::time_t>(end)),
+                  fieldText(fields, 7, scratch) == "1");
+
+    int tags = 0;
+    std::string_view tagField = fieldText(fields, 8, scratch);
+    if (!tagField.empty() && !LineTokenizer::parseInt(tagField, tags)) {
+        errorMsg = "标签字段无效";
+        return false;
+    }
+
+    event = ScheduleEvent(id, fieldString(fields, 1), fieldString(fields, 2),
+                          fieldString(fields, 3), weekday, slot);
+    event.setTags(static_cast<unsigned int>(tags));
+    return true;
+}
+
+void RecordFormat::writeField(std::ostream& out, std::string_view text) {
+    if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+        out << text;
+        return;
+    }
+    out << '"';
+    for (char ch : text) {
+        if (ch == '"') {
+            out << '"';
+        }
+        out << ch;
+    }
+    out << '"';
+}
+
+void RecordFormat::writeEventRecord(std::ostream& out, const ScheduleEvent& event) {
+    auto startTime = std::chrono::system_clock::to_time_t(event.getTimeSlot().getStartTime());
+    auto endTime = std::chrono::system_clock::to_time_t(event.getTimeSlot().getEndTime());
+
+    out << event.getId() << ",";
+    writeField(out, event.getEventName());
+    out << ",";
+    writeField(out, event.getLocation());
+    out << ",";
+    writeField(out, event.getDescription());
+    out << ","
+        << event.getWeekday() << ","
+        << startTime << ","
+        << endTime << ","
+        << event.getTimeSlot().getIsCourse();
+    if (event.getTags() != 0) {
+        out << "," << event.getTags();
+    }
+    out << "\n";
+}
+
+bool RecordFormat::readUserFile(User& userData, const std::string& filePath, std::vector<LineError>& errors) {
+    MappedFile file;
+    if (!file.open(filePath)) {
+        return false;
+    }
+
+    //加载前清空，避免重复累计
+    userData.getCourses().clear();
+    userData.getPersonalSchedule().clear();
+    errors.clear();
+
+    RecordReader reader(file.data());
+    std::vector<CsvField> fields;
+    std::string_view section;
+    std::string errorMsg;
+    std::string scratch;
+
+    while (reader.next(fields)) {
+        std::string_view head = fieldText(fields, 0, scratch);
+
+        if (head.substr(0, 5) == "USER:") {
+            std::string name(head.substr(5));
+            // 旧文件的用户名不加引号，其中的逗号会被拆成多个字段
+            if (!fields[0].quoted) {
+                for (std::size_t i = 1; i < fields.size(); ++i) {
+                    name += ',';
+                    name += fields[i].view();
+                }
+            }
+            userData.setName(name);
+        } else if (head == "COURSES:" && fields.size() == 1) {
+            section = "COURSES";
+        } else if (head == "PERSONAL:" && fields.size() == 1) {
+            section = "PERSONAL";
+        } else {
+            // 解析事件，格式错误的记录记下来并跳过，不影响其余数据
+            ScheduleEvent event;
+            if (!parseEventRecord(fields, event, errorMsg)) {
+                if (!errorMsg.empty()) {
+                    errors.push_back({reader.lineNumber(), errorMsg});
+                }
+                continue;
+            }
+
+            if (section == "COURSES") {
+                userData.getCourses().addEvent(event);
+            } else if (section == "PERSONAL") {
+                userData.getPersonalSchedule().addEvent(event);
+            }
+        }
+    }
+
+    return true;
+}
+
+bool RecordFormat::writeUserFile(const User& userData, const std::string& filePath) {
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // 保存用户名
+    writeField(file, "USER:" + userData.getName());
+    file << "\n";
+    
+    // 保存课程
+    file << "COURSES:\n";
+    for (const auto& event : userData.getCourses().getAllEvents()) {
+        writeEventRecord(file, event);
+    }
+    
+    // 保存个人日程
+    file << "PERSONAL:\n";
+    for (const auto& event : userData.getPersonalSchedule().getAllEvents()) {
+        writeEventRecord(file, event);
+    }
+
+    file.close();
+    return file.good();
+}
@@ -0,0 +1,50 @@
+#ifndef RECORDFORMAT_H
+#define RECORDFORMAT_H
+
+#include "../datastructure/User.h"
+#include "CsvTokenizer.h"
+#include "LineTokenizer.h"
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 数据文件的记录格式（RFC 4180 CSV）
+// 事件记录：id,name,location,description,weekday,start,end,isCourse[,tags]
+// 用户文件：USER:name 一条，之后是 COURSES: 与 PERSONAL: 两段事件记录
+// 含逗号、引号或换行的字段加引号写出，旧文件中不含这些字符的记录格式不变
+class RecordFormat {
+public:
+    // 解析一条事件记录；id 为空的记录视为空记录，返回 false 且 errorMsg 为空
+    static bool parseEventRecord(const std::vector<CsvField>& fields, ScheduleEvent& event,
+                                 std::string& errorMsg);
+
+    // 写出一条事件记录（含换行），无标签时不写 tags 字段
+    static void writeEventRecord(std::ostream& out, const ScheduleEvent& event);
+
+    // 写出一个字段，需要时加引号并把内部的引号写成 ""
+    static void writeField(std::ostream& out, std::string_view text);
+
+    // 读写单个用户文件；读取时格式错误的记录记入 errors 并跳过
+    static bool readUserFile(User& userData, const std::string& filePath, std::vector<LineError>& errors);
+    static bool writeUserFile(const User& userData, const std::string& filePath);
+};
+
+// 按记录读取数据文件，跳过空行；字段可以带引号并跨行
+class RecordReader {
+private:
+    std::string_view data;
+    CsvTokenizer tokenizer;
+    std::size_t counted;    // 已统计换行的位置
+    std::size_t lineNo;     // counted 处的行号
+
+public:
+    explicit RecordReader(std::string_view input);
+
+    bool next(std::vector<CsvField>& fields);
+
+    // 最近一条记录首行的行号（从1开始）
+    std::size_t lineNumber() const;
+};
+
+#endif // RECORDFORMAT_H
@@ -0,0 +1,216 @@
+#include "RoomCalendar.h"
+#include "../datastructure/TimeConvert.h"
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+const std::time_t SECONDS_PER_WEEK = 7 * 24 * 3600;
+
+std::time_t floorDiv(std::time_t a, std::time_t b) {
+    std::time_t q = a / b;
+    if ((a % b != 0) && ((a < 0) != (b < 0))) {
+        q--;
+    }
+    return q;
+}
+
+} // namespace
+
+RoomCalendar::RoomCalendar() {
+}
+
+RoomCalendar::RoomHandle RoomCalendar::addRoom(const std::string& name, int capacity) {
+    auto inserted = roomByName.emplace(name, rooms.size());
+    RoomHandle handle = inserted.first->second;
+    if (inserted.second) {
+        rooms.push_back(Room{name, capacity});
+        roomIndexes.emplace_back();
+    } else if (capacity != 0 && rooms[handle].capacity != capacity) {
+        rooms[handle].capacity = capacity;
+        roomsByCapacity.erase(std::find(roomsByCapacity.begin(), roomsByCapacity.end(), handle));
+    } else {
+        return handle;
+    }
+
+    auto position = std::upper_bound(roomsByCapacity.begin(), roomsByCapacity.end(), handle,
+                                     [this](RoomHandle a, RoomHandle b) {
+                                         return rooms[a].capacity < rooms[b].capacity;
+                                     });
+    roomsByCapacity.insert(position, handle);
+    return handle;
+}
+
+RoomCalendar::RoomHandle RoomCalendar::findRoom(const std::string& name) const {
+    auto it = roomByName.find(name);
+    return it == roomByName.end() ? invalidRoom : it->second;
+}
+
+const RoomCalendar::Room& RoomCalendar::getRoom(RoomHandle handle) const {
+    return rooms[handle];
+}
+
+std::size_t RoomCalendar::size() const {
+    return rooms.size();
+}
+
+void RoomCalendar::occupy(std::uint64_t owner, const std::string& roomName,
+                          std::time_t start, std::time_t end, bool weekly) {
+    release(owner);
+    if (roomName.empty() || start >= end) {
+        return;
+    }
+
+    RoomHandle room = addRoom(roomName);
+    std::uint32_t bookingId;
+    if (!freeBookings.empty()) {
+        bookingId = freeBookings.back();
+        freeBookings.pop_back();
+        bookings[bookingId] = Booking{room, owner, start, end, weekly};
+    } else {
+        bookingId = static_cast<std::uint32_t>(bookings.size());
+        bookings.push_back(Booking{room, owner, start, end, weekly});
+    }
+    roomIndexes[room].insert(bookingId, start, end, weekly);
+    allBookings.insert(bookingId, start, end, weekly);
+    bookingByOwner[owner] = bookingId;
+}
+
+void RoomCalendar::releaseBooking(std::uint32_t bookingId) {
+    roomIndexes[bookings[bookingId].room].remove(bookingId);
+    allBookings.remove(bookingId);
+    freeBookings.push_back(bookingId);
+}
+
+void RoomCalendar::release(std::uint64_t owner) {
+    auto it = bookingByOwner.find(owner);
+    if (it == bookingByOwner.end()) {
+        return;
+    }
+    releaseBooking(it->second);
+    bookingByOwner.erase(it);
+}
+
+void RoomCalendar::releaseRange(std::uint64_t first, std::uint64_t last) {
+    auto begin = bookingByOwner.lower_bound(first);
+    auto end = bookingByOwner.upper_bound(last);
+    for (auto it = begin; it != end; ++it) {
+        releaseBooking(it->second);
+    }
+    bookingByOwner.erase(begin, end);
+}
+
+void RoomCalendar::clear() {
+    // 房间本身保留，只清空占用
+    for (auto& index : roomIndexes) {
+        index.clear();
+    }
+    allBookings.clear();
+    bookings.clear();
+    freeBookings.clear();
+    bookingByOwner.clear();
+}
+
+bool RoomCalendar::fits(RoomHandle handle, int minCapacity) const {
+    return minCapacity <= 0 || rooms[handle].capacity >= minCapacity;
+}
+
+std::time_t RoomCalendar::longestGap(RoomHandle handle, std::time_t from, std::time_t to,
+                                     std::uint64_t ignoreFirst, std::uint64_t ignoreLast,
+                                     std::time_t& gapFrom, std::time_t& gapTo) const {
+    // 取出与查询区间相交的占用（每周重复的展开为具体的发生），裁剪后按开始时间扫描
+    std::vector<std::pair<std::time_t, std::time_t>> busy;
+    for (std::uint32_t bookingId : roomIndexes[handle].overlappingIds(from, to)) {
+        const Booking& booking = bookings[bookingId];
+        if (booking.owner >= ignoreFirst && booking.owner <= ignoreLast) {
+            continue;
+        }
+        if (!booking.weekly) {
+            busy.emplace_back(std::max(from, booking.start), std::min(to, booking.end));
+            continue;
+        }
+        // 按本地墙上时间逐周展开，与索引的周内相位一致，跨夏令时仍是同一星期和时刻
+        long long wallStart, wallFrom;
+        if (!toLocalWallSeconds(booking.start, wallStart) || !toLocalWallSeconds(from, wallFrom)) {
+            continue;
+        }
+        std::time_t length = booking.end - booking.start;
+        // 多退一周，抵消夏令时造成的一小时误差
+        std::time_t first = floorDiv(static_cast<std::time_t>(wallFrom - wallStart) - length, SECONDS_PER_WEEK) - 1;
+        for (std::time_t n = first;; ++n) {
+            std::time_t start = fromLocalWallSeconds(wallStart + n * SECONDS_PER_WEEK);
+            if (start == static_cast<std::time_t>(-1) || start >= to) {
+                break;
+            }
+            if (start + length > from) {
+                busy.emplace_back(std::max(from, start), std::min(to, start + length));
+            }
+        }
+    }
+    std::sort(busy.begin(), busy.end());
+
+    std::time_t best = 0;
+    std::time_t cursor = from;
+    auto consider = [&](std::time_t start, std::time_t end) {
+        if (end - start > best) {
+            best = end - start;
+            gapFrom = start;
+            gapTo = end;
+        }
+    };
+    for (const auto& interval : busy) {
+        if (interval.first > cursor) {
+            consider(cursor, interval.first);
+        }
+        cursor = std::max(cursor, interval.second);
+    }
+    if (cursor < to) {
+        consider(cursor, to);
+    }
+    return best;
+}
+
+bool RoomCalendar::findFreeRoom(std::time_t from, std::time_t to, std::time_t minSeconds, int minCapacity,
+                                std::uint64_t ignoreFirst, std::uint64_t ignoreLast,
+                                RoomHandle& room, std::time_t& freeFrom, std::time_t& freeTo) const {
+    if (to - from < std::max<std::time_t>(1, minSeconds) || rooms.empty()) {
+        return false;
+    }
+
+    // 总索引一次查出在该时段有占用的房间
+    std::vector<char> busyRoom(rooms.size(), 0);
+    for (std::uint32_t bookingId : allBookings.overlappingIds(from, to)) {
+        const Booking& booking = bookings[bookingId];
+        if (booking.owner < ignoreFirst || booking.owner > ignoreLast) {
+            busyRoom[booking.room] = 1;
+        }
+    }
+
+    // 整段空闲的房间中取容量最小的
+    for (RoomHandle handle : roomsByCapacity) {
+        if (!busyRoom[handle] && fits(handle, minCapacity)) {
+            room = handle;
+            freeFrom = from;
+            freeTo = to;
+            return true;
+        }
+    }
+
+    // 只需在有占用的房间中找最长空闲段
+    std::time_t best = 0;
+    for (RoomHandle handle : roomsByCapacity) {
+        if (!busyRoom[handle] || !fits(handle, minCapacity)) {
+            continue;
+        }
+        std::time_t gapFrom = 0;
+        std::time_t gapTo = 0;
+        std::time_t gap = longestGap(handle, from, to, ignoreFirst, ignoreLast, gapFrom, gapTo);
+        if (gap > best) {
+            best = gap;
+            room = handle;
+            freeFrom = gapFrom;
+            freeTo = gapTo;
+        }
+    }
+    return best >= std::max<std::time_t>(1, minSeconds);
+}
@@ -0,0 +1,79 @@
+#ifndef ROOMCALENDAR_H
+#define ROOMCALENDAR_H
+
+#include "EventTimeIndex.h"
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 房间日历：按地点记录房间被哪些事件占用
+// 每个房间有自己的时间索引，另有一个覆盖全部房间的索引用于剪枝：
+// 查询时先用总索引找出在该时段有占用的房间，其余房间整段空闲，无需逐个查询
+class RoomCalendar {
+public:
+    // 房间句柄：房间在列表中的下标，房间只增不删
+    using RoomHandle = std::size_t;
+    static constexpr RoomHandle invalidRoom = static_cast<RoomHandle>(-1);
+
+    struct Room {
+        std::string name;
+        int capacity;       // 0 表示未知
+    };
+
+    RoomCalendar();
+
+    // 登记房间，已存在时只更新容量（capacity 为 0 时保留原值）
+    RoomHandle addRoom(const std::string& name, int capacity = 0);
+    RoomHandle findRoom(const std::string& name) const;
+    const Room& getRoom(RoomHandle handle) const;
+    std::size_t size() const;
+
+    // 占用房间，房间不存在时自动登记；owner 为占用来源（如事件）的编号，同一 owner 再次占用时替换
+    void occupy(std::uint64_t owner, const std::string& roomName,
+                std::time_t start, std::time_t end, bool weekly);
+    void release(std::uint64_t owner);
+
+    // 释放 owner 在 [first, last] 范围内的全部占用
+    void releaseRange(std::uint64_t first, std::uint64_t last);
+    void clear();
+
+    // 在 [from, to) 内找一间空闲至少 minSeconds 的房间，容量不小于 minCapacity（为 0 时不限）
+    // 来源在 [ignoreFirst, ignoreLast] 内的占用不计（如教师自己办公时间占用的办公室）
+    // 优先选整段空闲、容量最小的房间；都有占用时选空闲段最长的，freeFrom/freeTo 为该空闲段
+    bool findFreeRoom(std::time_t from, std::time_t to, std::time_t minSeconds, int minCapacity,
+                      std::uint64_t ignoreFirst, std::uint64_t ignoreLast,
+                      RoomHandle& room, std::time_t& freeFrom, std::time_t& freeTo) const;
+
+private:
+    struct Booking {
+        RoomHandle room;
+        std::uint64_t owner;
+        std::time_t start;
+        std::time_t end;
+        bool weekly;
+    };
+
+    std::vector<Room> rooms;
+    std::unordered_map<std::string, RoomHandle> roomByName;
+    std::vector<RoomHandle> roomsByCapacity;        // 按容量升序，未知容量在前
+
+    std::vector<EventTimeIndex> roomIndexes;        // 每个房间一个，按占用编号索引
+    EventTimeIndex allBookings;                     // 全部房间的占用
+    std::vector<Booking> bookings;                  // 按占用编号存放
+    std::vector<std::uint32_t> freeBookings;        // 已释放、可复用的占用编号
+    std::map<std::uint64_t, std::uint32_t> bookingByOwner;
+
+    void releaseBooking(std::uint32_t bookingId);
+    bool fits(RoomHandle handle, int minCapacity) const;
+
+    // 房间在 [from, to) 内最长的空闲段，忽略来源在 [ignoreFirst, ignoreLast] 内的占用
+    std::time_t longestGap(RoomHandle handle, std::time_t from, std::time_t to,
+                           std::uint64_t ignoreFirst, std::uint64_t ignoreLast,
+                           std::time_t& gapFrom, std::time_t& gapTo) const;
+};
+
+#endif // ROOMCALENDAR_H
@@ -0,0 +1,29 @@
+#ifndef SCHEDULECHANGE_H
+#define SCHEDULECHANGE_H
+
+#include "../datastructure/ScheduleEvent.h"
+#include <vector>
+
+// 学生日程中一个事件的变化，事件自带时间段，订阅者据此只更新受影响的周和单元格
+struct EventChange {
+    enum class Kind {
+        Inserted,
+        Removed,
+        Modified
+    };
+
+    Kind kind;
+    bool course;                // true 为课程表，false 为个人日程
+    ScheduleEvent event;        // 插入/修改后的事件；删除时为被删除的事件
+    ScheduleEvent previous;     // 仅 Modified 有效：修改前的事件
+};
+
+// 一次通知中的全部变化，按发生顺序排列
+struct ChangeSet {
+    bool reset = false;                 // 整个用户被替换（加载、切换用户），订阅者应整体重建
+    std::vector<EventChange> changes;
+
+    bool empty() const { return !reset && changes.empty(); }
+};
+
+#endif // SCHEDULECHANGE_H
@@ -1,6 +1,11 @@
 #include "SchedulerLogic.h"
+#include "AvailableSlotGenerator.h"
+#include "WeekLayout.h"
+#include "../datastructure/TimeConvert.h"
 #include <algorithm>
 #include <ctime>
+#include <map>
+#include <queue>
 
 // 辅助函数：将 time_point 的秒数归零
 static std::chrono::system_clock::time_point roundSecondsToZero(const std::chrono::system_clock::time_point& tp) {
@@ -13,15 +18,23 @@ static std::chrono::system_clock::time_point roundSecondsToZero(const std::chron
 std::vector<TimeSlot> SchedulerLogic::findAvailableSlots(
     const Schedule& studentSchedule,
     const Schedule& officeHour,
-    int weekOffset) {
-
-    std::vector<TimeSlot> availableSlots;
+    int weekOffset,
+    int minDurationMinutes) {
 
     // 获得当前周的日程
     const auto studentEvents = studentSchedule.getEventsForWeekCopy(weekOffset);
     // 对于老师的office time 全部归一化到目标周
     const auto officeEvents  = officeHour.getEventsForWeekCopy(weekOffset);
 
+    return subtractBusy(studentEvents, officeEvents, minDurationMinutes);
+}
+
+std::vector<TimeSlot> SchedulerLogic::subtractBusy(
+    const std::vector<ScheduleEvent>& studentEvents,
+    const std::vector<ScheduleEvent>& officeEvents,
+    int minDurationMinutes) {
+
+    std::vector<TimeSlot> availableSlots;
 
     for (const auto& officeEvent : officeEvents) {
         std::vector<TimeSlot> slots = { officeEvent.getTimeSlot() };
@@ -52,7 +65,7 @@ std::vector<TimeSlot> SchedulerLogic::findAvailableSlots(
             if (slots.empty()) break;
         }
         for (const auto& slot : slots) {
-            if (slot.durationMinutes() > 30) {  // 忽略时长小于30分钟的空闲时间
+            if (slot.durationMinutes() >= minDurationMinutes) {  // 忽略过短的空闲时间
                 availableSlots.push_back(slot);
             }
         }
@@ -60,3 +73,188 @@ std::vector<TimeSlot> SchedulerLogic::findAvailableSlots(
     return availableSlots;
 }
 
+namespace {
+
+// 学生某一周的事件，按开始时间和结束时间分别排序，用于查找时间段前后最近的事件
+struct BusyEdges {
+    std::vector<std::time_t> starts;
+    std::vector<std::time_t> ends;
+};
+
+// 堆顶为当前 k 个中最差的：得分低者更差，同分时开始晚者更差
+struct WorseFirst {
+    bool operator()(const SchedulerLogic::RankedSlot& a, const SchedulerLogic::RankedSlot& b) const {
+        if (a.score != b.score) {
+            return a.score > b.score;
+        }
+        return a.slot.getStartTime() < b.slot.getStartTime();
+    }
+};
+
+} // namespace
+
+std::vector<SchedulerLogic::RankedSlot> SchedulerLogic::recommendSlots(
+    const Schedule& studentSchedule,
+    const std::vector<Schedule>& officeHours,
+    int firstWeek,
+    int weekCount,
+    const Preferences& preferences,
+    std::size_t k) {
+
+    std::vector<RankedSlot> ranked;
+    if (k == 0 || weekCount <= 0) {
+        return ranked;
+    }
+
+    AvailableSlotGenerator generator(studentSchedule, officeHours, firstWeek, weekCount,
+                                     preferences.minDurationMinutes);
+    AvailableSlot candidate;
+
+    WeekLayoutBuilder builder;
+    std::time_t horizonStart = std::chrono::system_clock::to_time_t(builder.timeAt(firstWeek, 0, 0));
+    std::time_t horizonEnd = std::chrono::system_clock::to_time_t(builder.timeAt(firstWeek + weekCount, 0, 0));
+    double horizon = static_cast<double>(std::max<std::time_t>(1, horizonEnd - horizonStart));
+    // 在查询的周范围内线性递减
+    auto earliestScore = [&](std::time_t start) {
+        double position = std::min(1.0, std::max(0.0, (start - horizonStart) / horizon));
+        return preferences.earliestWeight * (1.0 - position);
+    };
+
+    bool onlyEarliest = preferences.longestWeight == 0 && preferences.preferredHoursWeight == 0 &&
+                        preferences.adjacentWeight == 0;
+    if (onlyEarliest) {
+        // 生成器按时间先后产出，前 k 个就是得分最高的 k 个
+        while (ranked.size() < k && generator.next(candidate)) {
+            std::time_t start = std::chrono::system_clock::to_time_t(candidate.slot.getStartTime());
+            ranked.push_back(RankedSlot{candidate.source, candidate.weekOffset, candidate.slot,
+                                        earliestScore(start)});
+        }
+        return ranked;
+    }
+
+    int preferredFrom = preferences.preferredStartHour * 60;
+    int preferredTo = preferences.preferredEndHour * 60;
+
+    std::map<int, BusyEdges> busyByWeek;
+    auto busyEdges = [&](int week) -> const BusyEdges& {
+        auto found = busyByWeek.find(week);
+        if (found == busyByWeek.end()) {
+            // 时间段按周先后产出，更早的周不会再用到
+            busyByWeek.erase(busyByWeek.begin(), busyByWeek.lower_bound(week));
+            BusyEdges edges;
+            for (const auto& event : studentSchedule.getEventsForWeekCopy(week)) {
+                edges.starts.push_back(std::chrono::system_clock::to_time_t(event.getTimeSlot().getStartTime()));
+                edges.ends.push_back(std::chrono::system_clock::to_time_t(event.getTimeSlot().getEndTime()));
+            }
+            std::sort(edges.starts.begin(), edges.starts.end());
+            std::sort(edges.ends.begin(), edges.ends.end());
+            found = busyByWeek.emplace(week, std::move(edges)).first;
+        }
+        return found->second;
+    };
+
+    std::priority_queue<RankedSlot, std::vector<RankedSlot>, WorseFirst> best;
+    while (generator.next(candidate)) {
+        std::time_t start = std::chrono::system_clock::to_time_t(candidate.slot.getStartTime());
+        std::time_t end = std::chrono::system_clock::to_time_t(candidate.slot.getEndTime());
+        double minutes = static_cast<double>(candidate.slot.durationMinutes());
+        double score = 0;
+
+        if (preferences.earliestWeight != 0) {
+            score += earliestScore(start);
+        }
+        if (preferences.longestWeight != 0) {
+            score += preferences.longestWeight * std::min(1.0, minutes / 240.0);
+        }
+        if (preferences.preferredHoursWeight != 0 && minutes > 0) {
+            std::tm startTm{};
+            if (toLocalTm(start, startTm)) {
+                int from = startTm.tm_hour * 60 + startTm.tm_min;
+                int to = from + static_cast<int>(minutes);
+                int overlap = std::max(0, std::min(to, preferredTo) - std::max(from, preferredFrom));
+                score += preferences.preferredHoursWeight * (overlap / minutes);
+            }
+        }
+        if (preferences.adjacentWeight != 0) {
+            // 前一个事件的结束和后一个事件的开始，取较近的一侧
+            const BusyEdges& edges = busyEdges(candidate.weekOffset);
+            double gap = -1;
+            auto before = std::upper_bound(edges.ends.begin(), edges.ends.end(), start);
+            if (before != edges.ends.begin()) {
+                gap = static_cast<double>(start - *(before - 1));
+            }
+            auto after = std::lower_bound(edges.starts.begin(), edges.starts.end(), end);
+            if (after != edges.starts.end()) {
+                double next = static_cast<double>(*after - end);
+                gap = gap < 0 ? next : std::min(gap, next);
+            }
+            if (gap >= 0) {
+                score += preferences.adjacentWeight * std::max(0.0, 1.0 - gap / 7200.0);
+            }
+        }
+
+        RankedSlot entry{candidate.source, candidate.weekOffset, candidate.slot, score};
+        if (best.size() < k) {
+            best.push(entry);
+        } else if (WorseFirst()(entry, best.top())) {
+            best.pop();
+            best.push(entry);
+        }
+    }
+
+    // 堆中从差到好依次弹出，倒序即为从高到低
+    ranked.reserve(best.size());
+    while (!best.empty()) {
+        ranked.push_back(best.top());
+        best.pop();
+    }
+    std::reverse(ranked.begin(), ranked.end());
+    return ranked;
+}
+
+std::vector<SchedulerLogic::RoomSlot> SchedulerLogic::findSlotsWithRooms(
+    const Schedule& studentSchedule,
+    const Schedule& officeHour,
+    int weekOffset,
+    const RoomCalendar& rooms,
+    std::uint64_t ignoreFirst,
+    std::uint64_t ignoreLast,
+    int minDurationMinutes,
+    int minCapacity) {
+
+    std::vector<RoomSlot> result;
+    std::time_t minSeconds = std::max<std::time_t>(60, static_cast<std::time_t>(minDurationMinutes) * 60);
+
+    std::vector<std::pair<std::time_t, std::time_t>> pieces;
+    for (const auto& common : findAvailableSlots(studentSchedule, officeHour, weekOffset, minDurationMinutes)) {
+        pieces.emplace_back(std::chrono::system_clock::to_time_t(common.getStartTime()),
+                            std::chrono::system_clock::to_time_t(common.getEndTime()));
+
+        // 每分配一间房间至少用掉 minSeconds，剩余部分一定会处理完
+        while (!pieces.empty()) {
+            std::pair<std::time_t, std::time_t> piece = pieces.back();
+            pieces.pop_back();
+            if (piece.second - piece.first < minSeconds) {
+                continue;
+            }
+
+            RoomCalendar::RoomHandle room;
+            std::time_t freeFrom;
+            std::time_t freeTo;
+            if (!rooms.findFreeRoom(piece.first, piece.second, minSeconds, minCapacity, ignoreFirst, ignoreLast,
+                                    room, freeFrom, freeTo)) {
+                continue;
+            }
+            result.push_back(RoomSlot{TimeSlot(std::chrono::system_clock::from_time_t(freeFrom),
+                                               std::chrono::system_clock::from_time_t(freeTo), false),
+                                      room});
+            pieces.emplace_back(piece.first, freeFrom);
+            pieces.emplace_back(freeTo, piece.second);
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const RoomSlot& a, const RoomSlot& b) {
+        return a.slot.getStartTime() < b.slot.getStartTime();
+    });
+    return result;
+}
@@ -3,15 +3,76 @@
 
 #include "../datastructure/Schedule.h"
 #include "../datastructure/TimeSlot.h"
+#include "RoomCalendar.h"
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 class SchedulerLogic {
 public:
+    // 默认只保留超过 30 分钟的空闲时间
+    static const int DEFAULT_MIN_DURATION_MINUTES = 31;
+
+    // 推荐时间段的偏好：每项得分在 0~1 之间，总分为加权和，权重为 0 的项不参与
+    struct Preferences {
+        int minDurationMinutes = DEFAULT_MIN_DURATION_MINUTES;
+        double earliestWeight = 1.0;        // 越早越好（在查询的周范围内线性递减）
+        double longestWeight = 0.0;         // 越长越好（4 小时及以上记满分）
+        double preferredHoursWeight = 0.0;  // 落在偏好时段内的比例
+        int preferredStartHour = 9;
+        int preferredEndHour = 18;
+        double adjacentWeight = 0.0;        // 与学生前后事件的间隔越小越好（2 小时以上记 0 分）
+    };
+
+    // 推荐结果，source 为 officeHours 中的下标
+    struct RankedSlot {
+        std::size_t source;
+        int weekOffset;
+        TimeSlot slot;
+        double score;
+    };
+
+    // 带房间的空闲时间段
+    struct RoomSlot {
+        TimeSlot slot;
+        RoomCalendar::RoomHandle room;
+    };
+
     static std::vector<TimeSlot> findAvailableSlots(
         const Schedule& studentSchedule,
         const Schedule& officeHour,
-        int weekOffset);
+        int weekOffset,
+        int minDurationMinutes = DEFAULT_MIN_DURATION_MINUTES);
+
+    // 单周的计算：从办公时间中扣除学生的事件，两者都应已归一化到同一周
+    static std::vector<TimeSlot> subtractBusy(
+        const std::vector<ScheduleEvent>& studentEvents,
+        const std::vector<ScheduleEvent>& officeEvents,
+        int minDurationMinutes = DEFAULT_MIN_DURATION_MINUTES);
+
+    // 在 [firstWeek, firstWeek + weekCount) 周内按偏好评分，返回得分最高的 k 个（从高到低）
+    // 候选逐个经过大小为 k 的堆，不对全部候选排序；只看“最早”时取前 k 个即可提前结束
+    static std::vector<RankedSlot> recommendSlots(
+        const Schedule& studentSchedule,
+        const std::vector<Schedule>& officeHours,
+        int firstWeek,
+        int weekCount,
+        const Preferences& preferences,
+        std::size_t k = 3);
+
+    // 学生、教师和房间三方都空闲的时间段，按开始时间排列
+    // 先求学生与教师的共同空闲，再逐段分配房间：整段有空房时直接使用，
+    // 否则取空闲最长的房间，剩余的前后部分继续分配其他房间
+    // 来源在 [ignoreFirst, ignoreLast] 内的房间占用不计，用于排除该教师自己的办公时间
+    static std::vector<RoomSlot> findSlotsWithRooms(
+        const Schedule& studentSchedule,
+        const Schedule& officeHour,
+        int weekOffset,
+        const RoomCalendar& rooms,
+        std::uint64_t ignoreFirst,
+        std::uint64_t ignoreLast,
+        int minDurationMinutes = DEFAULT_MIN_DURATION_MINUTES,
+        int minCapacity = 0);
 };
 
 #endif // SCHEDULERLOGIC_H
-
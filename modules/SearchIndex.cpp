@@ -0,0 +1,435 @@
+#include "SearchIndex.h"
+#include <algorithm>
+#include <initializer_list>
+
+namespace {
+
+// 失效文档超过此数量且超过一半时压缩重建
+const std::size_t COMPACT_MIN_DEAD = 1024;
+
+// 解码 UTF-8，非法字节按单字节字符处理
+// offsets[i] 为第 i 个字符的起始字节，末尾额外存放 text.size()
+void decodeUtf8(const std::string& text, std::vector<char32_t>& codePoints,
+                std::vector<std::size_t>& offsets) {
+    codePoints.clear();
+    offsets.clear();
+    std::size_t i = 0;
+    while (i < text.size()) {
+        unsigned char lead = static_cast<unsigned char>(text[i]);
+        std::size_t length = 1;
+        char32_t value = lead;
+        if (lead >= 0xF0 && lead < 0xF8) {
+            length = 4;
+            value = lead & 0x07;
+        } else if (lead >= 0xE0) {
+            length = 3;
+            value = lead & 0x0F;
+        } else if (lead >= 0xC0) {
+            length = 2;
+            value = lead & 0x1F;
+        }
+
+        if (length > 1 && i + length <= text.size()) {
+            for (std::size_t k = 1; k < length; ++k) {
+                value = (value << 6) | (static_cast<unsigned char>(text[i + k]) & 0x3F);
+            }
+        } else {
+            length = 1;
+            value = lead;
+        }
+        codePoints.push_back(value);
+        offsets.push_back(i);
+        i += length;
+    }
+    offsets.push_back(text.size());
+}
+
+bool isSpace(char32_t c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == 0x3000;
+}
+
+// 词的分隔符：空白、ASCII 标点、常用中文标点
+bool isSeparator(char32_t c) {
+    if (c < 128) {
+        bool alnum = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        return !alnum;
+    }
+    return (c >= 0x3000 && c <= 0x303F) ||
+           (c >= 0xFF01 && c <= 0xFF0F) ||
+           (c >= 0xFF1A && c <= 0xFF20);
+}
+
+std::uint64_t bigramKey(char32_t first, char32_t second) {
+    return (static_cast<std::uint64_t>(first) << 32) | static_cast<std::uint64_t>(second);
+}
+
+void appendPosting(std::vector<std::uint32_t>& postings, std::uint32_t slot) {
+    // 同一文档按递增顺序加入，只需与末尾比较即可去重，列表保持有序
+    if (postings.empty() || postings.back() != slot) {
+        postings.push_back(slot);
+    }
+}
+
+} // namespace
+
+SearchIndex::SearchIndex() : deadCount(0) {
+    trie.emplace_back();
+}
+
+std::uint64_t SearchIndex::documentKey(SearchHit::Kind kind, int id) {
+    // 课程和个人日程共用事件编号空间
+    std::uint64_t space = (kind == SearchHit::Kind::Professor) ? 1 : 0;
+    return (space << 32) | static_cast<std::uint32_t>(id);
+}
+
+std::string SearchIndex::normalize(const std::string& text) {
+    std::string result = text;
+    for (auto& c : result) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+    return result;
+}
+
+void SearchIndex::addEvent(const ScheduleEvent& event) {
+    SearchHit::Kind kind = event.getTimeSlot().getIsCourse() ? SearchHit::Kind::Course
+                                                             : SearchHit::Kind::Personal;
+    std::vector<Field> fields;
+    fields.push_back({normalize(event.getEventName()), 3});
+    fields.push_back({normalize(event.getLocation()), 2});
+    fields.push_back({normalize(event.getDescription()), 1});
+
+    // 标签名称也可搜索
+    std::string tagText;
+    for (int bit = 0; bit < EVENT_TAG_COUNT; ++bit) {
+        if (event.getTags() & (1u << bit)) {
+            tagText += eventTagName(bit);
+            tagText += ' ';
+        }
+    }
+    if (!tagText.empty()) {
+        fields.push_back({tagText, 2});
+    }
+    addDocument(kind, event.getId(), event.getEventName(), std::move(fields));
+}
+
+void SearchIndex::removeEvent(int eventId) {
+    removeDocument(SearchHit::Kind::Course, eventId);
+}
+
+void SearchIndex::addProfessor(std::size_t handle, const Professor& prof) {
+    std::vector<Field> fields;
+    fields.push_back({normalize(prof.getName()), 3});
+    fields.push_back({normalize(prof.getEmail()), 2});
+    std::string label = prof.getName();
+    if (!prof.getEmail().empty()) {
+        label += " <" + prof.getEmail() + ">";
+    }
+    addDocument(SearchHit::Kind::Professor, static_cast<int>(handle), label, std::move(fields));
+}
+
+void SearchIndex::clearEvents() {
+    for (auto& document : documents) {
+        if (document.alive && document.kind != SearchHit::Kind::Professor) {
+            slotByKey.erase(documentKey(document.kind, document.id));
+            document.alive = false;
+            document.fields.clear();
+            deadCount++;
+        }
+    }
+    compact();
+}
+
+void SearchIndex::clearProfessors() {
+    for (auto& document : documents) {
+        if (document.alive && document.kind == SearchHit::Kind::Professor) {
+            slotByKey.erase(documentKey(document.kind, document.id));
+            document.alive = false;
+            document.fields.clear();
+            deadCount++;
+        }
+    }
+    compact();
+}
+
+std::size_t SearchIndex::size() const {
+    return documents.size() - deadCount;
+}
+
+void SearchIndex::addDocument(SearchHit::Kind kind, int id, const std::string& label,
+                              std::vector<Field> fields) {
+    removeDocument(kind, id);
+
+    std::uint32_t slot = static_cast<std::uint32_t>(documents.size());
+    documents.push_back({kind, id, label, std::move(fields), true});
+    slotByKey[documentKey(kind, id)] = slot;
+    indexDocument(slot);
+}
+
+void SearchIndex::removeDocument(SearchHit::Kind kind, int id) {
+    auto it = slotByKey.find(documentKey(kind, id));
+    if (it == slotByKey.end()) {
+        return;
+    }
+
+    // 倒排表和前缀树中的旧条目留待压缩时清理，查询时跳过失效文档
+    Document& document = documents[it->second];
+    document.alive = false;
+    document.fields.clear();
+    document.label.clear();
+    slotByKey.erase(it);
+    deadCount++;
+
+    if (deadCount >= COMPACT_MIN_DEAD && deadCount * 2 > documents.size()) {
+        compact();
+    }
+}
+
+void SearchIndex::indexDocument(std::uint32_t slot) {
+    std::vector<char32_t> codePoints;
+    std::vector<std::size_t> offsets;
+    for (const auto& field : documents[slot].fields) {
+        decodeUtf8(field.text, codePoints, offsets);
+
+        // 相邻两字建立倒排（不跨空白）
+        for (std::size_t i = 0; i + 1 < codePoints.size(); ++i) {
+            if (isSpace(codePoints[i]) || isSpace(codePoints[i + 1])) {
+                continue;
+            }
+            appendPosting(bigramPostings[bigramKey(codePoints[i], codePoints[i + 1])], slot);
+        }
+
+        // 中文词不切分，整段只是前缀树中的一个词，单字另建倒排
+        for (char32_t c : codePoints) {
+            if (c >= 128 && !isSeparator(c)) {
+                appendPosting(unigramPostings[c], slot);
+            }
+        }
+
+        // 按分隔符切词，加入前缀树
+        std::size_t tokenStart = 0;
+        for (std::size_t i = 0; i <= codePoints.size(); ++i) {
+            if (i < codePoints.size() && !isSeparator(codePoints[i])) {
+                continue;
+            }
+            if (i > tokenStart) {
+                insertToken(field.text.substr(offsets[tokenStart], offsets[i] - offsets[tokenStart]), slot);
+            }
+            tokenStart = i + 1;
+        }
+    }
+}
+
+void SearchIndex::insertToken(const std::string& token, std::uint32_t slot) {
+    std::uint32_t node = 0;
+    for (char ch : token) {
+        unsigned char byte = static_cast<unsigned char>(ch);
+        auto& children = trie[node].children;
+        auto it = std::lower_bound(children.begin(), children.end(), std::make_pair(byte, std::uint32_t(0)));
+        if (it != children.end() && it->first == byte) {
+            node = it->second;
+        } else {
+            std::uint32_t child = static_cast<std::uint32_t>(trie.size());
+            children.insert(it, std::make_pair(byte, child));
+            trie.emplace_back();
+            node = child;
+        }
+    }
+    appendPosting(trie[node].documents, slot);
+}
+
+void SearchIndex::collectPrefix(const std::string& prefix, std::vector<std::uint32_t>& result) const {
+    std::uint32_t node = 0;
+    for (char ch : prefix) {
+        unsigned char byte = static_cast<unsigned char>(ch);
+        const auto& children = trie[node].children;
+        auto it = std::lower_bound(children.begin(), children.end(), std::make_pair(byte, std::uint32_t(0)));
+        if (it == children.end() || it->first != byte) {
+            return;
+        }
+        node = it->second;
+    }
+
+    // 深度优先收集子树中的全部文档，结果作为候选集时不能截断
+    std::vector<std::uint32_t> stack(1, node);
+    while (!stack.empty()) {
+        std::uint32_t current = stack.back();
+        stack.pop_back();
+        for (std::uint32_t slot : trie[current].documents) {
+            if (documents[slot].alive) {
+                result.push_back(slot);
+            }
+        }
+        for (const auto& child : trie[current].children) {
+            stack.push_back(child.second);
+        }
+    }
+}
+
+void SearchIndex::compact() {
+    std::vector<Document> alive;
+    alive.reserve(documents.size() - deadCount);
+    for (auto& document : documents) {
+        if (document.alive) {
+            alive.push_back(std::move(document));
+        }
+    }
+
+    documents = std::move(alive);
+    deadCount = 0;
+    slotByKey.clear();
+    bigramPostings.clear();
+    unigramPostings.clear();
+    trie.clear();
+    trie.emplace_back();
+
+    for (std::uint32_t slot = 0; slot < documents.size(); ++slot) {
+        slotByKey[documentKey(documents[slot].kind, documents[slot].id)] = slot;
+        indexDocument(slot);
+    }
+}
+
+int SearchIndex::scoreTerm(const Document& document, const std::string& term) const {
+    int score = 0;
+    for (const auto& field : document.fields) {
+        std::size_t pos = field.text.find(term);
+        if (pos == std::string::npos) {
+            continue;
+        }
+
+        score += field.weight;
+        if (pos == 0) {
+            // 字段开头命中
+            score += field.weight * 2;
+            if (field.text.size() == term.size()) {
+                // 完全相同
+                score += field.weight * 2;
+            }
+        } else {
+            unsigned char previous = static_cast<unsigned char>(field.text[pos - 1]);
+            if (previous < 0x80 && isSeparator(previous)) {
+                // 词的开头命中
+                score += field.weight;
+            }
+        }
+    }
+    return score;
+}
+
+std::vector<SearchHit> SearchIndex::search(const std::string& query, std::size_t limit) const {
+    std::vector<SearchHit> hits;
+
+    // 按空白切分关键词
+    std::vector<std::string> terms;
+    std::string normalized = normalize(query);
+    std::vector<char32_t> codePoints;
+    std::vector<std::size_t> offsets;
+    decodeUtf8(normalized, codePoints, offsets);
+    std::size_t termStart = 0;
+    for (std::size_t i = 0; i <= codePoints.size(); ++i) {
+        if (i < codePoints.size() && !isSpace(codePoints[i])) {
+            continue;
+        }
+        if (i > termStart) {
+            terms.push_back(normalized.substr(offsets[termStart], offsets[i] - offsets[termStart]));
+        }
+        termStart = i + 1;
+    }
+    if (terms.empty() || limit == 0) {
+        return hits;
+    }
+
+    // 每个关键词求候选文档，取最少的一组再逐个验证全部关键词
+    // 单字的候选集通常很大，只在没有两字以上的关键词时才使用；候选集都是完整的
+    std::vector<std::uint32_t> candidates;
+    bool haveCandidates = false;
+    std::vector<char32_t> termPoints;
+    std::vector<std::size_t> termOffsets;
+    for (bool singles : {false, true}) {
+        if (haveCandidates) {
+            break;
+        }
+        for (const auto& term : terms) {
+            decodeUtf8(term, termPoints, termOffsets);
+            if ((termPoints.size() < 2) != singles) {
+                continue;
+            }
+            std::vector<std::uint32_t> termCandidates;
+
+            if (!singles) {
+                // 取最短的两字倒排表作为候选
+                const std::vector<std::uint32_t>* shortest = nullptr;
+                for (std::size_t i = 0; i + 1 < termPoints.size(); ++i) {
+                    auto it = bigramPostings.find(bigramKey(termPoints[i], termPoints[i + 1]));
+                    if (it == bigramPostings.end()) {
+                        return hits;
+                    }
+                    if (shortest == nullptr || it->second.size() < shortest->size()) {
+                        shortest = &it->second;
+                    }
+                }
+                termCandidates = *shortest;
+            } else if (termPoints.front() >= 128) {
+                // 中文单字：词中间的字也能命中
+                auto it = unigramPostings.find(termPoints.front());
+                if (it == unigramPostings.end()) {
+                    return hits;
+                }
+                termCandidates = it->second;
+            } else {
+                // 英文单字母只做词前缀匹配
+                collectPrefix(term, termCandidates);
+                std::sort(termCandidates.begin(), termCandidates.end());
+                termCandidates.erase(std::unique(termCandidates.begin(), termCandidates.end()),
+                                     termCandidates.end());
+            }
+
+            if (!haveCandidates || termCandidates.size() < candidates.size()) {
+                candidates = std::move(termCandidates);
+                haveCandidates = true;
+            }
+            if (candidates.empty()) {
+                return hits;
+            }
+        }
+    }
+
+    for (std::uint32_t slot : candidates) {
+        const Document& document = documents[slot];
+        if (!document.alive) {
+            continue;
+        }
+
+        int total = 0;
+        for (const auto& term : terms) {
+            int score = scoreTerm(document, term);
+            if (score == 0) {
+                total = 0;
+                break;
+            }
+            total += score;
+        }
+        if (total > 0) {
+            hits.push_back({document.kind, document.id, total, std::string()});
+        }
+    }
+
+    auto better = [](const SearchHit& a, const SearchHit& b) {
+        if (a.score != b.score) return a.score > b.score;
+        if (a.kind != b.kind) return a.kind < b.kind;
+        return a.id < b.id;
+    };
+    if (hits.size() > limit) {
+        std::partial_sort(hits.begin(), hits.begin() + limit, hits.end(), better);
+        hits.resize(limit);
+    } else {
+        std::sort(hits.begin(), hits.end(), better);
+    }
+
+    // 只为最终返回的结果复制名称
+    for (auto& hit : hits) {
+        hit.label = documents[slotByKey.at(documentKey(hit.kind, hit.id))].label;
+    }
+    return hits;
+}
@@ -0,0 +1,87 @@
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+#include "../datastructure/Professor.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 一条搜索结果
+struct SearchHit {
+    enum class Kind {
+        Course,         // 课程，id 为事件编号
+        Personal,       // 个人日程，id 为事件编号
+        Professor       // 教师，id 为 DataManager 中的教师句柄
+    };
+
+    Kind kind;
+    int id;
+    int score;
+    std::string label;      // 原始名称，供界面直接显示
+};
+
+// 增量全文索引：事件名称/地点/备注/标签，教师姓名/邮箱
+// 两字（按 Unicode 字符计）倒排表负责子串匹配，中文等非 ASCII 单字另有单字倒排表，
+// 前缀树负责英文单字母的词前缀匹配；英文字母统一转为小写，中文按字符切分，无需分词
+// 删除只做标记，失效文档过多时整体压缩重建
+class SearchIndex {
+public:
+    SearchIndex();
+
+    void addEvent(const ScheduleEvent& event);
+    void removeEvent(int eventId);
+
+    // 教师按句柄索引，同一句柄再次加入时替换原内容
+    void addProfessor(std::size_t handle, const Professor& prof);
+
+    // 清空全部事件或全部教师
+    void clearEvents();
+    void clearProfessors();
+
+    // 按空白分隔的关键词都必须命中，结果按得分从高到低排列
+    std::vector<SearchHit> search(const std::string& query, std::size_t limit = 50) const;
+
+    std::size_t size() const;
+
+private:
+    struct Field {
+        std::string text;   // 规范化后的文本
+        int weight;
+    };
+
+    struct Document {
+        SearchHit::Kind kind;
+        int id;
+        std::string label;
+        std::vector<Field> fields;
+        bool alive;
+    };
+
+    struct TrieNode {
+        std::vector<std::pair<unsigned char, std::uint32_t>> children;
+        std::vector<std::uint32_t> documents;   // 以此结点结尾的词所在的文档
+    };
+
+    std::vector<Document> documents;
+    std::unordered_map<std::uint64_t, std::uint32_t> slotByKey;
+    std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> bigramPostings;
+    std::unordered_map<char32_t, std::vector<std::uint32_t>> unigramPostings;   // 非 ASCII 单字，词中间的字也能搜到
+    std::vector<TrieNode> trie;
+    std::size_t deadCount;
+
+    static std::uint64_t documentKey(SearchHit::Kind kind, int id);
+    static std::string normalize(const std::string& text);
+
+    void addDocument(SearchHit::Kind kind, int id, const std::string& label, std::vector<Field> fields);
+    void removeDocument(SearchHit::Kind kind, int id);
+    void indexDocument(std::uint32_t slot);
+    void insertToken(const std::string& token, std::uint32_t slot);
+    void collectPrefix(const std::string& prefix, std::vector<std::uint32_t>& result) const;
+    void compact();
+
+    int scoreTerm(const Document& document, const std::string& term) const;
+};
+
+#endif // SEARCHINDEX_H
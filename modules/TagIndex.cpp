@@ -0,0 +1,57 @@
+#include "TagIndex.h"
+
+void TagIndex::insert(std::uint32_t eventId, unsigned int tags) {
+    allEvents.add(eventId);
+    for (int bit = 0; bit < EVENT_TAG_COUNT; ++bit) {
+        if (tags & (1u << bit)) {
+            tagged[bit].add(eventId);
+        } else {
+            tagged[bit].remove(eventId);
+        }
+    }
+}
+
+void TagIndex::remove(std::uint32_t eventId) {
+    allEvents.remove(eventId);
+    for (auto& bitmap : tagged) {
+        bitmap.remove(eventId);
+    }
+}
+
+void TagIndex::clear() {
+    allEvents.clear();
+    for (auto& bitmap : tagged) {
+        bitmap.clear();
+    }
+}
+
+const CompressedBitmap& TagIndex::getAllEvents() const {
+    return allEvents;
+}
+
+const CompressedBitmap& TagIndex::eventsWithTag(int bit) const {
+    return tagged[bit];
+}
+
+CompressedBitmap TagIndex::matchAll(unsigned int mask) const {
+    CompressedBitmap result = allEvents;
+    for (int bit = 0; bit < EVENT_TAG_COUNT; ++bit) {
+        if (mask & (1u << bit)) {
+            result = CompressedBitmap::intersect(result, tagged[bit]);
+        }
+    }
+    return result;
+}
+
+CompressedBitmap TagIndex::matchAny(unsigned int mask) const {
+    if ((mask & ((1u << EVENT_TAG_COUNT) - 1)) == 0) {
+        return allEvents;
+    }
+    CompressedBitmap result;
+    for (int bit = 0; bit < EVENT_TAG_COUNT; ++bit) {
+        if (mask & (1u << bit)) {
+            result = CompressedBitmap::unite(result, tagged[bit]);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,28 @@
+#ifndef TAGINDEX_H
+#define TAGINDEX_H
+
+#include "../datastructure/ScheduleEvent.h"
+#include "CompressedBitmap.h"
+#include <cstdint>
+
+// 标签索引：每个标签一张事件编号的压缩位图
+// 标签的与/或组合直接在位图上运算
+class TagIndex {
+private:
+    CompressedBitmap allEvents;
+    CompressedBitmap tagged[EVENT_TAG_COUNT];
+
+public:
+    void insert(std::uint32_t eventId, unsigned int tags);
+    void remove(std::uint32_t eventId);
+    void clear();
+
+    const CompressedBitmap& getAllEvents() const;
+    const CompressedBitmap& eventsWithTag(int bit) const;
+
+    // mask 中的标签全部具备 / 至少具备一个；mask 为 0 时返回全部事件
+    CompressedBitmap matchAll(unsigned int mask) const;
+    CompressedBitmap matchAny(unsigned int mask) const;
+};
+
+#endif // TAGINDEX_H
@@ -0,0 +1,51 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 固定大小的线程池，submit 返回 future 取结果
+// 析构时先执行完已提交的任务再退出
+class ThreadPool {
+public:
+    // threadCount 为 0 时按硬件线程数选择
+    explicit ThreadPool(std::size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename F>
+    auto submit(F task) -> std::future<decltype(task())> {
+        using Result = decltype(task());
+        // packaged_task 不可复制，包一层 shared_ptr 放进 std::function
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::move(task));
+        std::future<Result> future = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace_back([packaged]() { (*packaged)(); });
+        }
+        wake.notify_one();
+        return future;
+    }
+
+    std::size_t getThreadCount() const;
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping;
+
+    void workerLoop();
+};
+
+#endif // THREADPOOL_H
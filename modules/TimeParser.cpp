@@ -0,0 +1,161 @@
+#include "TimeParser.h"
+#include "LineTokenizer.h"
+
+namespace {
+
+// 本地零点缓存项
+struct DayEntry {
+    long long dayKey = -1;      // year * 400 + month * 32 + day
+    std::time_t midnight = 0;   // 当天本地零点
+    bool uniform = false;       // 当天没有夏令时切换，可直接按秒数偏移
+};
+
+const int DAY_CACHE_SIZE = 64;
+
+bool isLeapYear(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+int daysInMonth(int year, int month) {
+    static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month == 2 && isLeapYear(year)) {
+        return 29;
+    }
+    return days[month - 1];
+}
+
+// 读取 minDigits..maxDigits 位数字
+bool readNumber(std::string_view text, std::size_t& pos, int minDigits, int maxDigits, int& value) {
+    value = 0;
+    int digits = 0;
+    while (pos < text.size() && digits < maxDigits) {
+        char ch = text[pos];
+        if (ch < '0' || ch > '9') break;
+        value = value * 10 + (ch - '0');
+        ++pos;
+        ++digits;
+    }
+    return digits >= minDigits;
+}
+
+bool expect(std::string_view text, std::size_t& pos, char ch) {
+    if (pos < text.size() && text[pos] == ch) {
+        ++pos;
+        return true;
+    }
+    return false;
+}
+
+std::time_t localMktime(int year, int month, int day, int hour, int minute) {
+    std::tm tm = {};
+    tm.tm_year = year - 1900;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = day;
+    tm.tm_hour = hour;
+    tm.tm_min = minute;
+    tm.tm_isdst = -1;   // 由系统判断是否处于夏令时
+    return std::mktime(&tm);
+}
+
+// 查询（必要时计算）某天的本地零点
+const DayEntry& lookupDay(int year, int month, int day) {
+    thread_local DayEntry cache[DAY_CACHE_SIZE];
+
+    long long key = static_cast<long long>(year) * 400 + month * 32 + day;
+    DayEntry& entry = cache[key % DAY_CACHE_SIZE];
+    if (entry.dayKey != key) {
+        entry.dayKey = key;
+        entry.midnight = localMktime(year, month, day, 0, 0);
+        std::time_t nextMidnight = localMktime(year, month, day + 1, 0, 0);
+        entry.uniform = (nextMidnight - entry.midnight == 24 * 60 * 60);
+    }
+    return entry;
+}
+
+} // namespace
+
+TimeParseError TimeParser::parseDateTime(std::string_view text, std::time_t& out) {
+    text = LineTokenizer::trim(text);
+    if (text.empty()) {
+        return TimeParseError::Empty;
+    }
+
+    std::size_t pos = 0;
+    int year, month, day, hour, minute;
+    if (!readNumber(text, pos, 4, 4, year) || !expect(text, pos, '-') ||
+        !readNumber(text, pos, 1, 2, month) || !expect(text, pos, '-') ||
+        !readNumber(text, pos, 1, 2, day)) {
+        return TimeParseError::BadFormat;
+    }
+    if (!expect(text, pos, ' ') && !expect(text, pos, 'T')) {
+        return TimeParseError::BadFormat;
+    }
+    while (pos < text.size() && text[pos] == ' ') {
+        ++pos;
+    }
+    if (!readNumber(text, pos, 1, 2, hour) || !expect(text, pos, ':') ||
+        !readNumber(text, pos, 2, 2, minute)) {
+        return TimeParseError::BadFormat;
+    }
+    if (expect(text, pos, ':')) {
+        int seconds;
+        if (!readNumber(text, pos, 2, 2, seconds)) {
+            return TimeParseError::BadFormat;
+        }
+    }
+    if (pos != text.size()) {
+        return TimeParseError::BadFormat;
+    }
+
+    if (month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month) ||
+        hour > 23 || minute > 59) {
+        return TimeParseError::OutOfRange;
+    }
+
+    const DayEntry& entry = lookupDay(year, month, day);
+    if (entry.midnight == static_cast<std::time_t>(-1)) {
+        return TimeParseError::OutOfRange;
+    }
+    if (entry.uniform) {
+        out = entry.midnight + hour * 3600 + minute * 60;
+    } else {
+        // 夏令时切换当天交给 mktime 处理
+        out = localMktime(year, month, day, hour, minute);
+    }
+    return TimeParseError::None;
+}
+
+TimeParseError TimeParser::parseEpochSeconds(std::string_view text, std::time_t& out) {
+    text = LineTokenizer::trim(text);
+    if (text.empty()) {
+        return TimeParseError::Empty;
+    }
+    long long seconds;
+    if (!LineTokenizer::parseInt64(text, seconds)) {
+        return TimeParseError::BadFormat;
+    }
+    out = static_cast<std::time_t>(seconds);
+    return TimeParseError::None;
+}
+
+TimeParseError TimeParser::parse(std::string_view text, std::time_t& out) {
+    TimeParseError error = parseDateTime(text, out);
+    if (error == TimeParseError::BadFormat) {
+        return parseEpochSeconds(text, out);
+    }
+    return error;
+}
+
+const char* TimeParser::errorMessage(TimeParseError error) {
+    switch (error) {
+    case TimeParseError::None:
+        return "";
+    case TimeParseError::Empty:
+        return "时间字段为空";
+    case TimeParseError::BadFormat:
+        return "时间格式错误";
+    case TimeParseError::OutOfRange:
+        return "时间超出范围";
+    }
+    return "";
+}
@@ -0,0 +1,32 @@
+#ifndef TIMEPARSER_H
+#define TIMEPARSER_H
+
+#include <ctime>
+#include <string_view>
+
+// 时间解析结果
+enum class TimeParseError {
+    None,           // 解析成功
+    Empty,          // 字段为空
+    BadFormat,      // 格式不符
+    OutOfRange      // 日期或时间超出范围（如 2 月 30 日、25:00）
+};
+
+// 导入用的定长时间解析器，不抛异常
+// 日期按本地时区解释；同一天的本地零点通过每线程缓存复用，避免逐行调用 mktime
+class TimeParser {
+public:
+    // 解析 "YYYY-MM-DD HH:MM"（也接受 'T' 分隔和可选的 ":SS"，秒数忽略）
+    static TimeParseError parseDateTime(std::string_view text, std::time_t& out);
+
+    // 解析纪元秒
+    static TimeParseError parseEpochSeconds(std::string_view text, std::time_t& out);
+
+    // 先按日期时间解析，不符合格式时再按纪元秒解析
+    static TimeParseError parse(std::string_view text, std::time_t& out);
+
+    // 错误描述
+    static const char* errorMessage(TimeParseError error);
+};
+
+#endif // TIMEPARSER_H
@@ -0,0 +1,315 @@
+#include "UserStore.h"
+#include "LineTokenizer.h"
+#include "RecordFormat.h"
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <initializer_list>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+const char* const DIRECTORY_FILE_NAME = "users.idx";
+
+void makeDirectory(const std::string& path) {
+#ifdef _WIN32
+    _mkdir(path.c_str());
+#else
+    mkdir(path.c_str(), 0755);
+#endif
+}
+
+} // namespace
+
+UserStore::UserStore(std::size_t memoryBudgetBytes)
+    : memoryBudget(memoryBudgetBytes), residentBytes(0), opened(false) {
+}
+
+UserStore::~UserStore() {
+    flush();
+}
+
+bool UserStore::open(const std::string& directory) {
+    flush();
+    records.clear();
+    recordIndex.clear();
+    residents.clear();
+    lruOrder.clear();
+    residentBytes = 0;
+    opened = false;
+
+    rootDirectory = directory;
+    makeDirectory(rootDirectory);
+    directoryFile = rootDirectory + "/" + DIRECTORY_FILE_NAME;
+
+    std::ifstream file(directoryFile, std::ios::binary);
+    if (file.is_open()) {
+        // 每行：id,name,fileName
+        LineReader reader(file);
+        std::string_view line;
+        while (reader.nextLine(line)) {
+            std::string_view fields[3];
+            if (LineTokenizer::split(line, ',', fields, 3) < 3 || fields[0].empty()) {
+                continue;
+            }
+            UserRecord record{std::string(fields[0]), std::string(fields[1]), std::string(fields[2])};
+            recordIndex[record.id] = records.size();
+            records.push_back(std::move(record));
+        }
+    } else {
+        std::ofstream created(directoryFile);
+        if (!created.is_open()) {
+            return false;
+        }
+    }
+
+    opened = true;
+    return true;
+}
+
+bool UserStore::isOpen() const {
+    return opened;
+}
+
+const std::vector<UserRecord>& UserStore::getDirectory() const {
+    return records;
+}
+
+bool UserStore::contains(const std::string& userId) const {
+    return recordIndex.count(userId) > 0;
+}
+
+std::string UserStore::fileNameFor(const std::string& userId) {
+    // 只保留文件名安全的字符，其余按十六进制编码，保证不同 id 不会映射到同一文件
+    // 大写字母也编码：Windows 和 macOS 默认不区分大小写，"Alice" 与 "alice" 不能落到同一文件
+    static const char hex[] = "0123456789abcdef";
+    std::string name;
+    for (unsigned char c : userId) {
+        bool safe = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '-';
+        if (safe) {
+            name += static_cast<char>(c);
+        } else {
+            name += '_';
+            name += hex[c >> 4];
+            name += hex[c & 15];
+        }
+    }
+    return name + ".txt";
+}
+
+bool UserStore::sameFileName(const std::string& a, const std::string& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string UserStore::pathFor(const UserRecord& record) const {
+    return rootDirectory + "/" + record.fileName;
+}
+
+bool UserStore::addUser(const std::string& userId, const std::string& userName) {
+    if (!opened || userId.empty() || contains(userId) ||
+        userId.find(',') != std::string::npos || userName.find(',') != std::string::npos) {
+        return false;
+    }
+
+    UserRecord record{userId, userName, fileNameFor(userId)};
+
+    // 旧版本的目录中文件名可能含大写字母，按不区分大小写比较，避免覆盖已有学生的文件
+    for (const auto& existing : records) {
+        if (sameFileName(existing.fileName, record.fileName)) {
+            return false;
+        }
+    }
+
+    // 先写出用户文件，再追加目录行，目录中不会出现没有文件的用户；
+    // 追加失败时删除刚写出的文件，不留下目录中没有的孤立文件
+    User newUser(userName);
+    if (!RecordFormat::writeUserFile(newUser, pathFor(record))) {
+        return false;
+    }
+
+    std::ofstream file(directoryFile, std::ios::app);
+    if (file.is_open()) {
+        file << record.id << "," << record.name << "," << record.fileName << "\n";
+        file.close();
+    }
+    if (!file) {
+        std::remove(pathFor(record).c_str());
+        return false;
+    }
+
+    recordIndex[record.id] = records.size();
+    records.push_back(record);
+    insertResident(userId, std::make_shared<User>(newUser), false);
+    return true;
+}
+
+std::shared_ptr<User> UserStore::getUser(const std::string& userId) {
+    lastLoadErrors.clear();
+    auto resident = residents.find(userId);
+    if (resident != residents.end()) {
+        touch(resident->second);
+        return resident->second.user;
+    }
+
+    auto record = recordIndex.find(userId);
+    if (record == recordIndex.end()) {
+        return nullptr;
+    }
+
+    auto loaded = std::make_shared<User>();
+    if (!RecordFormat::readUserFile(*loaded, pathFor(records[record->second]), lastLoadErrors)) {
+        return nullptr;
+    }
+
+    insertResident(userId, loaded, false);
+    return loaded;
+}
+
+const std::vector<LineError>& UserStore::getLastLoadErrors() const {
+    return lastLoadErrors;
+}
+
+bool UserStore::storeUser(const std::string& userId, const User& userData) {
+    if (!contains(userId)) {
+        return false;
+    }
+
+    auto resident = residents.find(userId);
+    if (resident == residents.end()) {
+        insertResident(userId, std::make_shared<User>(userData), true);
+        resident = residents.find(userId);
+    } else {
+        *resident->second.user = userData;
+        residentBytes -= resident->second.bytes;
+        resident->second.bytes = estimateBytes(userData);
+        residentBytes += resident->second.bytes;
+        resident->second.dirty = true;
+        touch(resident->second);
+    }
+
+    bool written = writeResident(userId, resident->second);
+    evictOverBudget(userId);
+    return written;
+}
+
+void UserStore::markDirty(const std::string& userId) {
+    auto resident = residents.find(userId);
+    if (resident == residents.end()) {
+        return;
+    }
+
+    // 内容可能已变化，重新估算占用
+    residentBytes -= resident->second.bytes;
+    resident->second.bytes = estimateBytes(*resident->second.user);
+    residentBytes += resident->second.bytes;
+    resident->second.dirty = true;
+    evictOverBudget(userId);
+}
+
+void UserStore::discard(const std::string& userId) {
+    auto resident = residents.find(userId);
+    if (resident == residents.end()) {
+        return;
+    }
+    residentBytes -= resident->second.bytes;
+    lruOrder.erase(resident->second.lruPosition);
+    residents.erase(resident);
+}
+
+bool UserStore::flush() {
+    bool ok = true;
+    for (auto& item : residents) {
+        if (item.second.dirty && !writeResident(item.first, item.second)) {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+void UserStore::setMemoryBudget(std::size_t bytes) {
+    memoryBudget = bytes;
+    evictOverBudget(std::string());
+}
+
+std::size_t UserStore::getResidentCount() const {
+    return residents.size();
+}
+
+std::size_t UserStore::getResidentBytes() const {
+    return residentBytes;
+}
+
+std::size_t UserStore::estimateBytes(const User& userData) {
+    std::size_t bytes = sizeof(User) + userData.getName().size();
+    for (const Schedule* schedule : {&userData.getCourses(), &userData.getPersonalSchedule()}) {
+        for (const auto& event : schedule->getAllEvents()) {
+            bytes += sizeof(ScheduleEvent) + event.getEventName().size() +
+                     event.getLocation().size() + event.getDescription().size();
+        }
+    }
+    return bytes;
+}
+
+bool UserStore::writeResident(const std::string& userId, Resident& resident) {
+    const UserRecord& record = records[recordIndex.at(userId)];
+    std::string path = pathFor(record);
+    std::string tempPath = path + ".tmp";
+
+    // 先写临时文件再替换，写入中途失败不会损坏原文件
+    if (!RecordFormat::writeUserFile(*resident.user, tempPath)) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+#ifdef _WIN32
+    std::remove(path.c_str());
+#endif
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        return false;
+    }
+    resident.dirty = false;
+    return true;
+}
+
+void UserStore::touch(Resident& resident) {
+    lruOrder.splice(lruOrder.begin(), lruOrder, resident.lruPosition);
+}
+
+void UserStore::insertResident(const std::string& userId, std::shared_ptr<User> userData, bool dirty) {
+    lruOrder.push_front(userId);
+    Resident resident{userData, lruOrder.begin(), estimateBytes(*userData), dirty};
+    residentBytes += resident.bytes;
+    residents[userId] = resident;
+    evictOverBudget(userId);
+}
+
+void UserStore::evictOverBudget(const std::string& keepUserId) {
+    // 从最久未用的一端淘汰，刚访问的用户即使超出预算也保留
+    while (residentBytes > memoryBudget && !lruOrder.empty()) {
+        const std::string& victimId = lruOrder.back();
+        if (victimId == keepUserId) {
+            break;
+        }
+
+        auto victim = residents.find(victimId);
+        if (victim->second.dirty && !writeResident(victimId, victim->second)) {
+            // 写回失败时不丢弃修改，留在内存中等待下次 flush
+            break;
+        }
+        residentBytes -= victim->second.bytes;
+        residents.erase(victim);
+        lruOrder.pop_back();
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef USERSTORE_H
+#define USERSTORE_H
+
+#include "../datastructure/User.h"
+#include "LineTokenizer.h"
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 目录中的一个用户
+struct UserRecord {
+    std::string id;
+    std::string name;
+    std::string fileName;       // 相对于存储目录
+};
+
+// 按用户分片的存储：每个用户一个文件，目录文件记录 id -> 文件名
+// 常驻内存的 User 按最近使用（LRU）管理，超出内存预算时淘汰最久未用的用户，
+// 淘汰前把有修改的用户写回；读写某个用户只涉及该用户自己的文件
+class UserStore {
+public:
+    explicit UserStore(std::size_t memoryBudgetBytes = 64 * 1024 * 1024);
+    ~UserStore();
+
+    UserStore(const UserStore&) = delete;
+    UserStore& operator=(const UserStore&) = delete;
+
+    // 打开存储目录（不存在时创建目录文件），只读取目录，不加载任何用户
+    bool open(const std::string& directory);
+    bool isOpen() const;
+
+    const std::vector<UserRecord>& getDirectory() const;
+    bool contains(const std::string& userId) const;
+
+    // 新建用户：写出空的用户文件并追加目录；已存在、或文件名与已有学生只差大小写时返回 false
+    bool addUser(const std::string& userId, const std::string& userName);
+
+    // 取得用户，不在内存中时只读取该用户的文件；未知用户返回 nullptr
+    // 返回的指针在被淘汰后仍然有效，只是不再由存储持有
+    std::shared_ptr<User> getUser(const std::string& userId);
+
+    // 最近一次 getUser 读取文件时跳过的格式错误记录，用户已在内存中时为空
+    const std::vector<LineError>& getLastLoadErrors() const;
+
+    // 用 userData 替换该用户的内容并立即写回其文件
+    bool storeUser(const std::string& userId, const User& userData);
+
+    // 通过 getUser 返回的指针修改后标记，淘汰或 flush 时写回
+    void markDirty(const std::string& userId);
+
+    // 丢弃内存中的副本（包括未写回的修改），下次 getUser 时重新读取文件
+    void discard(const std::string& userId);
+    bool flush();
+
+    void setMemoryBudget(std::size_t bytes);
+    std::size_t getResidentCount() const;
+    std::size_t getResidentBytes() const;
+
+    // 估算一个用户占用的内存
+    static std::size_t estimateBytes(const User& userData);
+
+private:
+    struct Resident {
+        std::shared_ptr<User> user;
+        std::list<std::string>::iterator lruPosition;
+        std::size_t bytes;
+        bool dirty;
+    };
+
+    std::string rootDirectory;
+    std::string directoryFile;
+    std::vector<UserRecord> records;
+    std::unordered_map<std::string, std::size_t> recordIndex;
+
+    std::unordered_map<std::string, Resident> residents;
+    std::list<std::string> lruOrder;        // 头部为最近使用
+    std::size_t memoryBudget;
+    std::size_t residentBytes;
+    bool opened;
+    std::vector<LineError> lastLoadErrors;
+
+    std::string pathFor(const UserRecord& record) const;
+    static std::string fileNameFor(const std::string& userId);
+    // 按不区分大小写的文件系统比较文件名
+    static bool sameFileName(const std::string& a, const std::string& b);
+    bool writeResident(const std::string& userId, Resident& resident);
+    void touch(Resident& resident);
+    void insertResident(const std::string& userId, std::shared_ptr<User> userData, bool dirty);
+    void evictOverBudget(const std::string& keepUserId);
+};
+
+#endif // USERSTORE_H
@@ -0,0 +1,156 @@
+#include "WeekLayout.h"
+#include "../datastructure/TimeConvert.h"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace {
+
+// 公历日期 -> 连续的日序号（1970-01-01 为 0）
+long dayNumber(int year, int month, int day) {
+    year -= month <= 2 ? 1 : 0;
+    long era = (year >= 0 ? year : year - 399) / 400;
+    long yearOfEra = year - era * 400;
+    long dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+long dayNumber(const std::tm& tm) {
+    return dayNumber(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+}
+
+// 日序号所在周的周一（1970-01-01 是周四）
+long mondayOf(long day) {
+    long weekday = ((day % 7) + 7 + 3) % 7;     // 周一为 0
+    return day - weekday;
+}
+
+long floorDiv(long a, long b) {
+    long q = a / b;
+    return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+}
+
+} // namespace
+
+WeekLayoutBuilder::WeekLayoutBuilder() : currentMonday(0) {
+    std::tm nowTm{};
+    if (toLocalTm(std::time(nullptr), nowTm)) {
+        currentMonday = mondayOf(dayNumber(nowTm));
+    }
+}
+
+int WeekLayoutBuilder::weekOf(const ScheduleEvent& event) const {
+    std::time_t startTt = std::chrono::system_clock::to_time_t(event.getTimeSlot().getStartTime());
+    std::tm startTm{};
+    if (!toLocalTm(startTt, startTm)) {
+        return 0;
+    }
+    return static_cast<int>(floorDiv(mondayOf(dayNumber(startTm)) - currentMonday, 7));
+}
+
+bool WeekLayoutBuilder::place(const ScheduleEvent& event, int weekOffset, LaidOutEvent& out) const {
+    int weekday = event.getWeekday();
+    if (weekday < 1 || weekday > 7) {
+        return false;
+    }
+
+    const TimeSlot& slot = event.getTimeSlot();
+    std::time_t startTt = std::chrono::system_clock::to_time_t(slot.getStartTime());
+    std::tm startTm{};
+    if (!toLocalTm(startTt, startTm)) {
+        return false;
+    }
+
+    // 个人日程只在所属周显示，周偏移相对于系统当前周
+    if (!slot.getIsCourse() && floorDiv(mondayOf(dayNumber(startTm)) - currentMonday, 7) != weekOffset) {
+        return false;
+    }
+
+    auto duration = std::chrono::duration_cast<std::chrono::minutes>(slot.getEndTime() - slot.getStartTime());
+    out.eventId = event.getId();
+    out.day = weekday - 1;
+    out.startMinute = startTm.tm_hour * 60 + startTm.tm_min;
+    out.endMinute = out.startMinute + static_cast<int>(duration.count());
+    out.course = slot.getIsCourse();
+    out.title = event.getEventName();
+    if (!event.getLocation().empty()) {
+        out.title += "\n@" + event.getLocation();
+    }
+    return true;
+}
+
+std::chrono::system_clock::time_point WeekLayoutBuilder::timeAt(int weekOffset, int day, int minute) const {
+    // 从 1970-01-01 起按日和分钟累加，由 mktime 规范化并处理夏令时
+    std::tm localTm{};
+    localTm.tm_year = 70;
+    localTm.tm_mon = 0;
+    localTm.tm_mday = 1 + static_cast<int>(currentMonday + weekOffset * 7L + day);
+    localTm.tm_min = minute;
+    localTm.tm_isdst = -1;
+    return std::chrono::system_clock::from_time_t(std::mktime(&localTm));
+}
+
+void WeekLayoutBuilder::add(WeekLayout& layout, const ScheduleEvent& event) const {
+    LaidOutEvent placed;
+    if (place(event, layout.weekOffset, placed)) {
+        layout.days[placed.day].push_back(std::move(placed));
+    }
+}
+
+void WeekLayoutBuilder::assignColumns(std::vector<LaidOutEvent>& day) {
+    std::stable_sort(day.begin(), day.end(), [](const LaidOutEvent& a, const LaidOutEvent& b) {
+        if (a.startMinute != b.startMinute) {
+            return a.startMinute < b.startMinute;
+        }
+        return a.endMinute > b.endMinute;
+    });
+
+    // (结束分钟, 列号) 的小顶堆，表示正在占用的列；freeColumns 为已空出的列号
+    using Busy = std::pair<int, int>;
+    std::priority_queue<Busy, std::vector<Busy>, std::greater<Busy>> busy;
+    std::priority_queue<int, std::vector<int>, std::greater<int>> freeColumns;
+    std::size_t groupStart = 0;
+    int groupColumns = 0;
+
+    auto closeGroup = [&](std::size_t groupEnd) {
+        for (std::size_t i = groupStart; i < groupEnd; ++i) {
+            day[i].columnCount = groupColumns;
+        }
+        groupStart = groupEnd;
+        groupColumns = 0;
+        freeColumns = decltype(freeColumns)();
+    };
+
+    for (std::size_t i = 0; i < day.size(); ++i) {
+        LaidOutEvent& event = day[i];
+        // 至少显示一分钟，避免零长度事件和谁都不重叠
+        int end = std::max(event.endMinute, event.startMinute + 1);
+        while (!busy.empty() && busy.top().first <= event.startMinute) {
+            freeColumns.push(busy.top().second);
+            busy.pop();
+        }
+        if (busy.empty() && i > groupStart) {
+            closeGroup(i);
+        }
+
+        if (!freeColumns.empty()) {
+            event.column = freeColumns.top();
+            freeColumns.pop();
+        } else {
+            event.column = groupColumns;
+        }
+        groupColumns = std::max(groupColumns, event.column + 1);
+        busy.push(Busy(end, event.column));
+    }
+    closeGroup(day.size());
+}
+
+void WeekLayoutBuilder::assignColumns(WeekLayout& layout) {
+    for (auto& day : layout.days) {
+        assignColumns(day);
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef WEEKLAYOUT_H
+#define WEEKLAYOUT_H
+
+#include "../datastructure/ScheduleEvent.h"
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// 一个事件在某一周中的位置，分钟精度
+struct LaidOutEvent {
+    int eventId;
+    int day;                // 0..6 对应周一到周日
+    int startMinute;        // 距当天零点的分钟数
+    int endMinute;          // 跨午夜时可能超过 1440，显示时截断
+    bool course;
+    std::string title;      // 名称，有地点时附加 "\n@地点"
+    int column = 0;         // 重叠时所在的并列列号
+    int columnCount = 1;    // 所在重叠组的总列数
+};
+
+// 一周的布局，每天的事件按加入顺序排列（assignColumns 之后按开始时间排列）
+struct WeekLayout {
+    int weekOffset = 0;
+    std::array<std::vector<LaidOutEvent>, 7> days;
+};
+
+// 把事件放到指定周：课程每周重复，个人日程只出现在所属周
+// 只使用线程安全的时间函数，可在后台线程中使用
+class WeekLayoutBuilder {
+public:
+    // 记录构造时本周周一的日期，周偏移都相对于它计算
+    WeekLayoutBuilder();
+
+    // 事件所在周相对于本周的偏移（线程安全版的 ScheduleEvent::getWeekOffset）
+    int weekOf(const ScheduleEvent& event) const;
+
+    // 事件不在该周显示时返回 false
+    bool place(const ScheduleEvent& event, int weekOffset, LaidOutEvent& out) const;
+
+    // place 的逆运算：某周第 day 天（0 为周一）零点之后 minute 分钟的本地时间
+    std::chrono::system_clock::time_point timeAt(int weekOffset, int day, int minute) const;
+
+    // 放得下时追加到 layout 对应的那一天
+    void add(WeekLayout& layout, const ScheduleEvent& event) const;
+
+    // 为一天中互相重叠的事件分配并列的列（区间图着色）：
+    // 按开始时间排序后贪心地放入最早空出的列，同一连通重叠组内列数相同
+    static void assignColumns(std::vector<LaidOutEvent>& day);
+    static void assignColumns(WeekLayout& layout);
+
+private:
+    long currentMonday;     // 本周周一的日序号
+};
+
+#endif // WEEKLAYOUT_H
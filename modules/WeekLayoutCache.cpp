@@ -0,0 +1,178 @@
+#include "WeekLayoutCache.h"
+#include <algorithm>
+#include <cstdlib>
+#include <initializer_list>
+#include <set>
+#include <unordered_map>
+#include <utility>
+
+WeekLayoutCache::WeekLayoutCache(int radius)
+    : radius(radius > 0 ? radius : 0), generation(0), center(0), stopping(false) {
+    worker = std::thread(&WeekLayoutCache::workerLoop, this);
+}
+
+WeekLayoutCache::~WeekLayoutCache() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+void WeekLayoutCache::setSource(std::shared_ptr<const User> newUser,
+                                std::shared_ptr<const CompressedBitmap> newVisible) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        user = std::move(newUser);
+        visible = std::move(newVisible);
+        generation++;
+        layouts.clear();
+    }
+    wake.notify_all();
+}
+
+void WeekLayoutCache::applyChanges(std::shared_ptr<const User> newUser,
+                                   std::shared_ptr<const CompressedBitmap> newVisible,
+                                   const ChangeSet& changes) {
+    WeekLayoutBuilder builder;
+    // 同一事件多次变化时只保留最终状态，受影响的周取所有中间状态的并集
+    std::unordered_map<int, const EventChange*> latest;
+    std::set<int> weeks;
+    bool allWeeks = false;
+    for (const auto& change : changes.changes) {
+        latest[change.event.getId()] = &change;
+        if (change.course || change.event.getTimeSlot().getIsCourse() ||
+            (change.kind == EventChange::Kind::Modified && change.previous.getTimeSlot().getIsCourse())) {
+            allWeeks = true;
+        }
+        weeks.insert(builder.weekOf(change.event));
+        if (change.kind == EventChange::Kind::Modified) {
+            weeks.insert(builder.weekOf(change.previous));
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        user = std::move(newUser);
+        visible = std::move(newVisible);
+        generation++;       // 按旧快照计算中的布局作废
+
+        for (auto& entry : layouts) {
+            if (!allWeeks && weeks.find(entry.first) == weeks.end()) {
+                continue;
+            }
+            auto patched = std::make_shared<WeekLayout>(*entry.second);
+            std::array<bool, 7> touched{};
+            for (int day = 0; day < 7; ++day) {
+                auto& events = patched->days[day];
+                auto removed = std::remove_if(events.begin(), events.end(), [&latest](const LaidOutEvent& item) {
+                    return latest.find(item.eventId) != latest.end();
+                });
+                touched[day] = removed != events.end();
+                events.erase(removed, events.end());
+            }
+            for (const auto& item : latest) {
+                const EventChange& change = *item.second;
+                if (change.kind == EventChange::Kind::Removed ||
+                    (visible && !visible->contains(static_cast<std::uint32_t>(item.first)))) {
+                    continue;
+                }
+                LaidOutEvent placed;
+                if (builder.place(change.event, entry.first, placed)) {
+                    touched[placed.day] = true;
+                    patched->days[placed.day].push_back(std::move(placed));
+                }
+            }
+            for (int day = 0; day < 7; ++day) {
+                if (touched[day]) {
+                    WeekLayoutBuilder::assignColumns(patched->days[day]);
+                }
+            }
+            entry.second = std::move(patched);
+        }
+    }
+    wake.notify_all();
+}
+
+void WeekLayoutCache::prefetch(int newCenter) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        center = newCenter;
+        // 留一些余量，来回翻周时不必重算
+        for (auto it = layouts.begin(); it != layouts.end(); ) {
+            if (std::abs(it->first - center) > radius * 2) {
+                it = layouts.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    wake.notify_all();
+}
+
+std::shared_ptr<const WeekLayout> WeekLayoutCache::find(int weekOffset) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = layouts.find(weekOffset);
+    return it == layouts.end() ? nullptr : it->second;
+}
+
+WeekLayout WeekLayoutCache::build(const User& user, const CompressedBitmap* visible, int weekOffset) {
+    WeekLayout layout;
+    layout.weekOffset = weekOffset;
+    WeekLayoutBuilder builder;
+    for (const Schedule* schedule : {&user.getCourses(), &user.getPersonalSchedule()}) {
+        for (const auto& event : schedule->getAllEvents()) {
+            if (visible && !visible->contains(static_cast<std::uint32_t>(event.getId()))) {
+                continue;
+            }
+            builder.add(layout, event);
+        }
+    }
+    WeekLayoutBuilder::assignColumns(layout);
+    return layout;
+}
+
+bool WeekLayoutCache::nextMissingWeek(int& weekOffset) const {
+    if (!user) {
+        return false;
+    }
+    // 先算当前周，再由近及远交替向后、向前
+    for (int distance = 0; distance <= radius; ++distance) {
+        for (int sign : {1, -1}) {
+            int week = center + sign * distance;
+            if (layouts.find(week) == layouts.end()) {
+                weekOffset = week;
+                return true;
+            }
+            if (distance == 0) {
+                break;
+            }
+        }
+    }
+    return false;
+}
+
+void WeekLayoutCache::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        int week = 0;
+        wake.wait(lock, [this, &week] { return stopping || nextMissingWeek(week); });
+        if (stopping) {
+            return;
+        }
+
+        // 快照不可变，计算时不持有锁
+        std::shared_ptr<const User> source = user;
+        std::shared_ptr<const CompressedBitmap> filter = visible;
+        std::uint64_t startGeneration = generation;
+        lock.unlock();
+
+        auto layout = std::make_shared<const WeekLayout>(build(*source, filter.get(), week));
+
+        lock.lock();
+        if (generation == startGeneration && std::abs(week - center) <= radius * 2) {
+            layouts[week] = std::move(layout);
+        }
+    }
+}
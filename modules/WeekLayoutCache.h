@@ -0,0 +1,62 @@
+#ifndef WEEKLAYOUTCACHE_H
+#define WEEKLAYOUTCACHE_H
+
+#include "WeekLayout.h"
+#include "CompressedBitmap.h"
+#include "ScheduleChange.h"
+#include "../datastructure/User.h"
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// 周布局缓存：后台线程以当前周为中心预先计算前后若干周的布局，
+// 翻周时直接取用，无需在界面线程中重新布局
+// 数据源是用户的不可变快照：更换用户或筛选条件时调用 setSource，旧的布局全部作废；
+// 日程的增量变化调用 applyChanges，只修补受影响的周
+class WeekLayoutCache {
+public:
+    explicit WeekLayoutCache(int radius = 4);
+    ~WeekLayoutCache();
+
+    WeekLayoutCache(const WeekLayoutCache&) = delete;
+    WeekLayoutCache& operator=(const WeekLayoutCache&) = delete;
+
+    // 更换数据源；visible 为空时显示全部事件，否则只显示其中的事件编号
+    void setSource(std::shared_ptr<const User> user, std::shared_ptr<const CompressedBitmap> visible);
+
+    // 按变化更换数据源并修补已缓存的布局：课程变化影响每一周，个人日程只影响变化前后所在的周
+    // changes.reset 为 true 时调用方应改用 setSource
+    void applyChanges(std::shared_ptr<const User> user, std::shared_ptr<const CompressedBitmap> visible,
+                      const ChangeSet& changes);
+
+    // 以 center 为中心预取前后 radius 周，离中心较远的旧布局被丢弃
+    void prefetch(int center);
+
+    // 取已经算好的布局，尚未算好时返回空指针
+    std::shared_ptr<const WeekLayout> find(int weekOffset) const;
+
+    // 在调用线程中计算一周的布局（不经过缓存），重叠事件已分好列
+    static WeekLayout build(const User& user, const CompressedBitmap* visible, int weekOffset);
+
+private:
+    int radius;
+    std::shared_ptr<const User> user;
+    std::shared_ptr<const CompressedBitmap> visible;
+    std::uint64_t generation;           // 每次更换数据源递增，过期的计算结果不入缓存
+    int center;
+    std::map<int, std::shared_ptr<const WeekLayout>> layouts;
+
+    bool stopping;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::thread worker;
+
+    // 离中心最近的缺失周，没有时返回 false（需持有锁）
+    bool nextMissingWeek(int& weekOffset) const;
+    void workerLoop();
+};
+
+#endif // WEEKLAYOUTCACHE_H
@@ -0,0 +1,107 @@
+// CsvTokenizer 的边界扫描测试：按块切分后逐块解析的结果必须与整体逐条解析一致
+// 构建：qmake tests/tests.pro && make，运行后返回值非 0 表示失败
+#include "../modules/CsvTokenizer.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const char* what, const std::string& input) {
+    if (!condition) {
+        std::printf("FAIL: %s\n  input: %s\n", what, input.c_str());
+        failures++;
+    }
+}
+
+// 每条记录的字段拼成一行，便于比较
+std::vector<std::string> parseAll(std::string_view text) {
+    std::vector<std::string> records;
+    std::vector<CsvField> fields;
+    CsvTokenizer tokenizer(text);
+    while (tokenizer.nextRecord(fields)) {
+        std::string line;
+        for (const auto& field : fields) {
+            line += field.quoted ? "Q[" : "U[";
+            line += field.toString();
+            line += "]";
+        }
+        records.push_back(line);
+    }
+    return records;
+}
+
+std::vector<std::string> parseChunked(std::string_view text, int chunkCount) {
+    std::vector<std::string> records;
+    for (std::string_view chunk : CsvTokenizer::splitRecordAligned(text, chunkCount)) {
+        auto part = parseAll(chunk);
+        records.insert(records.end(), part.begin(), part.end());
+    }
+    return records;
+}
+
+// 模拟流式读取：每次追加 blockSize 字节，按 lastRecordEnd 切出完整记录
+std::vector<std::string> parseStreamed(const std::string& text, std::size_t blockSize) {
+    std::vector<std::string> records;
+    std::string pending;
+    std::size_t scanned = 0;
+    CsvTokenizer::ScanState state = CsvTokenizer::ScanState::FieldStart;
+    for (std::size_t pos = 0; pos < text.size(); pos += blockSize) {
+        pending.append(text, pos, blockSize);
+        std::size_t cut = CsvTokenizer::lastRecordEnd(pending, scanned, state);
+        if (cut == 0) {
+            continue;
+        }
+        auto part = parseAll(std::string_view(pending).substr(0, cut));
+        records.insert(records.end(), part.begin(), part.end());
+        pending.erase(0, cut);
+        scanned -= cut;
+    }
+    auto part = parseAll(pending);
+    records.insert(records.end(), part.begin(), part.end());
+    return records;
+}
+
+std::string sample() {
+    std::string text = "name,location,description\n";
+    for (int i = 0; i < 40; ++i) {
+        std::string n = std::to_string(i);
+        text += "course" + n + ",5\" screen room,plain\n";                 // 普通字段中的引号
+        text += "\"multi\nline " + n + "\",\"has \"\"quote\"\"\",x\n";      // 带引号字段中的换行和转义
+        text += "cr" + n + ",a,b\r";                                        // 单独的 \r
+        text += "crlf" + n + ",\"q\"tail,c\r\n";                            // 闭合引号后的多余字符
+    }
+    return text;
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> inputs = {
+        sample(),
+        "a,5\" x\nb,\"1\n2\"\nc,3\n",
+        "\"unterminated\nstill,open\n",
+        "x\ry\r\nz\n",
+    };
+
+    for (const auto& input : inputs) {
+        auto expected = parseAll(input);
+        for (int chunks = 1; chunks <= 16; ++chunks) {
+            check(parseChunked(input, chunks) == expected, "splitRecordAligned", input);
+        }
+        for (std::size_t block : {1u, 2u, 3u, 7u, 64u}) {
+            check(parseStreamed(input, block) == expected, "lastRecordEnd", input);
+        }
+    }
+
+    // 普通字段中的引号不改变引号状态
+    check(CsvTokenizer::lastRecordEnd("a,5\" x\nb,c\n") == 11, "stray quote boundary", "a,5\" x\\nb,c\\n");
+    check(CsvTokenizer::lastRecordEnd("a,b\rc") == 4, "bare CR boundary", "a,b\\rc");
+
+    if (failures == 0) {
+        std::printf("all passed\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
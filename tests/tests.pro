@@ -0,0 +1,14 @@
+# 不依赖 Qt 的模块测试
+QT -= core gui
+
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+TARGET = CsvTokenizerTest
+TEMPLATE = app
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    CsvTokenizerTest.cpp \
+    ../modules/CsvTokenizer.cpp
@@ -48,6 +48,14 @@ ScheduleEvent AddEventDialog::getEvent() const {
         slot
     );
 
+    unsigned int tags = 0;
+    for (int bit = 0; bit < EVENT_TAG_COUNT; ++bit) {
+        if (tagCheck(bit)->isChecked()) {
+            tags |= 1u << bit;
+        }
+    }
+    event.setTags(tags);
+
     return event;
 }
 
@@ -66,6 +74,9 @@ void AddEventDialog::setEvent(const ScheduleEvent& event) {
     ui->startTimeEdit->setDateTime(startDateTime);
     ui->endTimeEdit->setDateTime(endDateTime);
     ui->isCourseCheck->setChecked(event.getTimeSlot().getIsCourse());
+    for (int bit = 0; bit < EVENT_TAG_COUNT; ++bit) {
+        tagCheck(bit)->setChecked((event.getTags() & (1u << bit)) != 0);
+    }
 }
 
 void AddEventDialog::clear() {
@@ -75,4 +86,14 @@ void AddEventDialog::clear() {
     ui->startTimeEdit->setDateTime(QDateTime::currentDateTime());
     ui->endTimeEdit->setDateTime(QDateTime::currentDateTime().addSecs(3600));
     ui->isCourseCheck->setChecked(false);
+    for (int bit = 0; bit < EVENT_TAG_COUNT; ++bit) {
+        tagCheck(bit)->setChecked(false);
+    }
+}
+
+QCheckBox* AddEventDialog::tagCheck(int bit) const {
+    QCheckBox* checks[EVENT_TAG_COUNT] = {
+        ui->midtermCheck, ui->finalCheck, ui->reviewCheck, ui->makeupCheck, ui->presentationCheck
+    };
+    return checks[bit];
 }
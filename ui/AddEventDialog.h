@@ -2,6 +2,7 @@
 #define ADDEVENTDIALOG_H
 
 #include <QDialog>
+#include <QCheckBox>
 #include "../datastructure/ScheduleEvent.h"
 
 namespace Ui {
@@ -21,6 +22,9 @@ public:
 
 private:
     Ui::AddEventDialog *ui;
+
+    // 标签复选框，按 EventTag 的位序排列
+    QCheckBox* tagCheck(int bit) const;
 };
 
 #endif // ADDEVENTDIALOG_H
@@ -0,0 +1,137 @@
+#include "AvailabilityResultModel.h"
+#include <QColor>
+#include <QDateTime>
+#include <chrono>
+#include <utility>
+
+namespace {
+
+qint64 toSecs(const std::chrono::system_clock::time_point& tp) {
+    return static_cast<qint64>(std::chrono::system_clock::to_time_t(tp));
+}
+
+} // namespace
+
+AvailabilityResultModel::AvailabilityResultModel(QObject* parent)
+    : QAbstractTableModel(parent) {
+}
+
+int AvailabilityResultModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(rows.size());
+}
+
+int AvailabilityResultModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant AvailabilityResultModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= static_cast<int>(rows.size())) {
+        return QVariant();
+    }
+
+    const Row& row = rows[index.row()];
+    const AvailabilityResult& result = results[row.result];
+    const TimeSlot& slot = result.slots[row.slot];
+
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case StartColumn:
+            return QDateTime::fromSecsSinceEpoch(toSecs(slot.getStartTime())).toString("yyyy-MM-dd hh:mm");
+        case EndColumn:
+            return QDateTime::fromSecsSinceEpoch(toSecs(slot.getEndTime())).toString("yyyy-MM-dd hh:mm");
+        case DurationColumn:
+            return QString::number(slot.durationMinutes()) + QString::fromUtf8("分钟");
+        case ProfessorColumn:
+            return QString::fromUtf8("%1 <%2>").arg(QString::fromUtf8(result.professorName.c_str()),
+                                                   QString::fromUtf8(result.professorEmail.c_str()));
+        }
+        break;
+    case SortRole:
+        switch (index.column()) {
+        case StartColumn:
+            return toSecs(slot.getStartTime());
+        case EndColumn:
+            return toSecs(slot.getEndTime());
+        case DurationColumn:
+            return static_cast<qint64>(slot.durationMinutes());
+        case ProfessorColumn:
+            return QString::fromUtf8(result.professorName.c_str());
+        }
+        break;
+    case EmailRole:
+        return QString::fromUtf8(result.professorEmail.c_str());
+    case DurationRole:
+        return static_cast<qint64>(slot.durationMinutes());
+    case Qt::ToolTipRole:
+        if (index.column() == ProfessorColumn) {
+            return QString::fromUtf8("双击打开邮箱软件");
+        }
+        break;
+    case Qt::ForegroundRole:
+        if (index.column() == ProfessorColumn) {
+            return QColor(0, 102, 204);     // 蓝色文字提示可点击
+        }
+        break;
+    }
+    return QVariant();
+}
+
+QVariant AvailabilityResultModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    switch (section) {
+    case StartColumn:
+        return QString::fromUtf8("开始时间");
+    case EndColumn:
+        return QString::fromUtf8("结束时间");
+    case DurationColumn:
+        return QString::fromUtf8("持续时间");
+    case ProfessorColumn:
+        return QString::fromUtf8("教师信息");
+    }
+    return QVariant();
+}
+
+void AvailabilityResultModel::setResults(std::vector<AvailabilityResult> newResults) {
+    beginResetModel();
+    results = std::move(newResults);
+    rows.clear();
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        for (std::size_t j = 0; j < results[i].slots.size(); ++j) {
+            rows.push_back(Row{i, j});
+        }
+    }
+    endResetModel();
+}
+
+const std::vector<AvailabilityResult>& AvailabilityResultModel::getResults() const {
+    return results;
+}
+
+AvailabilityFilterProxy::AvailabilityFilterProxy(QObject* parent)
+    : QSortFilterProxyModel(parent)
+    , minimumDuration(0) {
+    setSortRole(AvailabilityResultModel::SortRole);
+}
+
+void AvailabilityFilterProxy::setMinimumDuration(int minutes) {
+    if (minutes == minimumDuration) {
+        return;
+    }
+    minimumDuration = minutes;
+    invalidateFilter();
+}
+
+int AvailabilityFilterProxy::getMinimumDuration() const {
+    return minimumDuration;
+}
+
+bool AvailabilityFilterProxy::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const {
+    if (minimumDuration <= 0) {
+        return true;
+    }
+    QModelIndex index = sourceModel()->index(sourceRow, AvailabilityResultModel::DurationColumn, sourceParent);
+    return sourceModel()->data(index, AvailabilityResultModel::DurationRole).toLongLong() >= minimumDuration;
+}
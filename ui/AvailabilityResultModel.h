@@ -0,0 +1,68 @@
+#ifndef AVAILABILITYRESULTMODEL_H
+#define AVAILABILITYRESULTMODEL_H
+
+#include <QAbstractTableModel>
+#include <QSortFilterProxyModel>
+#include <cstddef>
+#include <vector>
+#include "../modules/AvailabilityTask.h"
+
+// 可用时间结果表：每个空闲时间段一行，列为开始、结束、时长、教师
+// 模型直接持有结果数组，行只记录（结果, 时间段）下标；
+// 日期字符串在 data() 中按需格式化，只有可见行才会被格式化
+class AvailabilityResultModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum Column {
+        StartColumn,
+        EndColumn,
+        DurationColumn,
+        ProfessorColumn,
+        ColumnCount
+    };
+
+    enum Role {
+        SortRole = Qt::UserRole,    // 排序键：时间为秒数，时长为分钟，教师为姓名
+        EmailRole,                  // 教师邮箱
+        DurationRole                // 时长（分钟），供筛选使用
+    };
+
+    explicit AvailabilityResultModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    void setResults(std::vector<AvailabilityResult> results);
+    const std::vector<AvailabilityResult>& getResults() const;
+
+private:
+    struct Row {
+        std::size_t result;
+        std::size_t slot;
+    };
+
+    std::vector<AvailabilityResult> results;
+    std::vector<Row> rows;
+};
+
+// 结果表的排序/筛选代理：按 SortRole 比较，过滤掉短于最小时长的时间段
+class AvailabilityFilterProxy : public QSortFilterProxyModel {
+    Q_OBJECT
+
+public:
+    explicit AvailabilityFilterProxy(QObject* parent = nullptr);
+
+    void setMinimumDuration(int minutes);
+    int getMinimumDuration() const;
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+
+private:
+    int minimumDuration;
+};
+
+#endif // AVAILABILITYRESULTMODEL_H
@@ -21,7 +21,7 @@ void ImportProfessorDialog::onBrowseClicked() {
         this,
         QString::fromUtf8("选择CSV文件"),
         "",
-        "CSV Files (*.csv);;All Files (*)"
+        "CSV Files (*.csv);;iCalendar Files (*.ics);;All Files (*)"
     );
 
     if (!fileName.isEmpty()) {
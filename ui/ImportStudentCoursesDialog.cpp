@@ -26,7 +26,7 @@ void ImportStudentCoursesDialog::onBrowseClicked()
         this,
         QString::fromUtf8("选择学生课程CSV文件"),
         QString(),
-        QString::fromUtf8("CSV文件 (*.csv);;所有文件 (*.*)")
+        QString::fromUtf8("CSV文件 (*.csv);;日历文件 (*.ics);;所有文件 (*.*)")
     );
     
     if (!fileName.isEmpty()) {
@@ -1,25 +1,71 @@
 #include "MainWindow.h"
 #include "ui_MainWindow.h"
 #include "../modules/FileParser.h"
+#include "../modules/ContentHash.h"
+#include "../modules/WeekLayout.h"
 #include "../modules/SchedulerLogic.h"
 #include <QMessageBox>
 #include <QInputDialog>
 #include <QFileInfo>
 #include <QDir>
 #include <QListWidgetItem>
+#include <QElapsedTimer>
+#include <QFileDialog>
+#include <QSignalBlocker>
 
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
-    , nextEventId(1) {
+    , nextEventId(1)
+    , importProgress(nullptr)
+    , importTimer(new QTimer(this))
+    , importSuccessCount(0)
+    , importSkipCount(0)
+    , importEventId(1)
+    , importChangedCount(0)
+    , currentImportProfessor(static_cast<std::size_t>(-1))
+    , availabilityProgress(nullptr)
+    , availabilityTimer(new QTimer(this))
+    , availabilityStudentHash(0)
+    , recommendWeekCount(0)
+    , recommendTimer(new QTimer(this))
+    , hasDragEvent(false) {
     
     ui->setupUi(this);
+
+    // 标签筛选选项，数据为 anyTags 掩码（0 表示不筛选）
+    {
+        QSignalBlocker blocker(ui->tagFilterCombo);
+        ui->tagFilterCombo->addItem(QString::fromUtf8("全部事件"), 0u);
+        ui->tagFilterCombo->addItem(QString::fromUtf8("考试（期中/期末）"),
+                                    static_cast<unsigned int>(TAG_MIDTERM | TAG_FINAL));
+        for (int bit = 0; bit < EVENT_TAG_COUNT; ++bit) {
+            ui->tagFilterCombo->addItem(QString::fromUtf8(eventTagName(bit)), 1u << bit);
+        }
+    }
+
+    // 导入批次在界面线程中按时间片合并
+    importTimer->setInterval(30);
+    connect(importTimer, &QTimer::timeout, this, &MainWindow::onImportTimerTick);
+    availabilityTimer->setInterval(50);
+    connect(availabilityTimer, &QTimer::timeout, this, &MainWindow::onAvailabilityTimerTick);
+    recommendTimer->setInterval(50);
+    connect(recommendTimer, &QTimer::timeout, this, &MainWindow::onRecommendTimerTick);
     
     // 手动连接 ScheduleView 的删除信号
     connect(ui->scheduleView, &ScheduleView::deleteEventRequested, this, &MainWindow::onDeleteEventRequested);
+    connect(ui->scheduleView, &ScheduleView::eventDragStarted, this, &MainWindow::onEventDragStarted);
+    connect(ui->scheduleView, &ScheduleView::eventDragProposed, this, &MainWindow::onEventDragProposed);
+    connect(ui->scheduleView, &ScheduleView::eventDropped, this, &MainWindow::onEventDropped);
+    
+    // 日程的增删改都通过变化通知更新课表，只重绘受影响的单元格
+    dataManager.subscribe([this](const ChangeSet& changes) {
+        applyScheduleChanges(changes);
+    });
     
     // 设置数据文件路径
     userDataPath = "data_storage/user_data.txt";
+    userStorePath = "data_storage/users";
     professorDataPath = "data_storage/professor_data.txt";
     
     // 确保数据目录存在
@@ -38,41 +84,153 @@ MainWindow::~MainWindow() {
 
 
 void MainWindow::loadData() {
-    // 加载用户数据
-    QFileInfo userFile(userDataPath);
-    if (userFile.exists()) {
-        User& user = dataManager.getUser();
-        if (dataManager.loadUserData(user, userDataPath.toStdString())) {
-            ui->statusbar->showMessage(QString::fromUtf8("用户数据已加载"), 3000);
-            
-            // 找到最大的事件ID
-            for (const auto& event : user.getCourses().getAllEvents()) {
-                if (event.getId() >= nextEventId) {
-                    nextEventId = event.getId() + 1;
+    // 加载用户数据：每个学生一个文件，只读取当前学生的文件
+    UserStore& store = dataManager.getUserStore();
+    bool loaded = false;
+    if (!store.isOpen()) {
+        if (dataManager.openUserStore(userStorePath.toStdString())) {
+            // 首次运行时把旧的单用户数据文件迁移为默认学生
+            if (store.getDirectory().empty()) {
+                store.addUser("default", "Student");
+                QFileInfo userFile(userDataPath);
+                if (userFile.exists()) {
+                    User legacyUser;
+                    if (dataManager.loadUserData(legacyUser, userDataPath.toStdString())) {
+                        store.storeUser("default", legacyUser);
+                    }
                 }
             }
-            for (const auto& event : user.getPersonalSchedule().getAllEvents()) {
-                if (event.getId() >= nextEventId) {
-                    nextEventId = event.getId() + 1;
-                }
+            if (!store.getDirectory().empty()) {
+                loaded = dataManager.switchUser(store.getDirectory().front().id);
             }
         }
+    } else {
+        loaded = dataManager.reloadCurrentUser();
+    }
+
+    if (loaded) {
+        showLoadMessage(QString::fromUtf8("用户数据已加载"));
+        refreshNextEventId();
     } else {
         dataManager.getUser().setName("Student");
     }
+    updateWindowTitle();
 
     // 加载教师数据
     QFileInfo profFile(professorDataPath);
     if (profFile.exists()) {
         if (dataManager.loadProfessorsData(professorDataPath.toStdString())) {
-            ui->statusbar->showMessage(QString::fromUtf8("教师数据已加载"), 3000);
+            showLoadMessage(QString::fromUtf8("教师数据已加载"));
+        }
+    }
+}
+
+void MainWindow::showLoadMessage(const QString& message) {
+    // 格式错误的行已被跳过，在状态栏中提示数量
+    const auto& errors = dataManager.getLastLoadErrors();
+    if (errors.empty()) {
+        ui->statusbar->showMessage(message, 3000);
+    } else {
+        ui->statusbar->showMessage(QString::fromUtf8("%1（跳过 %2 行格式错误，首个错误位于第 %3 行）")
+                                   .arg(message)
+                                   .arg(errors.size())
+                                   .arg(errors.front().lineNumber), 5000);
+    }
+}
+
+void MainWindow::refreshNextEventId() {
+    // 找到最大的事件ID
+    const User& user = dataManager.getUser();
+    nextEventId = 1;
+    for (const auto& event : user.getCourses().getAllEvents()) {
+        if (event.getId() >= nextEventId) {
+            nextEventId = event.getId() + 1;
+        }
+    }
+    for (const auto& event : user.getPersonalSchedule().getAllEvents()) {
+        if (event.getId() >= nextEventId) {
+            nextEventId = event.getId() + 1;
+        }
+    }
+}
+
+void MainWindow::updateWindowTitle() {
+    setWindowTitle(QString::fromUtf8("学生日程管理系统 - %1")
+                   .arg(QString::fromUtf8(dataManager.getUser().getName().c_str())));
+}
+
+void MainWindow::onSwitchUserTriggered() {
+    UserStore& store = dataManager.getUserStore();
+    if (importPipeline) {
+        QMessageBox::information(this, QString::fromUtf8("提示"),
+                               QString::fromUtf8("导入完成后才能切换学生"));
+        return;
+    }
+
+    QStringList choices;
+    int currentIndex = 0;
+    for (std::size_t i = 0; i < store.getDirectory().size(); ++i) {
+        const UserRecord& record = store.getDirectory()[i];
+        choices << QString::fromUtf8("%1 (%2)")
+                   .arg(QString::fromUtf8(record.name.c_str()))
+                   .arg(QString::fromUtf8(record.id.c_str()));
+        if (record.id == dataManager.getCurrentUserId()) {
+            currentIndex = static_cast<int>(i);
         }
     }
+    QString newUserChoice = QString::fromUtf8("新建学生...");
+    choices << newUserChoice;
+
+    bool ok = false;
+    QString selected = QInputDialog::getItem(this, QString::fromUtf8("切换学生"),
+                                             QString::fromUtf8("选择学生:"),
+                                             choices, currentIndex, false, &ok);
+    if (!ok) {
+        return;
+    }
+
+    std::string userId;
+    int selectedIndex = choices.indexOf(selected);
+    if (selected == newUserChoice) {
+        QString id = QInputDialog::getText(this, QString::fromUtf8("新建学生"),
+                                           QString::fromUtf8("学号:"), QLineEdit::Normal,
+                                           QString(), &ok).trimmed();
+        if (!ok || id.isEmpty()) {
+            return;
+        }
+        QString name = QInputDialog::getText(this, QString::fromUtf8("新建学生"),
+                                             QString::fromUtf8("姓名:"), QLineEdit::Normal,
+                                             id, &ok).trimmed();
+        if (!ok) {
+            return;
+        }
+        if (!store.addUser(id.toStdString(), name.toStdString())) {
+            QMessageBox::warning(this, QString::fromUtf8("新建失败"),
+                               QString::fromUtf8("学号已存在或包含逗号"));
+            return;
+        }
+        userId = id.toStdString();
+    } else {
+        userId = store.getDirectory()[selectedIndex].id;
+    }
+
+    if (!dataManager.switchUser(userId)) {
+        QMessageBox::warning(this, QString::fromUtf8("切换失败"),
+                           QString::fromUtf8("无法加载该学生的数据"));
+        return;
+    }
+
+    showLoadMessage(QString::fromUtf8("已切换学生"));
+    refreshNextEventId();
+    availabilityCache.clear();
+    updateWindowTitle();
 }
 
 void MainWindow::saveData() {
-    dataManager.saveUserData(dataManager.getUser(), userDataPath.toStdString());
-    dataManager.saveProfessorsData(dataManager.getProfessors(), professorDataPath.toStdString());
+    // 只写回当前学生的文件
+    dataManager.saveCurrentUser();
+    // 教师数据通常很大且很少变化，没有变化时不重写
+    dataManager.saveProfessorsIfChanged(professorDataPath.toStdString());
 }
 
 void MainWindow::updateScheduleView() {
@@ -80,13 +238,169 @@ void MainWindow::updateScheduleView() {
     Schedule combinedSchedule = dataManager.getUser().getCourses() +
                                dataManager.getUser().getPersonalSchedule();
     
-    ui->scheduleView->setSchedule(combinedSchedule.getAllEvents());
+    std::shared_ptr<const CompressedBitmap> matched = currentFilter();
+    if (!matched) {
+        ui->scheduleView->setSchedule(combinedSchedule.getAllEvents());
+    } else {
+        std::vector<ScheduleEvent> filtered;
+        for (const auto& event : combinedSchedule.getAllEvents()) {
+            if (matched->contains(static_cast<std::uint32_t>(event.getId()))) {
+                filtered.push_back(event);
+            }
+        }
+        ui->scheduleView->setSchedule(filtered);
+    }
+    ui->scheduleView->setLayoutSource(dataManager.getUserSnapshot(), matched);
+
+    // 数据变化后刷新正在显示的搜索结果
+    if (!ui->searchEdit->text().isEmpty()) {
+        refreshSearchResults();
+    }
+    updateUndoActions();
+}
+
+std::shared_ptr<const CompressedBitmap> MainWindow::currentFilter() const {
+    unsigned int anyTags = ui->tagFilterCombo->currentData().toUInt();
+    bool upcomingOnly = ui->upcomingCheck->isChecked();
+    if (anyTags == 0 && !upcomingOnly) {
+        return nullptr;
+    }
+
+    // 标签位图与时间索引求交
+    std::time_t from = 0;
+    std::time_t to = 0;
+    if (upcomingOnly) {
+        from = QDateTime(QDate::currentDate(), QTime(0, 0)).toSecsSinceEpoch();
+        to = from + 28 * 24 * 3600;
+    }
+    return std::make_shared<const CompressedBitmap>(dataManager.filterEvents(0, anyTags, from, to));
+}
+
+void MainWindow::applyScheduleChanges(const ChangeSet& changes) {
+    if (changes.reset) {
+        updateScheduleView();
+        return;
+    }
+
+    // 有筛选条件时，按变化后的索引判断事件是否仍应显示
+    std::shared_ptr<const CompressedBitmap> matched = currentFilter();
+
+    // 同一事件多次变化时只保留最终状态
+    std::vector<int> order;
+    std::unordered_map<int, const ScheduleEvent*> latest;
+    for (const auto& change : changes.changes) {
+        int eventId = change.event.getId();
+        bool visible = change.kind != EventChange::Kind::Removed &&
+                       (!matched || matched->contains(static_cast<std::uint32_t>(eventId)));
+        if (latest.find(eventId) == latest.end()) {
+            order.push_back(eventId);
+        }
+        latest[eventId] = visible ? &change.event : nullptr;
+    }
+
+    std::vector<ScheduleEvent> upserts;
+    std::vector<int> removedIds;
+    for (int eventId : order) {
+        if (latest[eventId]) {
+            upserts.push_back(*latest[eventId]);
+        } else {
+            removedIds.push_back(eventId);
+        }
+    }
+    ui->scheduleView->updateEvents(upserts, removedIds);
+    ui->scheduleView->applyChanges(dataManager.getUserSnapshot(), matched, changes);
+
+    if (!ui->searchEdit->text().isEmpty()) {
+        refreshSearchResults();
+    }
+    updateUndoActions();
+}
+
+void MainWindow::updateUndoActions() {
+    ui->undoAction->setEnabled(dataManager.canUndo());
+    ui->redoAction->setEnabled(dataManager.canRedo());
+    ui->undoAction->setText(dataManager.canUndo()
+        ? QString::fromUtf8("撤销%1").arg(QString::fromUtf8(dataManager.getUndoLabel().c_str()))
+        : QString::fromUtf8("撤销"));
+    ui->redoAction->setText(dataManager.canRedo()
+        ? QString::fromUtf8("重做%1").arg(QString::fromUtf8(dataManager.getRedoLabel().c_str()))
+        : QString::fromUtf8("重做"));
+}
+
+void MainWindow::onUndoTriggered() {
+    if (dataManager.undo()) {
+        saveData();
+    }
+}
+
+void MainWindow::onRedoTriggered() {
+    if (dataManager.redo()) {
+        saveData();
+    }
+}
+
+void MainWindow::onTagFilterChanged() {
+    updateScheduleView();
+}
+
+void MainWindow::onSearchTextChanged(const QString& text) {
+    Q_UNUSED(text);
+    refreshSearchResults();
+}
+
+void MainWindow::refreshSearchResults() {
+    ui->searchResultList->clear();
+
+    QString query = ui->searchEdit->text().trimmed();
+    if (query.isEmpty()) {
+        return;
+    }
+
+    std::vector<SearchHit> hits = dataManager.getSearchIndex().search(query.toStdString(), 50);
+    for (const auto& hit : hits) {
+        QString kindText;
+        switch (hit.kind) {
+            case SearchHit::Kind::Course:    kindText = QString::fromUtf8("课程"); break;
+            case SearchHit::Kind::Personal:  kindText = QString::fromUtf8("个人"); break;
+            case SearchHit::Kind::Professor: kindText = QString::fromUtf8("教师"); break;
+        }
+
+        QListWidgetItem* item = new QListWidgetItem(
+            QString::fromUtf8("[%1] %2").arg(kindText).arg(QString::fromUtf8(hit.label.c_str())),
+            ui->searchResultList);
+        item->setData(Qt::UserRole, static_cast<int>(hit.kind));
+        item->setData(Qt::UserRole + 1, hit.id);
+    }
+}
+
+void MainWindow::onSearchResultActivated(QListWidgetItem* item) {
+    if (!item) {
+        return;
+    }
+
+    auto kind = static_cast<SearchHit::Kind>(item->data(Qt::UserRole).toInt());
+    int id = item->data(Qt::UserRole + 1).toInt();
+
+    if (kind != SearchHit::Kind::Professor) {
+        showEventDetails(id);
+        return;
+    }
+
+    const Professor& prof = dataManager.getProfessor(static_cast<DataManager::ProfessorHandle>(id));
+    QMessageBox::information(this, QString::fromUtf8("教师信息"),
+                           QString::fromUtf8("姓名: %1\n邮箱: %2\n办公时间: %3 个")
+                           .arg(QString::fromUtf8(prof.getName().c_str()))
+                           .arg(QString::fromUtf8(prof.getEmail().c_str()))
+                           .arg(prof.getOfficeHours().getAllEvents().size()));
 }
 
 // 按钮和 Action 槽函数（Qt 自动连接）
 void MainWindow::on_addEventBtn_clicked() {
     AddEventDialog dialog(this);
-    
+    addEventFromDialog(dialog);
+}
+
+void MainWindow::addEventFromDialog(AddEventDialog& dialog) {
     if (dialog.exec() == QDialog::Accepted) {
         ScheduleEvent event = dialog.getEvent();
         event.setId(nextEventId++);
@@ -95,14 +409,9 @@ void MainWindow::on_addEventBtn_clicked() {
         bool success = false;
         
         // 根据是否为课程添加到不同的日程
-        if (event.getTimeSlot().getIsCourse()) {
-            success = dataManager.getUser().getCourses().addEventSafely(event, errorMsg);
-        } else {
-            success = dataManager.getUser().getPersonalSchedule().addEventSafely(event, errorMsg);
-        }
+        success = dataManager.addUserEvent(event, errorMsg);
         
         if (success) {
-            updateScheduleView();
             saveData();
             QMessageBox::information(this, QString::fromUtf8("添加成功"), 
                                    QString::fromUtf8("事件已成功添加"));
@@ -127,39 +436,10 @@ void MainWindow::on_importStudentCoursesBtn_clicked() {
             return;
         }
         
-        try {
-            // 使用FileParser解析CSV文件
-            Schedule importedSchedule = FileParser::parseCsv(filePath.toStdString());
-            
-            // 将导入的课程添加到用户的课程日程中
-            const auto& events = importedSchedule.getAllEvents();
-            int successCount = 0;
-            int skipCount = 0;
-            
-            for (const auto& event : events) {
-                ScheduleEvent newEvent = event;
-                newEvent.setId(nextEventId++);
-                
-                std::string errorMsg;
-                if (dataManager.getUser().getCourses().addEventSafely(newEvent, errorMsg)) {
-                    successCount++;
-                } else {
-                    skipCount++;
-                    // 回滚ID计数
-                    nextEventId--;
-                }
-            }
-            
-            updateScheduleView();
-            saveData();
-            
-            QMessageBox::information(this, QString::fromUtf8("导入结果"),
-                                   QString::fromUtf8("成功导入 %1 个课程事件，跳过 %2 个冲突或重复事件")
-                                   .arg(successCount).arg(skipCount));
-            
-        } catch (const std::exception& e) {
-            QMessageBox::critical(this, QString::fromUtf8("导入错误"),
-                                QString::fromUtf8("导入失败: %1").arg(e.what()));
+        if (filePath.endsWith(".ics", Qt::CaseInsensitive)) {
+            importStudentIcs(filePath);
+        } else {
+            startImport(ImportPipeline::Kind::StudentCourses, filePath);
         }
     }
 }
@@ -170,41 +450,289 @@ void MainWindow::on_importProfessorBtn_clicked() {
     if (dialog.exec() == QDialog::Accepted) {
         QString filePath = dialog.getFilePath();
         
-        if (!filePath.isEmpty()) {
-            try {
-                std::vector<Professor> professors = FileParser::parseProfessorsCsv(filePath.toStdString());
-                
-                if (professors.empty()) {
-                    QMessageBox::warning(this, QString::fromUtf8("导入失败"),
-                                       QString::fromUtf8("未能从文件中读取教师数据"));
-                    return;
-                }
-                
-                // 合并导入的教师数据
-                for (const auto& prof : professors) {
-                    bool found = false;
-                    for (auto& existingProf : const_cast<std::vector<Professor>&>(dataManager.getProfessors())) {
-                        if (existingProf.getName() == prof.getName()) {
-                            existingProf = prof;
-                            found = true;
-                            break;
-                        }
-                    }
-                    if (!found) {
-                        const_cast<std::vector<Professor>&>(dataManager.getProfessors()).push_back(prof);
-                    }
-                }
-                
-                saveData();
-                
-            } catch (const std::exception& e) {
-                QMessageBox::critical(this, QString::fromUtf8("导入错误"),
-                                    QString::fromUtf8("导入失败: %1").arg(e.what()));
+        if (filePath.isEmpty()) {
+            return;
+        }
+        if (filePath.endsWith(".ics", Qt::CaseInsensitive)) {
+            importProfessorIcs(filePath);
+        } else {
+            startImport(ImportPipeline::Kind::Professors, filePath);
+        }
+    }
+}
+
+void MainWindow::getIcsImportWindow(std::time_t& windowStart, std::time_t& windowEnd) const {
+    // 重复事件只展开从当前显示周的周一开始的一个学期（26周）
+    QDate today = QDate::currentDate();
+    QDate monday = today.addDays(1 - today.dayOfWeek())
+                        .addDays(ui->scheduleView->getCurrentWeekOffset() * 7);
+    windowStart = QDateTime(monday, QTime(0, 0)).toSecsSinceEpoch();
+    windowEnd = QDateTime(monday.addDays(26 * 7), QTime(0, 0)).toSecsSinceEpoch();
+}
+
+void MainWindow::importStudentIcs(const QString& filePath) {
+    std::time_t windowStart, windowEnd;
+    getIcsImportWindow(windowStart, windowEnd);
+
+    // 日历中的每次发生都有具体日期，加入个人日程
+    int unsupportedCount = 0;
+    Schedule imported = FileParser::parseIcs(filePath.toStdString(), windowStart, windowEnd, unsupportedCount);
+    int successCount = 0;
+    int skipCount = 0;
+    // 整个日历作为一步撤销
+    dataManager.beginEdit("导入日历");
+    for (const auto& event : imported.getAllEvents()) {
+        ScheduleEvent newEvent = event;
+        newEvent.setId(nextEventId++);
+
+        std::string errorMsg;
+        if (dataManager.addPersonalEvent(newEvent, errorMsg)) {
+            successCount++;
+        } else {
+            skipCount++;
+            // 回滚ID计数
+            nextEventId--;
+        }
+    }
+    dataManager.endEdit();
+
+    saveData();
+    QString message = QString::fromUtf8("成功导入 %1 个日历事件，跳过 %2 个冲突或重复事件")
+                          .arg(successCount).arg(skipCount);
+    if (unsupportedCount > 0) {
+        message += QString::fromUtf8("\n另有 %1 个事件的重复规则无法展开，未导入").arg(unsupportedCount);
+    }
+    QMessageBox::information(this, QString::fromUtf8("导入结果"), message);
+}
+
+void MainWindow::importProfessorIcs(const QString& filePath) {
+    // .ics 中没有教师信息，由用户填写
+    bool ok = false;
+    QString name = QInputDialog::getText(this, QString::fromUtf8("教师信息"),
+                                         QString::fromUtf8("教师姓名:"), QLineEdit::Normal,
+                                         QFileInfo(filePath).completeBaseName(), &ok);
+    if (!ok || name.trimmed().isEmpty()) {
+        return;
+    }
+    QString email = QInputDialog::getText(this, QString::fromUtf8("教师信息"),
+                                          QString::fromUtf8("教师邮箱:"), QLineEdit::Normal,
+                                          QString(), &ok);
+    if (!ok) {
+        return;
+    }
+
+    std::time_t windowStart, windowEnd;
+    getIcsImportWindow(windowStart, windowEnd);
+    int unsupportedCount = 0;
+    Professor prof = FileParser::parseProfessorIcs(filePath.toStdString(),
+                                                   name.trimmed().toStdString(),
+                                                   email.trimmed().toStdString(),
+                                                   windowStart, windowEnd, unsupportedCount);
+    if (prof.getOfficeHours().getAllEvents().empty()) {
+        QMessageBox::warning(this, QString::fromUtf8("导入失败"),
+                           QString::fromUtf8("未能从日历中读取办公时间"));
+        return;
+    }
+
+    // 同名教师替换，否则追加
+    std::size_t officeHourCount = prof.getOfficeHours().getAllEvents().size();
+    std::uint64_t contentHash = ContentHash::hashProfessor(prof);
+    bool changed = false;
+    DataManager::ProfessorHandle handle = dataManager.upsertProfessor(std::move(prof), contentHash, changed);
+    if (changed) {
+        availabilityCache.invalidateProfessor(handle);
+    }
+
+    saveData();
+    QString message = QString::fromUtf8("已导入 %1 的 %2 个办公时间")
+                          .arg(name.trimmed())
+                          .arg(officeHourCount);
+    if (unsupportedCount > 0) {
+        message += QString::fromUtf8("\n另有 %1 个事件的重复规则无法展开，未导入").arg(unsupportedCount);
+    }
+    QMessageBox::information(this, QString::fromUtf8("导入结果"), message);
+}
+
+void MainWindow::startImport(ImportPipeline::Kind kind, const QString& filePath) {
+    if (importPipeline) {
+        QMessageBox::information(this, QString::fromUtf8("提示"),
+                               QString::fromUtf8("已有导入任务正在进行"));
+        return;
+    }
+
+    importPipeline = std::make_unique<ImportPipeline>(kind, filePath.toStdString());
+    if (!importPipeline->start()) {
+        importPipeline.reset();
+        QMessageBox::critical(this, QString::fromUtf8("导入错误"),
+                            QString::fromUtf8("无法打开文件: %1").arg(filePath));
+        return;
+    }
+
+    importSuccessCount = 0;
+    importSkipCount = 0;
+    importEventId = 1;
+    importChangedCount = 0;
+    clearStagedProfessors();
+
+    // 分批合并的所有课程作为一步撤销，在 finishImport 中结束
+    dataManager.beginEdit("导入课程");
+
+    // 进度对话框只阻止对主窗口的输入，界面仍会随批次提交而刷新
+    importProgress = new QProgressDialog(QString::fromUtf8("正在导入..."),
+                                         QString::fromUtf8("取消"), 0, 100, this);
+    importProgress->setWindowModality(Qt::WindowModal);
+    importProgress->setAutoClose(false);
+    importProgress->setAutoReset(false);
+    importProgress->setMinimumDuration(300);
+    importProgress->setValue(0);
+    connect(importProgress, &QProgressDialog::canceled, this, [this]() {
+        if (importPipeline) {
+            importPipeline->cancel();
+            finishImport();
+        }
+    });
+
+    importTimer->start();
+}
+
+void MainWindow::onImportTimerTick() {
+    if (!importPipeline) {
+        importTimer->stop();
+        return;
+    }
+
+    // 每次最多占用约 20ms，保证界面响应
+    QElapsedTimer budget;
+    budget.start();
+    bool merged = false;
+    ImportPipeline::Batch batch;
+    while (budget.elapsed() < 20 && importPipeline->tryTakeBatch(batch)) {
+        mergeImportBatch(batch);
+        merged = true;
+    }
+
+    if (merged) {
+        // 导入分组尚未结束，按批次把新增课程推送到课表
+        dataManager.flushChanges();
+    }
+    if (importProgress) {
+        importProgress->setValue(importPipeline->getProgressPercent());
+        importProgress->setLabelText(QString::fromUtf8("正在导入... 已处理 %1 条").arg(importSuccessCount + importSkipCount));
+    }
+
+    if (importPipeline->isFinished()) {
+        finishImport();
+    }
+}
+
+void MainWindow::mergeImportBatch(ImportPipeline::Batch& batch) {
+    // 将导入的课程添加到用户的课程日程中
+    for (auto& event : batch.courses) {
+        event.setId(nextEventId++);
+        
+        std::string errorMsg;
+        if (dataManager.addCourse(event, errorMsg)) {
+            importSuccessCount++;
+        } else {
+            importSkipCount++;
+            // 回滚ID计数
+            nextEventId--;
+        }
+    }
+
+    // 暂存导入的教师数据：同名教师的办公时间按首次出现的顺序归并
+    for (auto& record : batch.professors) {
+        if (!record.profName.empty()) {
+            auto inserted = stagedProfessorIndex.emplace(record.profName, stagedProfessors.size());
+            if (inserted.second) {
+                stagedProfessors.push_back(Professor(record.profName, record.profEmail));
+                stagedOfficeHoursHashes.push_back(0);
+                importSuccessCount++;
             }
+            currentImportProfessor = inserted.first->second;
+        }
+
+        if (record.hasEvent && currentImportProfessor < stagedProfessors.size()) {
+            record.event.setId(importEventId++);
+            stagedOfficeHoursHashes[currentImportProfessor] += ContentHash::hashEvent(record.event);
+            stagedProfessors[currentImportProfessor].getOfficeHours().addEvent(record.event);
         }
     }
 }
 
+void MainWindow::commitStagedProfessors() {
+    // 只替换内容哈希有变化的教师，并只让这些教师的可用时间缓存失效
+    for (std::size_t i = 0; i < stagedProfessors.size(); ++i) {
+        std::uint64_t contentHash = ContentHash::hashProfessor(stagedProfessors[i].getEmail(),
+                                                               stagedOfficeHoursHashes[i]);
+        bool changed = false;
+        DataManager::ProfessorHandle handle =
+            dataManager.upsertProfessor(std::move(stagedProfessors[i]), contentHash, changed);
+        if (changed) {
+            availabilityCache.invalidateProfessor(handle);
+            importChangedCount++;
+        }
+    }
+
+    clearStagedProfessors();
+}
+
+void MainWindow::clearStagedProfessors() {
+    stagedProfessors.clear();
+    stagedOfficeHoursHashes.clear();
+    stagedProfessorIndex.clear();
+    currentImportProfessor = static_cast<std::size_t>(-1);
+}
+
+void MainWindow::finishImport() {
+    importTimer->stop();
+    if (!importPipeline) {
+        return;
+    }
+
+    // 取出剩余批次（取消时队列已被清空）
+    ImportPipeline::Batch batch;
+    while (importPipeline->tryTakeBatch(batch)) {
+        mergeImportBatch(batch);
+    }
+
+    ImportPipeline::Kind kind = importPipeline->getKind();
+    bool cancelled = importPipeline->isCancelled();
+    importPipeline.reset();
+    if (cancelled) {
+        // 取消时正在读取的教师只有部分办公时间，同名教师的记录也可能还在文件后部，
+        // 提交会用不完整的办公时间替换已有数据，因此暂存的教师全部丢弃
+        clearStagedProfessors();
+    } else {
+        commitStagedProfessors();
+    }
+    dataManager.endEdit();
+
+    if (importProgress) {
+        importProgress->deleteLater();
+        importProgress = nullptr;
+    }
+
+    saveData();
+
+    QString cancelNote = cancelled ? QString::fromUtf8("（导入已取消，仅保留已处理部分）") : QString();
+    if (kind == ImportPipeline::Kind::StudentCourses) {
+        QMessageBox::information(this, QString::fromUtf8("导入结果"),
+                               QString::fromUtf8("成功导入 %1 个课程事件，跳过 %2 个冲突或重复事件%3")
+                               .arg(importSuccessCount).arg(importSkipCount).arg(cancelNote));
+    } else if (cancelled) {
+        QMessageBox::information(this, QString::fromUtf8("导入结果"),
+                               QString::fromUtf8("导入已取消，教师数据未做改动"));
+    } else if (importSuccessCount == 0) {
+        QMessageBox::warning(this, QString::fromUtf8("导入失败"),
+                           QString::fromUtf8("未能从文件中读取教师数据"));
+    } else {
+        QMessageBox::information(this, QString::fromUtf8("导入结果"),
+                               QString::fromUtf8("成功导入 %1 位教师，其中 %2 位有变化")
+                               .arg(importSuccessCount).arg(importChangedCount));
+    }
+}
+
 void MainWindow::on_calculateBtn_clicked() {
     const auto& professors = dataManager.getProfessors();
     
@@ -214,8 +742,15 @@ void MainWindow::on_calculateBtn_clicked() {
         return;
     }
 
-    // 让用户选择教师
+    if (availabilityTask) {
+        QMessageBox::information(this, QString::fromUtf8("提示"),
+                               QString::fromUtf8("已有可用时间计算正在进行"));
+        return;
+    }
+
+    // 让用户选择教师，第一项为全部教师
     QStringList profNames;
+    profNames << QString::fromUtf8("全部教师");
     for (const auto& prof : professors) {
         profNames << QString::fromUtf8(prof.getName().c_str());
     }
@@ -225,39 +760,312 @@ void MainWindow::on_calculateBtn_clicked() {
                                                  QString::fromUtf8("选择教师"),
                                                  QString::fromUtf8("请选择要计算可用时间的教师:"),
                                                  profNames, 0, false, &ok);
+    if (!ok || selectedName.isEmpty()) {
+        return;
+    }
 
-    if (ok && !selectedName.isEmpty()) {
-        Professor prof = dataManager.getProfessorByName(selectedName.toStdString());
-        
-        // 合并学生的课程和个人日程
-        Schedule studentSchedule = dataManager.getUser().getCourses() +
-                                  dataManager.getUser().getPersonalSchedule();
+    std::vector<DataManager::ProfessorHandle> handles;
+    if (selectedName == profNames.front()) {
+        for (std::size_t i = 0; i < professors.size(); ++i) {
+            handles.push_back(i);
+        }
+    } else {
+        DataManager::ProfessorHandle handle = dataManager.findProfessorByName(selectedName.toStdString());
+        if (handle == DataManager::invalidProfessor) {
+            return;
+        }
+        handles.push_back(handle);
+    }
 
-        // 取当前周偏移（来自 ScheduleView）
-        int weekOffset = ui->scheduleView->getCurrentWeekOffset();
-        
-        // 计算可用时间段（集中使用数据层的周过滤/归一化）
-        std::vector<TimeSlot> availableSlots = SchedulerLogic::findAvailableSlots(
-            studentSchedule,
-            prof.getOfficeHours(),
-            weekOffset
-        );
+    // 从当前显示的周开始计算若干周
+    int weekCount = QInputDialog::getInt(this,
+                                         QString::fromUtf8("计算范围"),
+                                         QString::fromUtf8("从当前周开始计算的周数:"),
+                                         1, 1, 26, 1, &ok);
+    if (!ok) {
+        return;
+    }
+    int firstWeek = ui->scheduleView->getCurrentWeekOffset();
+    
+    // 合并学生的课程和个人日程（写时复制，不拷贝事件）
+    Schedule studentSchedule = dataManager.getUser().getCourses() +
+                              dataManager.getUser().getPersonalSchedule();
+    availabilityStudentHash = ContentHash::hashSchedule(studentSchedule);
+    availabilityWeeks = WeekLayoutBuilder();
+
+    // 教师和学生日程都没有变化的组合直接使用上次的结果，其余交给线程池
+    availabilityResults.clear();
+    std::vector<AvailabilityTask::Query> queries;
+    for (DataManager::ProfessorHandle handle : handles) {
+        const Professor& prof = dataManager.getProfessor(handle);
+        std::uint64_t revision = dataManager.getProfessorRevision(handle);
+        for (int week = firstWeek; week < firstWeek + weekCount; ++week) {
+            std::vector<TimeSlot> slots;
+            std::time_t weekStart = std::chrono::system_clock::to_time_t(availabilityWeeks.timeAt(week, 0, 0));
+            if (availabilityCache.lookup(handle, weekStart, revision, availabilityStudentHash, slots)) {
+                availabilityResults.push_back(AvailabilityResult{handle, prof.getName(), prof.getEmail(),
+                                                                 revision, week, std::move(slots), true});
+            } else {
+                queries.push_back(AvailabilityTask::Query{handle, prof.getName(), prof.getEmail(),
+                                                          revision, prof.getOfficeHours(), week});
+            }
+        }
+    }
 
-        // 显示结果
-        ResultDisplayWidget* resultWidget = new ResultDisplayWidget(this);
-        resultWidget->setResults(
-            QString::fromUtf8(prof.getName().c_str()),
-            QString::fromUtf8(prof.getEmail().c_str()),
-            availableSlots
-        );
-        resultWidget->exec();
-        delete resultWidget;
+    availabilityTask = std::make_unique<AvailabilityTask>(computePool, std::move(studentSchedule),
+                                                          std::move(queries));
+    availabilityTask->start();
+    if (availabilityTask->isFinished()) {
+        finishAvailability();
+        return;
     }
+
+    availabilityProgress = new QProgressDialog(QString::fromUtf8("正在计算可用时间..."),
+                                               QString::fromUtf8("取消"), 0, 100, this);
+    availabilityProgress->setWindowModality(Qt::WindowModal);
+    availabilityProgress->setAutoClose(false);
+    availabilityProgress->setAutoReset(false);
+    availabilityProgress->setMinimumDuration(300);
+    availabilityProgress->setValue(0);
+    connect(availabilityProgress, &QProgressDialog::canceled, this, [this]() {
+        if (availabilityTask) {
+            // 正在运行的查询会算完，未开始的直接跳过，结束后由定时器收尾
+            availabilityTask->cancel();
+        }
+    });
+
+    availabilityTimer->start();
+}
+
+void MainWindow::onRecommendTriggered() {
+    const auto& professors = dataManager.getProfessors();
+    if (professors.empty()) {
+        QMessageBox::information(this, QString::fromUtf8("提示"),
+                               QString::fromUtf8("请先导入教师办公时间"));
+        return;
+    }
+
+    // 偏好方案，每项为 earliest/longest/preferredHours/adjacent 四个权重
+    QStringList presets;
+    presets << QString::fromUtf8("越早越好")
+            << QString::fromUtf8("时间越长越好")
+            << QString::fromUtf8("工作时间内（9:00-18:00）")
+            << QString::fromUtf8("紧挨已有日程");
+    const double weights[4][4] = {
+        {1.0, 0.0, 0.0, 0.0},
+        {0.2, 1.0, 0.0, 0.0},
+        {0.3, 0.0, 1.0, 0.0},
+        {0.3, 0.0, 0.0, 1.0}
+    };
+
+    bool ok;
+    QString preset = QInputDialog::getItem(this, QString::fromUtf8("推荐时间"),
+                                           QString::fromUtf8("优先考虑:"), presets, 0, false, &ok);
+    if (!ok) {
+        return;
+    }
+    int minMinutes = QInputDialog::getInt(this, QString::fromUtf8("推荐时间"),
+                                          QString::fromUtf8("最短时长（分钟）:"),
+                                          30, 15, 240, 15, &ok);
+    if (!ok) {
+        return;
+    }
+
+    const double* weight = weights[std::max(0, static_cast<int>(presets.indexOf(preset)))];
+    SchedulerLogic::Preferences preferences;
+    preferences.minDurationMinutes = minMinutes;
+    preferences.earliestWeight = weight[0];
+    preferences.longestWeight = weight[1];
+    preferences.preferredHoursWeight = weight[2];
+    preferences.adjacentWeight = weight[3];
+
+    // 在所有教师、从当前周起的四周内推荐三个
+    // 日程都是写时复制的快照，在线程池中计算，界面线程可以继续修改数据
+    recommendWeekCount = 4;
+    Schedule studentSchedule = dataManager.getUser().getCourses() +
+                              dataManager.getUser().getPersonalSchedule();
+    std::vector<Schedule> officeHours;
+    officeHours.reserve(professors.size());
+    recommendProfessors.clear();
+    for (const auto& prof : professors) {
+        officeHours.push_back(prof.getOfficeHours());
+        recommendProfessors.emplace_back(prof.getName(), prof.getEmail());
+    }
+    int firstWeek = ui->scheduleView->getCurrentWeekOffset();
+    int weekCount = recommendWeekCount;
+    recommendFuture = computePool.submit([studentSchedule, officeHours, firstWeek, weekCount, preferences]() {
+        return SchedulerLogic::recommendSlots(studentSchedule, officeHours, firstWeek, weekCount, preferences, 3);
+    });
+
+    // 同一时间只进行一次推荐
+    ui->recommendAction->setEnabled(false);
+    recommendTimer->start();
+}
+
+void MainWindow::onRecommendTimerTick() {
+    if (!recommendFuture.valid() ||
+        recommendFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+    recommendTimer->stop();
+    ui->recommendAction->setEnabled(true);
+    std::vector<SchedulerLogic::RankedSlot> ranked = recommendFuture.get();
+
+    if (ranked.empty()) {
+        QMessageBox::information(this, QString::fromUtf8("推荐时间"),
+                               QString::fromUtf8("%1 周内没有符合条件的时间段").arg(recommendWeekCount));
+        return;
+    }
+
+    QStringList lines;
+    for (std::size_t i = 0; i < ranked.size(); ++i) {
+        const auto& prof = recommendProfessors[ranked[i].source];
+        QDateTime start = QDateTime::fromSecsSinceEpoch(
+            std::chrono::system_clock::to_time_t(ranked[i].slot.getStartTime()));
+        QDateTime end = QDateTime::fromSecsSinceEpoch(
+            std::chrono::system_clock::to_time_t(ranked[i].slot.getEndTime()));
+        lines << QString::fromUtf8("%1. %2 - %3（%4分钟）  %5 <%6>")
+                     .arg(i + 1)
+                     .arg(start.toString("yyyy-MM-dd hh:mm"))
+                     .arg(end.toString("hh:mm"))
+                     .arg(ranked[i].slot.durationMinutes())
+                     .arg(QString::fromUtf8(prof.first.c_str()))
+                     .arg(QString::fromUtf8(prof.second.c_str()));
+    }
+    QMessageBox::information(this, QString::fromUtf8("推荐时间"), lines.join("\n"));
+}
+
+void MainWindow::onRoomSlotsTriggered() {
+    const auto& professors = dataManager.getProfessors();
+    if (professors.empty()) {
+        QMessageBox::information(this, QString::fromUtf8("提示"),
+                               QString::fromUtf8("请先导入教师办公时间"));
+        return;
+    }
+
+    QStringList profNames;
+    for (const auto& prof : professors) {
+        profNames << QString::fromUtf8(prof.getName().c_str());
+    }
+
+    bool ok;
+    QString selectedName = QInputDialog::getItem(this, QString::fromUtf8("会面房间"),
+                                                 QString::fromUtf8("请选择教师:"), profNames, 0, false, &ok);
+    if (!ok || selectedName.isEmpty()) {
+        return;
+    }
+    DataManager::ProfessorHandle handle = dataManager.findProfessorByName(selectedName.toStdString());
+    if (handle == DataManager::invalidProfessor) {
+        return;
+    }
+    const RoomCalendar& rooms = dataManager.getRoomCalendar();
+    if (rooms.size() == 0) {
+        QMessageBox::information(this, QString::fromUtf8("会面房间"),
+                               QString::fromUtf8("日程中还没有出现过任何地点"));
+        return;
+    }
+
+    // 当前显示的周内学生、教师和房间都空闲的时间段
+    // 办公时间本身就在教师的办公室，不算作该办公室被占用
+    // 日程中的地点没有容量信息，因此不按人数筛选
+    Schedule studentSchedule = dataManager.getUser().getCourses() +
+                              dataManager.getUser().getPersonalSchedule();
+    std::pair<std::uint64_t, std::uint64_t> ownOffice = dataManager.getProfessorRoomOwners(handle);
+    std::vector<SchedulerLogic::RoomSlot> slots = SchedulerLogic::findSlotsWithRooms(
+        studentSchedule, professors[handle].getOfficeHours(), ui->scheduleView->getCurrentWeekOffset(),
+        rooms, ownOffice.first, ownOffice.second);
+
+    if (slots.empty()) {
+        QMessageBox::information(this, QString::fromUtf8("会面房间"),
+                               QString::fromUtf8("本周没有三方都空闲的时间段"));
+        return;
+    }
+
+    const std::size_t maxLines = 20;
+    QStringList lines;
+    for (std::size_t i = 0; i < slots.size() && i < maxLines; ++i) {
+        const RoomCalendar::Room& room = rooms.getRoom(slots[i].room);
+        QDateTime start = QDateTime::fromSecsSinceEpoch(
+            std::chrono::system_clock::to_time_t(slots[i].slot.getStartTime()));
+        QDateTime end = QDateTime::fromSecsSinceEpoch(
+            std::chrono::system_clock::to_time_t(slots[i].slot.getEndTime()));
+        QString line = QString::fromUtf8("%1 - %2  %3")
+                           .arg(start.toString("MM-dd ddd hh:mm"))
+                           .arg(end.toString("hh:mm"))
+                           .arg(QString::fromUtf8(room.name.c_str()));
+        if (room.capacity > 0) {
+            line += QString::fromUtf8("（%1人）").arg(room.capacity);
+        }
+        lines << line;
+    }
+    if (slots.size() > maxLines) {
+        lines << QString::fromUtf8("……共 %1 个时间段").arg(slots.size());
+    }
+    QMessageBox::information(this, QString::fromUtf8("会面房间"), lines.join("\n"));
+}
+
+void MainWindow::onAvailabilityTimerTick() {
+    if (!availabilityTask) {
+        availabilityTimer->stop();
+        return;
+    }
+
+    if (availabilityProgress) {
+        availabilityProgress->setValue(availabilityTask->getProgressPercent());
+        availabilityProgress->setLabelText(QString::fromUtf8("正在计算可用时间... %1/%2")
+                                           .arg(availabilityTask->getCompletedCount())
+                                           .arg(availabilityTask->getTotalCount()));
+    }
+
+    if (availabilityTask->isFinished()) {
+        finishAvailability();
+    }
+}
+
+void MainWindow::finishAvailability() {
+    availabilityTimer->stop();
+    if (!availabilityTask) {
+        return;
+    }
+
+    bool cancelled = availabilityTask->isCancelled();
+    std::vector<AvailabilityResult> computed = availabilityTask->getFuture().get();
+    availabilityTask.reset();
+
+    if (availabilityProgress) {
+        availabilityProgress->deleteLater();
+        availabilityProgress = nullptr;
+    }
+
+    // 只缓存真正算完的结果；计算期间教师被重新导入时修订号已变，旧结果自然不会命中
+    for (auto& result : computed) {
+        if (!result.complete) {
+            continue;
+        }
+        std::time_t weekStart = std::chrono::system_clock::to_time_t(availabilityWeeks.timeAt(result.weekOffset, 0, 0));
+        availabilityCache.store(result.professor, weekStart, result.professorRevision,
+                                availabilityStudentHash, result.slots);
+        availabilityResults.push_back(std::move(result));
+    }
+
+    std::vector<AvailabilityResult> results = std::move(availabilityResults);
+    availabilityResults.clear();
+    if (cancelled) {
+        QMessageBox::information(this, QString::fromUtf8("提示"),
+                               QString::fromUtf8("计算已取消，仅显示已完成的部分"));
+    }
+    showAvailabilityResults(std::move(results));
+}
+
+void MainWindow::showAvailabilityResults(std::vector<AvailabilityResult> results) {
+    ResultDisplayWidget* resultWidget = new ResultDisplayWidget(this);
+    resultWidget->setResults(std::move(results));
+    resultWidget->exec();
+    delete resultWidget;
 }
 
 void MainWindow::on_loadDataBtn_clicked() {
     loadData();
-    updateScheduleView();
     QMessageBox::information(this, QString::fromUtf8("提示"),
                            QString::fromUtf8("数据已重新加载"));
 }
@@ -268,6 +1076,25 @@ void MainWindow::on_saveDataBtn_clicked() {
                            QString::fromUtf8("数据已保存"));
 }
 
+void MainWindow::onExportIcsTriggered() {
+    QString filePath = QFileDialog::getSaveFileName(this,
+                                                    QString::fromUtf8("导出日历"),
+                                                    "schedule.ics",
+                                                    QString::fromUtf8("日历文件 (*.ics)"));
+    if (filePath.isEmpty()) {
+        return;
+    }
+
+    Schedule combinedSchedule = dataManager.getUser().getCourses() +
+                               dataManager.getUser().getPersonalSchedule();
+    if (FileParser::writeIcs(combinedSchedule, filePath.toStdString())) {
+        ui->statusbar->showMessage(QString::fromUtf8("日历已导出到 %1").arg(filePath), 3000);
+    } else {
+        QMessageBox::warning(this, QString::fromUtf8("导出失败"),
+                           QString::fromUtf8("无法写入文件: %1").arg(filePath));
+    }
+}
+
 void MainWindow::on_exitAction_triggered() {
     close();
 }
@@ -278,7 +1105,8 @@ void MainWindow::on_showScheduleAction_triggered() {
 
 
 void MainWindow::onWeekChanged(int offset) {
-    updateScheduleView();
+    // 课表模型已按新周重新布局，事件没有变化，不必重建合并日程
+    Q_UNUSED(offset);
 }
 
 void MainWindow::onEventDoubleClicked(int eventId) {
@@ -316,19 +1144,29 @@ void MainWindow::showEventDetails(int eventId) {
         QString startStr = startDateTime.toString("yyyy-MM-dd hh:mm");
         QString endStr = endDateTime.toString("yyyy-MM-dd hh:mm");
         
+        QStringList tagNames;
+        for (int bit = 0; bit < EVENT_TAG_COUNT; ++bit) {
+            if (foundEvent->getTags() & (1u << bit)) {
+                tagNames << QString::fromUtf8(eventTagName(bit));
+            }
+        }
+        QString tagText = tagNames.join(QString::fromUtf8("、"));
+
         QString details = QString::fromUtf8(
             "事件: %1\n"
             "地点: %2\n"
             "开始时间: %3\n"
             "结束时间: %4\n"
             "类型: %5\n"
-            "备注: %6"
-        ).arg(QString::fromUtf8(foundEvent->getEventName().c_str()))
-         .arg(QString::fromUtf8(foundEvent->getLocation().c_str()))
-         .arg(startStr)
-         .arg(endStr)
-         .arg(foundEvent->getTimeSlot().getIsCourse() ? QString::fromUtf8("课程") : QString::fromUtf8("个人日程"))
-         .arg(QString::fromUtf8(foundEvent->getDescription().c_str()));
+            "标签: %6\n"
+            "备注: %7"
+        ).arg(QString::fromUtf8(foundEvent->getEventName().c_str()),
+              QString::fromUtf8(foundEvent->getLocation().c_str()),
+              startStr,
+              endStr,
+              foundEvent->getTimeSlot().getIsCourse() ? QString::fromUtf8("课程") : QString::fromUtf8("个人日程"),
+              tagText.isEmpty() ? QString::fromUtf8("无") : tagText,
+              QString::fromUtf8(foundEvent->getDescription().c_str()));
         
         QMessageBox::information(this, QString::fromUtf8("事件详情"), details);
     }
@@ -342,16 +1180,10 @@ void MainWindow::onDeleteEventRequested(int eventId) {
     
     if (ret != QMessageBox::Yes) return;
     
-    // 从课程中查找并删除
-    bool found = dataManager.getUser().getCourses().removeEvent(eventId);
-    
-    // 如果在课程中没找到，从个人日程中查找并删除
-    if (!found) {
-        found = dataManager.getUser().getPersonalSchedule().removeEvent(eventId);
-    }
+    // 从课程或个人日程中查找并删除
+    bool found = dataManager.removeUserEvent(eventId);
     
     if (found) {
-        updateScheduleView();
         saveData();
         QMessageBox::information(this, QString::fromUtf8("删除成功"), 
                                QString::fromUtf8("事件已删除"));
@@ -360,3 +1192,78 @@ void MainWindow::onDeleteEventRequested(int eventId) {
                            QString::fromUtf8("未找到指定事件"));
     }
 }
+
+void MainWindow::onEventDragStarted(int eventId) {
+    hasDragEvent = false;
+    if (eventId > 0) {
+        const ScheduleEvent* event = dataManager.findUserEvent(eventId);
+        if (event) {
+            dragEvent = *event;
+            hasDragEvent = true;
+        }
+    }
+}
+
+bool MainWindow::makeDragCandidate(int eventId, int day, int startMinute, int endMinute,
+                                   ScheduleEvent& candidate) const {
+    WeekLayoutBuilder builder;
+    int weekOffset = ui->scheduleView->getCurrentWeekOffset();
+
+    if (eventId == 0) {
+        // 框选新建：默认作为个人日程
+        auto start = builder.timeAt(weekOffset, day, startMinute);
+        auto end = start + std::chrono::minutes(endMinute - startMinute);
+        candidate = ScheduleEvent(0, "", "", "", day + 1, TimeSlot(start, end, false));
+        return true;
+    }
+
+    if (!hasDragEvent || dragEvent.getId() != eventId) {
+        return false;
+    }
+
+    // 按显示位置的变化平移原事件：课程保留原来的起始周，个人日程仍在本周
+    LaidOutEvent placed;
+    if (!builder.place(dragEvent, weekOffset, placed)) {
+        return false;
+    }
+    auto delta = std::chrono::minutes((day - placed.day) * 1440 + (startMinute - placed.startMinute));
+    TimeSlot slot = dragEvent.getTimeSlot();
+    candidate = dragEvent;
+    candidate.setWeekday(day + 1);
+    candidate.setTimeSlot(TimeSlot(slot.getStartTime() + delta, slot.getEndTime() + delta, slot.getIsCourse()));
+    return true;
+}
+
+void MainWindow::onEventDragProposed(int eventId, int day, int startMinute, int endMinute) {
+    ScheduleEvent candidate;
+    if (!makeDragCandidate(eventId, day, startMinute, endMinute, candidate)) {
+        return;
+    }
+    ui->scheduleView->setDragConflicts(dataManager.findConflicts(candidate));
+}
+
+void MainWindow::onEventDropped(int eventId, int day, int startMinute, int endMinute) {
+    ScheduleEvent candidate;
+    bool valid = makeDragCandidate(eventId, day, startMinute, endMinute, candidate);
+    hasDragEvent = false;
+    if (!valid) {
+        return;
+    }
+
+    if (eventId == 0) {
+        // 新建事件：带着框选的时间打开添加对话框
+        AddEventDialog dialog(this);
+        dialog.setEvent(candidate);
+        addEventFromDialog(dialog);
+        return;
+    }
+
+    // 与添加事件相同的冲突和重复检查，失败时事件保持原位
+    std::string errorMsg;
+    if (dataManager.updateUserEvent(candidate, errorMsg)) {
+        saveData();
+    } else {
+        QMessageBox::warning(this, QString::fromUtf8("移动失败"),
+                           QString::fromUtf8("无法移动事件: %1").arg(QString::fromStdString(errorMsg)));
+    }
+}
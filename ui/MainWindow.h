@@ -4,12 +4,25 @@
 #include <QMainWindow>
 #include <QListWidgetItem>
 #include <QDateTime>
+#include <QProgressDialog>
+#include <QTimer>
+#include <ctime>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
 #include "ScheduleView.h"
 #include "AddEventDialog.h"
 #include "ImportProfessorDialog.h"
 #include "ImportStudentCoursesDialog.h"
 #include "ResultDisplayWidget.h"
 #include "../modules/DataManager.h"
+#include "../modules/ImportPipeline.h"
+#include "../modules/AvailabilityCache.h"
+#include "../modules/AvailabilityTask.h"
+#include "../modules/SchedulerLogic.h"
+#include "../modules/ThreadPool.h"
+#include "../modules/WeekLayout.h"
 
 namespace Ui {
 class MainWindow;
@@ -28,15 +41,42 @@ private slots:
     void on_importProfessorBtn_clicked();
     void on_importStudentCoursesBtn_clicked();
     void on_calculateBtn_clicked();
+    void onRecommendTriggered();
+    void onRoomSlotsTriggered();
     void on_loadDataBtn_clicked();
     void on_saveDataBtn_clicked();
     void on_exitAction_triggered();
     void on_showScheduleAction_triggered();
+    void onExportIcsTriggered();
+    void onSwitchUserTriggered();
+    void onUndoTriggered();
+    void onRedoTriggered();
     
     // ScheduleView 相关槽函数（需要手动连接，因为是自定义信号）
     void onWeekChanged(int offset);
     void onEventDoubleClicked(int eventId);
     void onDeleteEventRequested(int eventId);
+    
+    // 分钟视图中拖动移动或新建事件
+    void onEventDragStarted(int eventId);
+    void onEventDragProposed(int eventId, int day, int startMinute, int endMinute);
+    void onEventDropped(int eventId, int day, int startMinute, int endMinute);
+
+    // 流式导入：定时从流水线取出批次并合并
+    void onImportTimerTick();
+
+    // 可用时间在线程池中计算，定时查询进度
+    void onAvailabilityTimerTick();
+
+    // 推荐时间在线程池中计算，定时查询是否完成
+    void onRecommendTimerTick();
+
+    // 搜索框：每次输入即时查询索引
+    void onSearchTextChanged(const QString& text);
+    void onSearchResultActivated(QListWidgetItem* item);
+
+    // 标签筛选：只在课表中显示符合条件的事件
+    void onTagFilterChanged();
 
 private:
     Ui::MainWindow *ui;
@@ -46,14 +86,74 @@ private:
     int nextEventId;
     
     // 数据文件路径
-    QString userDataPath;
+    QString userDataPath;               // 旧的单用户数据文件，仅用于迁移
+    QString userStorePath;              // 按学生分片的存储目录
     QString professorDataPath;
+
+    // 正在进行的导入
+    std::unique_ptr<ImportPipeline> importPipeline;
+    QProgressDialog* importProgress;
+    QTimer* importTimer;
+    int importSuccessCount;
+    int importSkipCount;
+    int importEventId;
+    int importChangedCount;
+
+    // 导入的教师先暂存并逐行累加办公时间哈希，结束时再合并，内容未变的教师不替换
+    std::vector<Professor> stagedProfessors;
+    std::vector<std::uint64_t> stagedOfficeHoursHashes;
+    std::unordered_map<std::string, std::size_t> stagedProfessorIndex;
+    std::size_t currentImportProfessor;
+
+    // 可用时间结果缓存
+    AvailabilityCache availabilityCache;
+
+    // 正在进行的可用时间计算；缓存命中的结果先放在 availabilityResults 中，结束时合并
+    ThreadPool computePool;
+    std::unique_ptr<AvailabilityTask> availabilityTask;
+    QProgressDialog* availabilityProgress;
+    QTimer* availabilityTimer;
+    std::vector<AvailabilityResult> availabilityResults;
+    std::uint64_t availabilityStudentHash;
+    WeekLayoutBuilder availabilityWeeks;        // 发起计算时的“本周”，把周偏移换算成缓存用的周一日期
+
+    // 正在进行的推荐计算；教师按发起时的姓名和邮箱显示，计算期间重新导入不影响结果
+    std::future<std::vector<SchedulerLogic::RankedSlot>> recommendFuture;
+    std::vector<std::pair<std::string, std::string>> recommendProfessors;
+    int recommendWeekCount;
+    QTimer* recommendTimer;
+
+    // 正在拖动的事件（拖动开始时取一次，拖动中不再查找）
+    ScheduleEvent dragEvent;
+    bool hasDragEvent;
     
     // 辅助函数
     void loadData();
     void saveData();
+    void refreshNextEventId();
+    void updateWindowTitle();
+    void showLoadMessage(const QString& message);
     void updateScheduleView();
+    void applyScheduleChanges(const ChangeSet& changes);
+    
+    // 当前的标签/时间筛选结果，不筛选时返回空指针
+    std::shared_ptr<const CompressedBitmap> currentFilter() const;
+    void updateUndoActions();
     void showEventDetails(int eventId);
+    void startImport(ImportPipeline::Kind kind, const QString& filePath);
+    void importStudentIcs(const QString& filePath);
+    void importProfessorIcs(const QString& filePath);
+    void getIcsImportWindow(std::time_t& windowStart, std::time_t& windowEnd) const;
+    void mergeImportBatch(ImportPipeline::Batch& batch);
+    void commitStagedProfessors();
+    void clearStagedProfessors();
+    void refreshSearchResults();
+    void finishImport();
+    void finishAvailability();
+    bool makeDragCandidate(int eventId, int day, int startMinute, int endMinute,
+                           ScheduleEvent& candidate) const;
+    void addEventFromDialog(AddEventDialog& dialog);
+    void showAvailabilityResults(std::vector<AvailabilityResult> results);
 };
 
 #endif // MAINWINDOW_H
@@ -2,9 +2,10 @@
 #define RESULTDISPLAYWIDGET_H
 
 #include <QDialog>
-#include "../datastructure/TimeSlot.h"
+#include <QModelIndex>
+#include "AvailabilityResultModel.h"
+#include "../modules/AvailabilityTask.h"
 #include <vector>
-#include <QTableWidgetItem>
 
 namespace Ui {
 class ResultDisplayWidget;
@@ -17,15 +18,19 @@ public:
     explicit ResultDisplayWidget(QWidget* parent = nullptr);
     ~ResultDisplayWidget();
 
-    void setResults(const QString& professorName,
-                   const QString& professorEmail,
-                   const std::vector<TimeSlot>& availableSlots);
+    // 显示一位或多位教师、一周或多周的计算结果
+    void setResults(std::vector<AvailabilityResult> results);
 
 private slots:
-    void onEmailItemDoubleClicked(QTableWidgetItem* item);
+    void onResultDoubleClicked(const QModelIndex& index);
+    void onMinDurationChanged(int minutes);
 
 private:
     Ui::ResultDisplayWidget *ui;
+    AvailabilityResultModel* model;
+    AvailabilityFilterProxy* proxy;
+
+    void updateTitle();
 };
 
 #endif // RESULTDISPLAYWIDGET_H
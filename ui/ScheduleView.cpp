@@ -10,7 +10,7 @@
 #include <sstream>
 
 ScheduleView::ScheduleView(QWidget* parent)
-    : QWidget(parent), currentWeekOffset(0) {
+    : QWidget(parent), currentWeekOffset(0), layoutCache(new WeekLayoutCache(4)) {
     setupUI();
 }
 
@@ -26,32 +26,17 @@ void ScheduleView::setupUI() {
     nextWeekButton = new QPushButton(QString::fromUtf8("下一周"), this);
     weekLabel = new QLabel(QString::fromUtf8("当前周"), this);
     weekLabel->setAlignment(Qt::AlignCenter);
+    canvasModeButton = new QPushButton(QString::fromUtf8("分钟视图"), this);
+    canvasModeButton->setCheckable(true);
 
     controlLayout->addWidget(prevWeekButton);
     controlLayout->addWidget(weekLabel, 1);
     controlLayout->addWidget(nextWeekButton);
+    controlLayout->addWidget(canvasModeButton);
 
-    // 创建表格视图
+    // 创建表格视图，模型直接由事件布局提供数据
     tableView = new QTableView(this);
-    model = new QStandardItemModel(24, 8, this);  // 24小时 x 8列（时间+7天）
-
-    // 设置表头
-    QStringList headers;
-    headers << QString::fromUtf8("时间");
-    
-    // 添加带日期的星期列头
-    QStringList weekHeaders = getWeekHeaders();
-    for (int i = 0; i < 7; ++i) {
-        headers << weekHeaders[i];
-    }
-    
-    model->setHorizontalHeaderLabels(headers);
-
-    // 填充时间列
-    for (int i = 0; i < 24; ++i) {
-        QString timeStr = QString("%1:00").arg(i, 2, 10, QChar('0'));
-        model->setItem(i, 0, new QStandardItem(timeStr));
-    }
+    model = new WeekScheduleModel(this);  // 24小时 x 8列（时间+7天）
 
     tableView->setModel(model);
     tableView->horizontalHeader()->setStretchLastSection(false);
@@ -60,9 +45,25 @@ void ScheduleView::setupUI() {
     tableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
     tableView->setContextMenuPolicy(Qt::CustomContextMenu);
 
+    // 分钟精度的自绘视图，与表格视图二选一显示
+    canvas = new WeekCanvas(this);
+    viewStack = new QStackedWidget(this);
+    viewStack->addWidget(tableView);
+    viewStack->addWidget(canvas);
+
+    // 学期总览：过去半年到未来一年半，约 20 周可见，滚动查看其余
+    overview = new SemesterOverview(this);
+    overview->setWeekRange(-26, 104);
+    overview->setFixedWidth(overview->sizeHint().width());
+    overview->setCurrentWeek(currentWeekOffset);
+
+    QHBoxLayout* viewLayout = new QHBoxLayout();
+    viewLayout->addWidget(viewStack, 1);
+    viewLayout->addWidget(overview);
+
     // 布局
     mainLayout->addLayout(controlLayout);
-    mainLayout->addWidget(tableView);
+    mainLayout->addLayout(viewLayout);
 
     setLayout(mainLayout);
 
@@ -71,6 +72,14 @@ void ScheduleView::setupUI() {
     connect(nextWeekButton, &QPushButton::clicked, this, &ScheduleView::onNextWeekClicked);
     connect(tableView, &QTableView::doubleClicked, this, &ScheduleView::onCellDoubleClicked);
     connect(tableView, &QTableView::customContextMenuRequested, this, &ScheduleView::onContextMenuRequested);
+    connect(model, &WeekScheduleModel::rowSpanChanged, this, &ScheduleView::onRowSpanChanged);
+    connect(canvasModeButton, &QPushButton::toggled, this, &ScheduleView::onCanvasModeToggled);
+    connect(overview, &SemesterOverview::weekActivated, this, &ScheduleView::setWeekOffset);
+    connect(canvas, &WeekCanvas::eventDoubleClicked, this, &ScheduleView::eventDoubleClicked);
+    connect(canvas, &WeekCanvas::deleteEventRequested, this, &ScheduleView::deleteEventRequested);
+    connect(canvas, &WeekCanvas::dragStarted, this, &ScheduleView::eventDragStarted);
+    connect(canvas, &WeekCanvas::dragProposed, this, &ScheduleView::eventDragProposed);
+    connect(canvas, &WeekCanvas::eventDropped, this, &ScheduleView::eventDropped);
 
     updateWeekLabel();
 }
@@ -89,92 +98,95 @@ void ScheduleView::setWeekOffset(int offset) {
     currentWeekOffset = offset;
     updateWeekLabel();
     
-    // 更新表头日期
-    QStringList headers;
-    headers << QString::fromUtf8("时间");
-    
-    // 添加带日期的星期列头
-    QStringList weekHeaders = getWeekHeaders();
-    for (int i = 0; i < 7; ++i) {
-        headers << weekHeaders[i];
-    }
-    
-    model->setHorizontalHeaderLabels(headers);
+    // 优先使用后台预取好的布局，没有命中时模型自行重新布局
+    std::shared_ptr<const WeekLayout> prepared = layoutCache->find(offset);
+    model->setWeekOffset(offset, prepared.get());
+    layoutCache->prefetch(offset);
+    refreshCanvas();
+    overview->setCurrentWeek(offset);
     
     emit weekChanged(offset);
 }
 
 void ScheduleView::setSchedule(const std::vector<ScheduleEvent>& events) {
-    currentEvents = events;
-    
-    // 清空表格（除了时间列）
-    for (int row = 0; row < 24; ++row) {
-        for (int col = 1; col <= 7; ++col) {
-            model->setItem(row, col, new QStandardItem(""));
-        }
+    // 只有与当前显示内容不同的单元格会被重绘
+    model->setEvents(events);
+}
+
+void ScheduleView::updateEvents(const std::vector<ScheduleEvent>& upserts, const std::vector<int>& removedIds) {
+    model->updateEvents(upserts, removedIds);
+}
+
+void ScheduleView::setLayoutSource(std::shared_ptr<const User> user,
+                                   std::shared_ptr<const CompressedBitmap> visible) {
+    layoutUser = user;
+    layoutVisible = visible;
+    layoutCache->setSource(std::move(user), std::move(visible));
+    layoutCache->prefetch(currentWeekOffset);
+    refreshCanvas();
+    refreshOverview();
+}
+
+void ScheduleView::applyChanges(std::shared_ptr<const User> user,
+                                std::shared_ptr<const CompressedBitmap> visible,
+                                const ChangeSet& changes) {
+    layoutUser = user;
+    layoutVisible = visible;
+    layoutCache->applyChanges(std::move(user), std::move(visible), changes);
+    layoutCache->prefetch(currentWeekOffset);
+    refreshCanvas();
+
+    busySummary.apply(changes, layoutVisible.get());
+    overview->setBusyMinutes(busySummary.getMinutes());
+}
+
+void ScheduleView::refreshOverview() {
+    if (!layoutUser) {
+        return;
     }
-    
-    // 重置所有合并的单元格
-    tableView->clearSpans();
-
-    // 填充事件
-    for (const auto& event : events) {
-        // 使用辅助函数进行周过滤
-        // 如果是课程，则在所有周都显示；否则只在特定周显示
-        // 修复：事件的周偏移是相对于系统当前周的，需要与当前显示周进行比较
-        if (!event.getTimeSlot().getIsCourse() && event.getWeekOffset() != currentWeekOffset) {
-            continue;
-        }
-        
-        int weekday = event.getWeekday();
-        if (weekday < 1 || weekday > 7) continue;
-
-        auto startTime = std::chrono::system_clock::to_time_t(event.getTimeSlot().getStartTime());
-        
-        std::tm* start_tm = std::localtime(&startTime);
-        int startHour = start_tm->tm_hour;
-        
-        // 计算持续时间（小时）- 使用chrono直接计算
-        auto duration = std::chrono::duration_cast<std::chrono::hours>(event.getTimeSlot().getEndTime() - event.getTimeSlot().getStartTime());
-        int durationHours = duration.count();
-        
-        // 确保至少显示1小时
-        if (durationHours == 0) {
-            durationHours = 1;
-        }
-        
-        
-        if (startHour < 0 || startHour >= 24) continue;
-
-        QString displayText = QString::fromUtf8(event.getEventName().c_str());
-        if (!event.getLocation().empty()) {
-            displayText += "\n@" + QString::fromUtf8(event.getLocation().c_str());
-        }
-
-        // 只在开始时间的位置创建事件项
-        QStandardItem* item = new QStandardItem(displayText);
-        item->setData(event.getId(), Qt::UserRole);
-        
-        // 根据是否为课程设置不同颜色
-        if (event.getTimeSlot().getIsCourse()) {
-            item->setBackground(QColor(173, 216, 230));  // 浅蓝色
-        } else {
-            item->setBackground(QColor(255, 255, 224));  // 浅黄色
-        }
-
-        model->setItem(startHour, weekday, item);
-        
-        // 合并单元格：使用精确计算的持续时间
-        if (durationHours > 1) {
-            tableView->setSpan(startHour, weekday, durationHours, 1);
-        }
+    // 只汇总成每天一个数，总览绘制时不再接触事件
+    busySummary.reset(*layoutUser, layoutVisible.get(), overview->getFirstWeek(), overview->getWeekCount());
+    overview->setBusyMinutes(busySummary.getMinutes());
+}
+
+void ScheduleView::refreshCanvas() {
+    if (viewStack->currentWidget() != canvas) {
+        return;
+    }
+
+    QStringList headers;
+    for (int column = 1; column <= WeekScheduleModel::DAYS; ++column) {
+        headers << model->headerData(column, Qt::Horizontal).toString();
+    }
+    canvas->setDayHeaders(headers);
+
+    // 优先用预取好的布局，未命中时在界面线程中计算当前周
+    std::shared_ptr<const WeekLayout> layout = layoutCache->find(currentWeekOffset);
+    if (!layout && layoutUser) {
+        layout = std::make_shared<const WeekLayout>(
+            WeekLayoutCache::build(*layoutUser, layoutVisible.get(), currentWeekOffset));
     }
+    canvas->setWeekLayout(layout);
+}
+
+void ScheduleView::onCanvasModeToggled(bool enabled) {
+    viewStack->setCurrentWidget(enabled ? static_cast<QWidget*>(canvas) : static_cast<QWidget*>(tableView));
+    refreshCanvas();
+}
+
+void ScheduleView::onRowSpanChanged(int row, int column, int rowSpan) {
+    // 1x1 的合并等于取消合并
+    tableView->setSpan(row, column, rowSpan, 1);
 }
 
 int ScheduleView::getCurrentWeekOffset() const {
     return currentWeekOffset;
 }
 
+void ScheduleView::setDragConflicts(std::vector<int> conflictIds) {
+    canvas->setConflictIds(std::move(conflictIds));
+}
+
 void ScheduleView::onPrevWeekClicked() {
     setWeekOffset(currentWeekOffset - 1);
 }
@@ -186,53 +198,17 @@ void ScheduleView::onNextWeekClicked() {
 void ScheduleView::onCellDoubleClicked(const QModelIndex& index) {
     if (!index.isValid() || index.column() == 0) return;
 
-    QStandardItem* item = model->itemFromIndex(index);
-    if (item && item->text().isEmpty()) return;
-
-    int eventId = item->data(Qt::UserRole).toInt();
+    int eventId = model->eventIdAt(index);
     if (eventId > 0) {
         emit eventDoubleClicked(eventId);
     }
 }
 
-QStringList ScheduleView::getWeekHeaders() {
-    QStringList headers;
-    QStringList weekNames = {QString::fromUtf8("周一"), QString::fromUtf8("周二"), 
-                            QString::fromUtf8("周三"), QString::fromUtf8("周四"), 
-                            QString::fromUtf8("周五"), QString::fromUtf8("周六"), 
-                            QString::fromUtf8("周日")};
-    
-    // 获取当前日期
-    QDate today = QDate::currentDate();
-    
-    // 计算当前周的开始日期（周一）
-    int daysToMonday = today.dayOfWeek() - 1;  // Qt中周一=1，所以减1
-    QDate weekStart = today.addDays(-daysToMonday);
-    
-    // 根据周偏移量调整
-    QDate targetWeekStart = weekStart.addDays(currentWeekOffset * 7);
-    
-    // 生成一周的日期
-    for (int i = 0; i < 7; ++i) {
-        QDate currentDate = targetWeekStart.addDays(i);
-        QString header = QString("%1\n(%2/%3)")
-                        .arg(weekNames[i])
-                        .arg(currentDate.month())
-                        .arg(currentDate.day());
-        headers << header;
-    }
-    
-    return headers;
-}
-
 void ScheduleView::onContextMenuRequested(const QPoint& pos) {
     QModelIndex index = tableView->indexAt(pos);
     if (!index.isValid() || index.column() == 0) return;
 
-    QStandardItem* item = model->itemFromIndex(index);
-    if (!item || item->text().isEmpty()) return;
-
-    int eventId = item->data(Qt::UserRole).toInt();
+    int eventId = model->eventIdAt(index);
     if (eventId <= 0) return;
 
     QMenu contextMenu(this);
@@ -3,12 +3,19 @@
 
 #include <QWidget>
 #include <QTableView>
-#include <QStandardItemModel>
+#include <QStackedWidget>
 #include <QPushButton>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
+#include "WeekScheduleModel.h"
+#include "WeekCanvas.h"
+#include "SemesterOverview.h"
 #include "../datastructure/ScheduleEvent.h"
+#include "../modules/WeekLayoutCache.h"
+#include "../modules/BusySummary.h"
+#include "../modules/ScheduleChange.h"
+#include <memory>
 #include <vector>
 
 class ScheduleView : public QWidget {
@@ -16,17 +23,24 @@ class ScheduleView : public QWidget {
 
 private:
     QTableView* tableView;
-    QStandardItemModel* model;
+    WeekScheduleModel* model;
     QPushButton* prevWeekButton;
     QPushButton* nextWeekButton;
     QLabel* weekLabel;
+    QPushButton* canvasModeButton;
+    QStackedWidget* viewStack;          // 表格视图 / 分钟精度视图
+    WeekCanvas* canvas;
+    SemesterOverview* overview;         // 学期总览，点击某周跳转
     int currentWeekOffset;
-    
-    std::vector<ScheduleEvent> currentEvents;
+    std::unique_ptr<WeekLayoutCache> layoutCache;   // 后台预取相邻周的布局
+    std::shared_ptr<const User> layoutUser;         // 最近一次提供的数据源，分钟视图未命中缓存时使用
+    std::shared_ptr<const CompressedBitmap> layoutVisible;
+    BusySummary busySummary;                        // 总览的每日忙碌分钟数，随变化增量更新
 
     void setupUI();
     void updateWeekLabel();
-    QStringList getWeekHeaders();
+    void refreshCanvas();
+    void refreshOverview();
 
 public:
     explicit ScheduleView(QWidget* parent = nullptr);
@@ -35,18 +49,39 @@ public:
     void setWeekOffset(int offset);
     void setSchedule(const std::vector<ScheduleEvent>& events);
     
+    // 增量更新：只重绘涉及的星期列中变化的单元格
+    void updateEvents(const std::vector<ScheduleEvent>& upserts, const std::vector<int>& removedIds);
+    
+    // 日程或筛选条件变化后提供新的快照，供后台预取相邻周的布局
+    // visible 为空时显示全部事件，应与 setSchedule/updateEvents 提供的事件一致
+    void setLayoutSource(std::shared_ptr<const User> user, std::shared_ptr<const CompressedBitmap> visible);
+
+    // 日程的增量变化：只修补变化涉及的周布局，总览只重算变化涉及的天
+    void applyChanges(std::shared_ptr<const User> user, std::shared_ptr<const CompressedBitmap> visible,
+                      const ChangeSet& changes);
+    
     int getCurrentWeekOffset() const;
+    
+    // 拖动中建议位置的冲突事件（升序），在分钟视图中高亮
+    void setDragConflicts(std::vector<int> conflictIds);
 
 signals:
     void weekChanged(int newOffset);
     void eventDoubleClicked(int eventId);
     void deleteEventRequested(int eventId);
+    
+    // 分钟视图中的拖动（见 WeekCanvas），位置为当前显示周中的星期和分钟
+    void eventDragStarted(int eventId);
+    void eventDragProposed(int eventId, int day, int startMinute, int endMinute);
+    void eventDropped(int eventId, int day, int startMinute, int endMinute);
 
 private slots:
     void onPrevWeekClicked();
     void onNextWeekClicked();
     void onCellDoubleClicked(const QModelIndex& index);
     void onContextMenuRequested(const QPoint& pos);
+    void onRowSpanChanged(int row, int column, int rowSpan);
+    void onCanvasModeToggled(bool enabled);
 };
 
 #endif // SCHEDULEVIEW_H
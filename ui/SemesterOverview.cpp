@@ -0,0 +1,110 @@
+#include "SemesterOverview.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QMouseEvent>
+#include <QScrollBar>
+#include <algorithm>
+#include <utility>
+
+SemesterOverview::SemesterOverview(QWidget* parent)
+    : QAbstractScrollArea(parent), firstWeek(0), weekCount(0), currentWeek(0) {
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    verticalScrollBar()->setSingleStep(ROW_HEIGHT);
+    setWeekRange(0, 20);
+}
+
+void SemesterOverview::setWeekRange(int first, int count) {
+    firstWeek = first;
+    weekCount = std::max(count, 0);
+    QDate today = QDate::currentDate();
+    firstMonday = today.addDays(1 - today.dayOfWeek()).addDays(firstWeek * 7);
+    busyMinutes.assign(static_cast<std::size_t>(weekCount) * 7, 0);
+    updateScrollBar();
+    viewport()->update();
+}
+
+int SemesterOverview::getFirstWeek() const {
+    return firstWeek;
+}
+
+int SemesterOverview::getWeekCount() const {
+    return weekCount;
+}
+
+void SemesterOverview::setBusyMinutes(std::vector<int> minutes) {
+    busyMinutes = std::move(minutes);
+    busyMinutes.resize(static_cast<std::size_t>(weekCount) * 7, 0);
+    viewport()->update();
+}
+
+void SemesterOverview::setCurrentWeek(int weekOffset) {
+    currentWeek = weekOffset;
+    int row = weekOffset - firstWeek;
+    if (row >= 0 && row < weekCount) {
+        int top = row * ROW_HEIGHT;
+        QScrollBar* bar = verticalScrollBar();
+        if (top < bar->value()) {
+            bar->setValue(top);
+        } else if (top + ROW_HEIGHT > bar->value() + viewport()->height()) {
+            bar->setValue(top + ROW_HEIGHT - viewport()->height());
+        }
+    }
+    viewport()->update();
+}
+
+QSize SemesterOverview::sizeHint() const {
+    return QSize(LABEL_WIDTH + 7 * CELL_WIDTH + verticalScrollBar()->sizeHint().width() + 4,
+                 20 * ROW_HEIGHT);
+}
+
+void SemesterOverview::updateScrollBar() {
+    QScrollBar* bar = verticalScrollBar();
+    bar->setPageStep(viewport()->height());
+    bar->setRange(0, std::max(0, weekCount * ROW_HEIGHT - viewport()->height()));
+}
+
+void SemesterOverview::resizeEvent(QResizeEvent* event) {
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBar();
+}
+
+void SemesterOverview::paintEvent(QPaintEvent* event) {
+    QPainter painter(viewport());
+    painter.fillRect(event->rect(), palette().base());
+
+    // 只处理可见的周
+    int scroll = verticalScrollBar()->value();
+    int firstRow = std::max(0, (scroll + event->rect().top()) / ROW_HEIGHT);
+    int lastRow = std::min(weekCount - 1, (scroll + event->rect().bottom()) / ROW_HEIGHT);
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        int y = row * ROW_HEIGHT - scroll;
+        QDate monday = firstMonday.addDays(row * 7);
+
+        if (firstWeek + row == currentWeek) {
+            painter.fillRect(QRect(0, y, viewport()->width(), ROW_HEIGHT), palette().highlight());
+            painter.setPen(palette().highlightedText().color());
+        } else {
+            painter.setPen(palette().text().color());
+        }
+        painter.drawText(QRect(2, y, LABEL_WIDTH - 4, ROW_HEIGHT), Qt::AlignLeft | Qt::AlignVCenter,
+                         QString("%1/%2").arg(monday.month()).arg(monday.day()));
+
+        // 按忙碌程度着色，10 小时以上为最深
+        for (int day = 0; day < 7; ++day) {
+            int minutes = busyMinutes[static_cast<std::size_t>(row) * 7 + day];
+            double ratio = std::min(1.0, minutes / 600.0);
+            QColor fill = minutes == 0 ? QColor(245, 245, 245)
+                                       : QColor::fromRgbF(1.0 - 0.7 * ratio, 1.0 - 0.45 * ratio, 1.0 - 0.2 * ratio);
+            QRect cell(LABEL_WIDTH + day * CELL_WIDTH + 1, y + 2, CELL_WIDTH - 2, ROW_HEIGHT - 4);
+            painter.fillRect(cell, fill);
+        }
+    }
+}
+
+void SemesterOverview::mousePressEvent(QMouseEvent* event) {
+    int row = (event->pos().y() + verticalScrollBar()->value()) / ROW_HEIGHT;
+    if (row >= 0 && row < weekCount) {
+        emit weekActivated(firstWeek + row);
+    }
+}
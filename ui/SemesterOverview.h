@@ -0,0 +1,51 @@
+#ifndef SEMESTEROVERVIEW_H
+#define SEMESTEROVERVIEW_H
+
+#include <QAbstractScrollArea>
+#include <QDate>
+#include <vector>
+
+// 学期总览：每周一行，七个小格按当天忙碌分钟数着色
+// 只绘制滚动区域内可见的几行，数据来自预先汇总的每日忙碌分钟数（见 BusySummary）
+class SemesterOverview : public QAbstractScrollArea {
+    Q_OBJECT
+
+public:
+    explicit SemesterOverview(QWidget* parent = nullptr);
+
+    // 显示的周范围（周偏移相对于本周）
+    void setWeekRange(int firstWeek, int weekCount);
+    int getFirstWeek() const;
+    int getWeekCount() const;
+
+    // weekCount * 7 个值，按周、按星期排列
+    void setBusyMinutes(std::vector<int> minutes);
+
+    // 高亮正在单周视图中显示的周，并确保它可见
+    void setCurrentWeek(int weekOffset);
+
+    QSize sizeHint() const override;
+
+signals:
+    void weekActivated(int weekOffset);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+
+private:
+    static const int ROW_HEIGHT = 18;
+    static const int LABEL_WIDTH = 52;
+    static const int CELL_WIDTH = 20;
+
+    int firstWeek;
+    int weekCount;
+    int currentWeek;
+    QDate firstMonday;          // firstWeek 周的周一
+    std::vector<int> busyMinutes;
+
+    void updateScrollBar();
+};
+
+#endif // SEMESTEROVERVIEW_H
@@ -0,0 +1,349 @@
+#include "WeekCanvas.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QMouseEvent>
+#include <QContextMenuEvent>
+#include <QKeyEvent>
+#include <QApplication>
+#include <QMenu>
+#include <QAction>
+#include <algorithm>
+
+WeekCanvas::WeekCanvas(QWidget* parent)
+    : QWidget(parent), geometryDirty(true),
+      dragMode(DragMode::None), dragEventId(0),
+      originDay(0), originStart(0), originEnd(0),
+      proposedDay(0), proposedStart(0), proposedEnd(0) {
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setFocusPolicy(Qt::ClickFocus);     // 拖动中按 Esc 取消
+    setMinimumHeight(HEADER_HEIGHT + 24 * 24);
+}
+
+void WeekCanvas::setWeekLayout(std::shared_ptr<const WeekLayout> newLayout) {
+    layout = std::move(newLayout);
+    geometryDirty = true;
+    update();
+}
+
+void WeekCanvas::setDayHeaders(const QStringList& headers) {
+    dayHeaders = headers;
+    update(QRect(0, 0, width(), HEADER_HEIGHT));
+}
+
+void WeekCanvas::setConflictIds(std::vector<int> ids) {
+    if (ids == conflictIds) {
+        return;
+    }
+    conflictIds = std::move(ids);
+    update();
+}
+
+QSize WeekCanvas::sizeHint() const {
+    return QSize(TIME_GUTTER + 7 * 120, HEADER_HEIGHT + 24 * 40);
+}
+
+double WeekCanvas::dayWidth() const {
+    return std::max(1.0, (width() - TIME_GUTTER) / 7.0);
+}
+
+double WeekCanvas::minuteHeight() const {
+    return std::max(0.1, (height() - HEADER_HEIGHT) / 1440.0);
+}
+
+void WeekCanvas::resizeEvent(QResizeEvent* event) {
+    QWidget::resizeEvent(event);
+    geometryDirty = true;
+}
+
+void WeekCanvas::rebuildGeometry() {
+    blocks.clear();
+    geometryDirty = false;
+    if (!layout) {
+        return;
+    }
+
+    double dayW = dayWidth();
+    double minuteH = minuteHeight();
+    QTextOption option;
+    option.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
+
+    for (const auto& day : layout->days) {
+        for (const auto& placed : day) {
+            int start = std::max(0, std::min(placed.startMinute, 1440));
+            int end = std::max(start + 1, std::min(placed.endMinute, 1440));
+            double columnW = dayW / std::max(1, placed.columnCount);
+
+            Block block;
+            block.rect = QRectF(TIME_GUTTER + placed.day * dayW + placed.column * columnW + 1,
+                                HEADER_HEIGHT + start * minuteH,
+                                columnW - 2,
+                                std::max(2.0, (end - start) * minuteH - 1));
+            block.eventId = placed.eventId;
+            block.course = placed.course;
+            block.day = placed.day;
+            block.startMinute = placed.startMinute;
+            block.endMinute = placed.endMinute;
+            block.text.setText(QString::fromUtf8(placed.title.c_str()));
+            block.text.setTextFormat(Qt::PlainText);
+            block.text.setTextOption(option);
+            block.text.setTextWidth(std::max(1.0, block.rect.width() - 4));
+            blocks.push_back(std::move(block));
+        }
+    }
+}
+
+void WeekCanvas::paintEvent(QPaintEvent* event) {
+    if (geometryDirty) {
+        rebuildGeometry();
+    }
+
+    QPainter painter(this);
+    const QRect dirty = event->rect();
+    painter.fillRect(dirty, palette().base());
+
+    double dayW = dayWidth();
+    double minuteH = minuteHeight();
+
+    // 整点横线和时间刻度
+    painter.setPen(palette().mid().color());
+    for (int hour = 0; hour <= 24; ++hour) {
+        int y = HEADER_HEIGHT + static_cast<int>(hour * 60 * minuteH);
+        if (y < dirty.top() - 1 || y > dirty.bottom() + 1) {
+            continue;
+        }
+        painter.drawLine(TIME_GUTTER, y, width(), y);
+        if (hour < 24) {
+            painter.drawText(QRect(0, y, TIME_GUTTER - 4, 16), Qt::AlignRight | Qt::AlignTop,
+                             QString("%1:00").arg(hour, 2, 10, QChar('0')));
+        }
+    }
+    for (int day = 0; day <= 7; ++day) {
+        int x = TIME_GUTTER + static_cast<int>(day * dayW);
+        painter.drawLine(x, 0, x, height());
+    }
+
+    // 列头
+    if (dirty.top() < HEADER_HEIGHT) {
+        painter.fillRect(QRect(0, 0, width(), HEADER_HEIGHT), palette().button());
+        painter.setPen(palette().buttonText().color());
+        for (int day = 0; day < 7 && day < dayHeaders.size(); ++day) {
+            QRectF cell(TIME_GUTTER + day * dayW, 0, dayW, HEADER_HEIGHT);
+            painter.drawText(cell, Qt::AlignCenter, dayHeaders[day]);
+        }
+    }
+
+    // 只绘制与重绘区域相交的事件块
+    painter.setClipRect(QRect(TIME_GUTTER, HEADER_HEIGHT, width() - TIME_GUTTER, height() - HEADER_HEIGHT)
+                        .intersected(dirty));
+    for (const auto& block : blocks) {
+        if (!block.rect.intersects(dirty)) {
+            continue;
+        }
+        // 根据是否为课程设置不同颜色；正在移动的事件淡化显示，冲突的事件加红框
+        QColor fill = block.course ? QColor(173, 216, 230) : QColor(255, 255, 224);
+        if (dragMode == DragMode::Moving && block.eventId == dragEventId) {
+            fill.setAlpha(90);
+        }
+        bool conflicting = std::binary_search(conflictIds.begin(), conflictIds.end(), block.eventId);
+        painter.setPen(conflicting ? QPen(Qt::red, 2) : QPen(fill.darker(140)));
+        painter.setBrush(fill);
+        painter.drawRect(block.rect);
+
+        painter.setPen(Qt::black);
+        painter.save();
+        painter.setClipRect(block.rect, Qt::IntersectClip);
+        painter.drawStaticText(block.rect.topLeft() + QPointF(2, 1), block.text);
+        painter.restore();
+    }
+
+    // 拖动中的建议位置：有冲突时为红色，否则为绿色
+    if (dragMode == DragMode::Moving || dragMode == DragMode::Creating) {
+        QColor color = conflictIds.empty() ? QColor(0, 150, 0) : QColor(Qt::red);
+        QColor fill = color;
+        fill.setAlpha(60);
+        painter.setPen(QPen(color, 2, Qt::DashLine));
+        painter.setBrush(fill);
+        painter.drawRect(proposalRect());
+    }
+}
+
+const WeekCanvas::Block* WeekCanvas::blockAt(const QPoint& pos) {
+    if (geometryDirty) {
+        rebuildGeometry();
+    }
+    // 后绘制的在上层，倒序查找
+    for (auto it = blocks.rbegin(); it != blocks.rend(); ++it) {
+        if (it->rect.contains(pos)) {
+            return &*it;
+        }
+    }
+    return nullptr;
+}
+
+int WeekCanvas::eventIdAt(const QPoint& pos) {
+    const Block* block = blockAt(pos);
+    return block ? block->eventId : 0;
+}
+
+int WeekCanvas::dayAt(int x) const {
+    int day = static_cast<int>((x - TIME_GUTTER) / dayWidth());
+    return std::max(0, std::min(day, 6));
+}
+
+int WeekCanvas::snappedMinuteAt(int y) const {
+    double minute = (y - HEADER_HEIGHT) / minuteHeight();
+    int snapped = static_cast<int>(minute / SNAP_MINUTES + 0.5) * SNAP_MINUTES;
+    return std::max(0, std::min(snapped, 1440));
+}
+
+QRectF WeekCanvas::proposalRect() const {
+    double dayW = dayWidth();
+    double minuteH = minuteHeight();
+    int end = std::min(proposedEnd, 1440);
+    return QRectF(TIME_GUTTER + proposedDay * dayW + 1,
+                  HEADER_HEIGHT + proposedStart * minuteH,
+                  dayW - 2,
+                  std::max(2.0, (end - proposedStart) * minuteH - 1));
+}
+
+void WeekCanvas::mouseDoubleClickEvent(QMouseEvent* event) {
+    int eventId = eventIdAt(event->pos());
+    if (eventId > 0) {
+        emit eventDoubleClicked(eventId);
+    }
+}
+
+void WeekCanvas::mousePressEvent(QMouseEvent* event) {
+    if (event->button() != Qt::LeftButton || event->pos().x() < TIME_GUTTER ||
+        event->pos().y() < HEADER_HEIGHT) {
+        QWidget::mousePressEvent(event);
+        return;
+    }
+
+    pressPos = event->pos();
+    dragMode = DragMode::Pending;
+    const Block* block = blockAt(pressPos);
+    if (block) {
+        dragEventId = block->eventId;
+        originDay = block->day;
+        originStart = block->startMinute;
+        originEnd = block->endMinute;
+    } else {
+        dragEventId = 0;
+        originDay = dayAt(pressPos.x());
+        originStart = snappedMinuteAt(pressPos.y());
+        originEnd = originStart;
+    }
+}
+
+void WeekCanvas::mouseMoveEvent(QMouseEvent* event) {
+    if (dragMode == DragMode::None || !(event->buttons() & Qt::LeftButton)) {
+        QWidget::mouseMoveEvent(event);
+        return;
+    }
+
+    if (dragMode == DragMode::Pending) {
+        // 未超过拖动阈值时仍按单击/双击处理
+        if ((event->pos() - pressPos).manhattanLength() < QApplication::startDragDistance()) {
+            return;
+        }
+        dragMode = dragEventId > 0 ? DragMode::Moving : DragMode::Creating;
+        proposedDay = -1;       // 保证第一次一定发出建议位置
+        conflictIds.clear();
+        if (dragMode == DragMode::Moving) {
+            setCursor(Qt::ClosedHandCursor);
+        }
+        emit dragStarted(dragEventId);
+    }
+    updateProposal(event->pos());
+}
+
+void WeekCanvas::updateProposal(const QPoint& pos) {
+    int day;
+    int start;
+    int end;
+    if (dragMode == DragMode::Moving) {
+        // 保持时长，按拖动距离平移并按网格取整，不超出当天
+        int duration = originEnd - originStart;
+        int delta = static_cast<int>((pos.y() - pressPos.y()) / minuteHeight() / SNAP_MINUTES +
+                                     ((pos.y() >= pressPos.y()) ? 0.5 : -0.5)) * SNAP_MINUTES;
+        day = std::max(0, std::min(originDay + dayAt(pos.x()) - dayAt(pressPos.x()), 6));
+        start = std::max(0, std::min(originStart + delta, 1440 - std::min(duration, 1440)));
+        end = start + duration;
+    } else {
+        // 新事件限制在按下的那一天，至少一个网格
+        int current = snappedMinuteAt(pos.y());
+        day = originDay;
+        start = std::min(originStart, current);
+        end = std::max(originStart, current);
+        if (end - start < SNAP_MINUTES) {
+            if (start + SNAP_MINUTES <= 1440) {
+                end = start + SNAP_MINUTES;
+            } else {
+                start = end - SNAP_MINUTES;
+            }
+        }
+    }
+
+    if (day == proposedDay && start == proposedStart && end == proposedEnd) {
+        return;
+    }
+
+    QRectF before = proposalRect();
+    proposedDay = day;
+    proposedStart = start;
+    proposedEnd = end;
+    update(before.adjusted(-2, -2, 2, 2).toAlignedRect());
+    update(proposalRect().adjusted(-2, -2, 2, 2).toAlignedRect());
+    emit dragProposed(dragEventId, day, start, end);
+}
+
+void WeekCanvas::mouseReleaseEvent(QMouseEvent* event) {
+    if (event->button() != Qt::LeftButton || dragMode == DragMode::None) {
+        QWidget::mouseReleaseEvent(event);
+        return;
+    }
+
+    DragMode mode = dragMode;
+    int eventId = dragEventId;
+    int day = proposedDay;
+    int start = proposedStart;
+    int end = proposedEnd;
+    endDrag();
+
+    bool moved = mode == DragMode::Moving && (day != originDay || start != originStart);
+    if (moved || mode == DragMode::Creating) {
+        emit eventDropped(eventId, day, start, end);
+    }
+}
+
+void WeekCanvas::keyPressEvent(QKeyEvent* event) {
+    if (event->key() == Qt::Key_Escape && dragMode != DragMode::None) {
+        endDrag();
+        return;
+    }
+    QWidget::keyPressEvent(event);
+}
+
+void WeekCanvas::endDrag() {
+    bool wasDragging = dragMode == DragMode::Moving || dragMode == DragMode::Creating;
+    dragMode = DragMode::None;
+    conflictIds.clear();
+    unsetCursor();
+    if (wasDragging) {
+        update();
+    }
+}
+
+void WeekCanvas::contextMenuEvent(QContextMenuEvent* event) {
+    int eventId = eventIdAt(event->pos());
+    if (eventId <= 0) return;
+
+    QMenu contextMenu(this);
+    QAction* deleteAction = contextMenu.addAction(QString::fromUtf8("删除事件"));
+
+    QAction* selectedAction = contextMenu.exec(event->globalPos());
+    if (selectedAction == deleteAction) {
+        emit deleteEventRequested(eventId);
+    }
+}
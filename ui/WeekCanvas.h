@@ -0,0 +1,106 @@
+#ifndef WEEKCANVAS_H
+#define WEEKCANVAS_H
+
+#include <QWidget>
+#include <QStaticText>
+#include <QStringList>
+#include <QRectF>
+#include <memory>
+#include <vector>
+#include "../modules/WeekLayout.h"
+
+// 自绘的一周视图：按分钟精度绘制事件，重叠事件并列显示
+// 事件块的几何位置和文字排版在布局或尺寸变化时计算一次并缓存，
+// 绘制时只处理与重绘区域相交的事件块
+// 左键拖动事件块可移动事件，在空白处拖动可框出新事件的时间；
+// 拖动中每次建议位置变化都发出 dragProposed，由外部查询冲突后通过 setConflictIds 回传并高亮
+class WeekCanvas : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit WeekCanvas(QWidget* parent = nullptr);
+
+    // 布局应已分好列（见 WeekLayoutBuilder::assignColumns）
+    void setWeekLayout(std::shared_ptr<const WeekLayout> layout);
+
+    // 列头文字（周几和日期），共 7 项
+    void setDayHeaders(const QStringList& headers);
+
+    // 与拖动中的建议位置冲突的事件编号（升序），拖动结束时自动清空
+    void setConflictIds(std::vector<int> ids);
+
+    QSize sizeHint() const override;
+
+signals:
+    void eventDoubleClicked(int eventId);
+    void deleteEventRequested(int eventId);
+
+    // 拖动开始，eventId 为 0 表示在空白处框选新事件
+    void dragStarted(int eventId);
+    // 建议位置变化：day 为 0..6（周一到周日），分钟距当天零点
+    void dragProposed(int eventId, int day, int startMinute, int endMinute);
+    // 在建议位置松开；移动时位置没有变化则不发出
+    void eventDropped(int eventId, int day, int startMinute, int endMinute);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void mouseDoubleClickEvent(QMouseEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+    void keyPressEvent(QKeyEvent* event) override;
+    void contextMenuEvent(QContextMenuEvent* event) override;
+
+private:
+    struct Block {
+        QRectF rect;
+        int eventId;
+        bool course;
+        int day;
+        int startMinute;
+        int endMinute;
+        QStaticText text;       // 预先排版，绘制时不再重新断行
+    };
+
+    enum class DragMode {
+        None,
+        Pending,        // 已按下，尚未超过拖动阈值
+        Moving,
+        Creating
+    };
+
+    static const int TIME_GUTTER = 48;
+    static const int HEADER_HEIGHT = 36;
+    static const int SNAP_MINUTES = 15;
+
+    std::shared_ptr<const WeekLayout> layout;
+    QStringList dayHeaders;
+    std::vector<Block> blocks;
+    bool geometryDirty;
+
+    // 拖动状态：origin 为按下时事件的位置，proposed 为当前建议位置
+    DragMode dragMode;
+    int dragEventId;
+    QPoint pressPos;
+    int originDay;
+    int originStart;
+    int originEnd;
+    int proposedDay;
+    int proposedStart;
+    int proposedEnd;
+    std::vector<int> conflictIds;
+
+    void rebuildGeometry();
+    double dayWidth() const;
+    double minuteHeight() const;
+    int eventIdAt(const QPoint& pos);
+    const Block* blockAt(const QPoint& pos);
+    int dayAt(int x) const;
+    int snappedMinuteAt(int y) const;
+    QRectF proposalRect() const;
+    void updateProposal(const QPoint& pos);
+    void endDrag();
+};
+
+#endif // WEEKCANVAS_H
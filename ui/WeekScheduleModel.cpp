@@ -0,0 +1,264 @@
+#include "WeekScheduleModel.h"
+#include <QColor>
+#include <QDate>
+#include <algorithm>
+#include <utility>
+
+WeekScheduleModel::WeekScheduleModel(QObject* parent)
+    : QAbstractTableModel(parent), weekOffset(0) {
+}
+
+int WeekScheduleModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : HOURS;
+}
+
+int WeekScheduleModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : DAYS + 1;
+}
+
+const WeekScheduleModel::Cell* WeekScheduleModel::cellAt(int row, int column) const {
+    if (row < 0 || row >= HOURS || column < 1 || column > DAYS) {
+        return nullptr;
+    }
+    return &layout[row * DAYS + (column - 1)];
+}
+
+QVariant WeekScheduleModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    // 第 0 列为时间
+    if (index.column() == 0) {
+        if (role == Qt::DisplayRole) {
+            return QString("%1:00").arg(index.row(), 2, 10, QChar('0'));
+        }
+        return QVariant();
+    }
+
+    const Cell* cell = cellAt(index.row(), index.column());
+    if (!cell || cell->eventId == 0) {
+        return QVariant();
+    }
+
+    switch (role) {
+        case Qt::DisplayRole:
+            return cell->text;
+        case Qt::BackgroundRole:
+            // 根据是否为课程设置不同颜色
+            return cell->course ? QColor(173, 216, 230)    // 浅蓝色
+                                : QColor(255, 255, 224);   // 浅黄色
+        case Qt::UserRole:
+            return cell->eventId;
+        default:
+            return QVariant();
+    }
+}
+
+QVariant WeekScheduleModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    if (section == 0) {
+        return QString::fromUtf8("时间");
+    }
+
+    static const char* weekNames[DAYS] = {"周一", "周二", "周三", "周四", "周五", "周六", "周日"};
+
+    // 当前周的周一，再按周偏移量调整
+    QDate today = QDate::currentDate();
+    QDate weekStart = today.addDays(1 - today.dayOfWeek());
+    QDate date = weekStart.addDays(weekOffset * 7 + section - 1);
+    return QString("%1\n(%2/%3)")
+        .arg(QString::fromUtf8(weekNames[section - 1]))
+        .arg(date.month())
+        .arg(date.day());
+}
+
+void WeekScheduleModel::setEvents(const std::vector<ScheduleEvent>& events) {
+    for (auto& bucket : eventsByDay) {
+        bucket.clear();
+    }
+    dayOfEvent.clear();
+    for (const auto& event : events) {
+        int weekday = event.getWeekday();
+        if (weekday < 1 || weekday > DAYS) continue;
+        dayOfEvent[event.getId()] = weekday - 1;
+        eventsByDay[weekday - 1].push_back(event);
+    }
+    relayout(ALL_DAYS);
+}
+
+void WeekScheduleModel::updateEvents(const std::vector<ScheduleEvent>& upserts,
+                                     const std::vector<int>& removedIds) {
+    unsigned int dirtyDays = 0;
+    for (int eventId : removedIds) {
+        removeFromBucket(eventId, dirtyDays);
+    }
+
+    for (const auto& event : upserts) {
+        int weekday = event.getWeekday();
+        auto found = dayOfEvent.find(event.getId());
+        if (found != dayOfEvent.end() && found->second == weekday - 1) {
+            // 星期不变时原地替换，保持先后顺序
+            for (auto& existing : eventsByDay[found->second]) {
+                if (existing.getId() == event.getId()) {
+                    existing = event;
+                    break;
+                }
+            }
+            dirtyDays |= 1u << found->second;
+            continue;
+        }
+
+        removeFromBucket(event.getId(), dirtyDays);
+        if (weekday < 1 || weekday > DAYS) continue;
+        dayOfEvent[event.getId()] = weekday - 1;
+        eventsByDay[weekday - 1].push_back(event);
+        dirtyDays |= 1u << (weekday - 1);
+    }
+
+    if (dirtyDays != 0) {
+        relayout(dirtyDays);
+    }
+}
+
+void WeekScheduleModel::setWeekOffset(int offset, const WeekLayout* prepared) {
+    if (offset == weekOffset) {
+        return;
+    }
+    weekOffset = offset;
+    emit headerDataChanged(Qt::Horizontal, 1, DAYS);
+
+    if (!prepared || prepared->weekOffset != offset) {
+        relayout(ALL_DAYS);
+        return;
+    }
+    Layout newLayout;
+    for (const auto& day : prepared->days) {
+        placeDay(day, newLayout);
+    }
+    applyLayout(std::move(newLayout), ALL_DAYS);
+}
+
+int WeekScheduleModel::getWeekOffset() const {
+    return weekOffset;
+}
+
+int WeekScheduleModel::eventIdAt(const QModelIndex& index) const {
+    const Cell* cell = index.isValid() ? cellAt(index.row(), index.column()) : nullptr;
+    return cell ? cell->eventId : 0;
+}
+
+int WeekScheduleModel::rowSpanAt(int row, int column) const {
+    const Cell* cell = cellAt(row, column);
+    return cell ? cell->rowSpan : 1;
+}
+
+bool WeekScheduleModel::removeFromBucket(int eventId, unsigned int& dirtyDays) {
+    auto found = dayOfEvent.find(eventId);
+    if (found == dayOfEvent.end()) {
+        return false;
+    }
+    auto& bucket = eventsByDay[found->second];
+    for (auto it = bucket.begin(); it != bucket.end(); ++it) {
+        if (it->getId() == eventId) {
+            bucket.erase(it);
+            break;
+        }
+    }
+    dirtyDays |= 1u << found->second;
+    dayOfEvent.erase(found);
+    return true;
+}
+
+void WeekScheduleModel::layoutDay(int day, const WeekLayoutBuilder& builder, Layout& target) const {
+    for (int row = 0; row < HOURS; ++row) {
+        target[row * DAYS + day] = Cell();
+    }
+
+    std::vector<LaidOutEvent> events;
+    LaidOutEvent placed;
+    for (const auto& event : eventsByDay[day]) {
+        if (builder.place(event, weekOffset, placed)) {
+            events.push_back(std::move(placed));
+        }
+    }
+    placeDay(std::move(events), target);
+}
+
+void WeekScheduleModel::placeDay(std::vector<LaidOutEvent> events, Layout& target) {
+    std::sort(events.begin(), events.end(), [](const LaidOutEvent& a, const LaidOutEvent& b) {
+        if (a.startMinute != b.startMinute) {
+            return a.startMinute < b.startMinute;
+        }
+        if (a.endMinute != b.endMinute) {
+            return a.endMinute > b.endMinute;
+        }
+        return a.eventId < b.eventId;
+    });
+    for (const auto& placed : events) {
+        placeInLayout(placed, target);
+    }
+}
+
+void WeekScheduleModel::placeInLayout(const LaidOutEvent& placed, Layout& target) {
+    int startHour = placed.startMinute / 60;
+    if (startHour < 0 || startHour >= HOURS) {
+        return;
+    }
+
+    // 持续时间（小时），至少显示 1 小时，不超出当天
+    int durationHours = (placed.endMinute - placed.startMinute) / 60;
+    if (durationHours < 1) {
+        durationHours = 1;
+    }
+    if (startHour + durationHours > HOURS) {
+        durationHours = HOURS - startHour;
+    }
+
+    // 只在开始时间的单元格放事件，后来的事件覆盖先前的
+    Cell& cell = target[startHour * DAYS + placed.day];
+    cell.eventId = placed.eventId;
+    cell.rowSpan = durationHours;
+    cell.course = placed.course;
+    cell.text = QString::fromUtf8(placed.title.c_str());
+}
+
+void WeekScheduleModel::relayout(unsigned int dayMask) {
+    Layout newLayout = layout;
+    WeekLayoutBuilder builder;
+    for (int day = 0; day < DAYS; ++day) {
+        if (dayMask & (1u << day)) {
+            layoutDay(day, builder, newLayout);
+        }
+    }
+    applyLayout(std::move(newLayout), dayMask);
+}
+
+void WeekScheduleModel::applyLayout(Layout newLayout, unsigned int dayMask) {
+    std::swap(layout, newLayout);
+
+    // 逐列找出变化的连续行区间，合并成尽量少的 dataChanged
+    for (int day = 0; day < DAYS; ++day) {
+        if (!(dayMask & (1u << day))) {
+            continue;
+        }
+        int column = day + 1;
+        int firstChanged = -1;
+        for (int row = 0; row <= HOURS; ++row) {
+            bool changed = row < HOURS && !(layout[row * DAYS + day] == newLayout[row * DAYS + day]);
+            if (changed) {
+                if (firstChanged < 0) {
+                    firstChanged = row;
+                }
+                if (layout[row * DAYS + day].rowSpan != newLayout[row * DAYS + day].rowSpan) {
+                    emit rowSpanChanged(row, column, layout[row * DAYS + day].rowSpan);
+                }
+            } else if (firstChanged >= 0) {
+                emit dataChanged(index(firstChanged, column), index(row - 1, column));
+                firstChanged = -1;
+            }
+        }
+    }
+}
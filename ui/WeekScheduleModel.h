@@ -0,0 +1,82 @@
+#ifndef WEEKSCHEDULEMODEL_H
+#define WEEKSCHEDULEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QString>
+#include <array>
+#include <unordered_map>
+#include <vector>
+#include "../datastructure/ScheduleEvent.h"
+#include "../modules/WeekLayout.h"
+
+// 课表的一周视图模型：24 行（小时）x 8 列（时间 + 周一到周日）
+// 不保存 QStandardItem，data() 直接从按周计算好的布局中取值；
+// 事件按星期分桶，增量更新时只重新布局涉及的星期列，
+// 并与旧布局逐格比较，只对变化的单元格发出 dataChanged
+class WeekScheduleModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    static const int HOURS = 24;
+    static const int DAYS = 7;
+
+    explicit WeekScheduleModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    // 整体替换全部事件
+    void setEvents(const std::vector<ScheduleEvent>& events);
+
+    // 增量更新：先删除 removedIds，再插入或按编号替换 upserts
+    void updateEvents(const std::vector<ScheduleEvent>& upserts, const std::vector<int>& removedIds);
+
+    // 切换显示周；prepared 为后台预先算好的同一周布局时直接使用，不再重新布局
+    void setWeekOffset(int offset, const WeekLayout* prepared = nullptr);
+    int getWeekOffset() const;
+
+    // 单元格中事件的编号，没有事件时返回 0
+    int eventIdAt(const QModelIndex& index) const;
+
+    // 某个单元格起始的事件占据的行数（没有事件时为 1）
+    int rowSpanAt(int row, int column) const;
+
+signals:
+    // 单元格的合并行数发生变化，视图据此调整 setSpan
+    void rowSpanChanged(int row, int column, int rowSpan);
+
+private:
+    struct Cell {
+        int eventId = 0;
+        int rowSpan = 1;
+        bool course = false;
+        QString text;
+
+        bool operator==(const Cell& other) const {
+            return eventId == other.eventId && rowSpan == other.rowSpan &&
+                   course == other.course && text == other.text;
+        }
+    };
+    using Layout = std::array<Cell, HOURS * DAYS>;
+
+    static const unsigned int ALL_DAYS = (1u << DAYS) - 1;
+
+    std::array<std::vector<ScheduleEvent>, DAYS> eventsByDay;   // 按星期分桶，保持加入顺序
+    std::unordered_map<int, int> dayOfEvent;                    // 事件编号 -> 所在桶
+    int weekOffset;
+    Layout layout;
+
+    bool removeFromBucket(int eventId, unsigned int& dirtyDays);
+    void layoutDay(int day, const WeekLayoutBuilder& builder, Layout& target) const;
+    static void placeInLayout(const LaidOutEvent& placed, Layout& target);
+    // 按开始时间、结束时间（长的在前）、编号的顺序写入一天的事件，
+    // 同一单元格中后写入的覆盖先写入的；重新布局和使用预先算好的布局都经过这里，结果一致
+    static void placeDay(std::vector<LaidOutEvent> events, Layout& target);
+    void relayout(unsigned int dayMask);
+    void applyLayout(Layout newLayout, unsigned int dayMask);
+    const Cell* cellAt(int row, int column) const;
+};
+
+#endif // WEEKSCHEDULEMODEL_H